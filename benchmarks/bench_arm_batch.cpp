@@ -0,0 +1,90 @@
+// Headless benchmark: batched forward kinematics of many arms (SoA + SIMD),
+// checked against the glm reference path, on one core and on all cores.
+//
+// Build (from the repo root):
+//   g++ -O3 -march=native -pthread -I. -I<path to glm> benchmarks/bench_arm_batch.cpp common/arm_batch.cpp common/kinematics.cpp -o bench_arm_batch
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include <common/kinematics.hpp>
+#include <common/arm_batch.hpp>
+#include "benchutil.hpp"
+
+const int NumArms = 1 << 20;
+const int NumRuns = 20;
+
+float randomAngle(float range) {
+	return (rand() / (float)RAND_MAX * 2.0f - 1.0f) * range;
+}
+
+// Runs computeArmBatch over all arms split into one contiguous range per thread
+double runBatch(ArmBatch & batch, int numThreads) {
+	double start = now();
+	for (int run = 0; run < NumRuns; run++) {
+		std::vector<std::thread> threads;
+		int chunk = (batch.count / numThreads + ArmBatchLanes - 1) / ArmBatchLanes * ArmBatchLanes;
+		for (int t = 0; t < numThreads; t++) {
+			int begin = t * chunk;
+			int end = glm::min(batch.count, begin + chunk);
+			if (begin >= end)
+				break;
+			threads.push_back(std::thread(computeArmBatch, std::ref(batch), begin, end));
+		}
+		for (size_t t = 0; t < threads.size(); t++)
+			threads[t].join();
+	}
+	return now() - start;
+}
+
+int main(void) {
+	ArmBatch batch;
+	batch.resize(NumArms);
+	for (int i = 0; i < NumArms; i++) {
+		ArmJoints j;
+		j.baseTranslate = glm::vec3(randomAngle(50.0f), 0.0f, randomAngle(50.0f));
+		// J angles are scaled by degrees() before rotating, so +-0.06 already covers a full turn
+		j.topRotate = randomAngle(0.06f);
+		j.arm1Rotate = randomAngle(0.03f);
+		j.arm2Rotate = randomAngle(0.03f);
+		j.penRotateLongitude = randomAngle(0.06f);
+		j.penRotateLatitude = randomAngle(0.06f);
+		j.penRotateAxis = randomAngle(0.06f);
+		batch.setArm(i, j);
+	}
+
+	// Reference results for a sample of arms
+	const int NumChecked = 4096;
+	ArmBatch reference = batch;
+	computeArmBatchReference(reference, 0, NumChecked);
+
+	double refStart = now();
+	computeArmBatchReference(reference, 0, NumArms);
+	double refTime = now() - refStart;
+
+	double single = runBatch(batch, 1);
+	int cores = (int)std::thread::hardware_concurrency();
+	if (cores < 1)
+		cores = 1;
+	double multi = runBatch(batch, cores);
+
+	float maxError = 0.0f;
+	for (int i = 0; i < NumChecked; i++) {
+		for (int link = 0; link < NUM_ARM_LINKS; link++)
+			for (int e = 0; e < 12; e++)
+				maxError = glm::max(maxError, glm::abs(batch.links[link][e][i] - reference.links[link][e][i]));
+		maxError = glm::max(maxError, glm::length(batch.getPenTip(i) - reference.getPenTip(i)));
+	}
+
+	printf("kernel: %s, %d arms, %d links + pen tip each\n", armBatchKernelName(), NumArms, NUM_ARM_LINKS);
+	printf("reference (glm)  : %10.2f M arms/s\n", NumArms / refTime * 1e-6);
+	printf("batched, 1 core  : %10.2f M arms/s\n", double(NumArms) * NumRuns / single * 1e-6);
+	printf("batched, %d cores: %10.2f M arms/s\n", cores, double(NumArms) * NumRuns / multi * 1e-6);
+	printf("max |batched - reference| = %g\n", maxError);
+
+	return maxError < 1e-3f ? 0 : 1;
+}
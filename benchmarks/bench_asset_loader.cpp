@@ -0,0 +1,99 @@
+// Benchmark: time to load a cell of many arm-sized meshes through AssetLoader with 1, 2, 4, ...
+// worker threads, cold (every .obj parsed and indexed) and warm (mesh caches mapped).
+// The meshes are generated grids written to the current folder and removed afterwards.
+//
+// Build (from the repo root):
+//   g++ -O2 -pthread -I. -I<path to glm> benchmarks/bench_asset_loader.cpp common/assetloader.cpp common/threadpool.cpp
+//       common/meshcache.cpp common/objparser.cpp common/mappedfile.cpp common/vboindexer.cpp common/bvh.cpp
+//       common/meshsimplify.cpp -o bench_asset_loader
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <string>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include <common/meshcache.hpp>
+#include <common/assetloader.hpp>
+#include "benchutil.hpp"
+
+const int NumMeshes = 32;
+const int GridSize = 160;	// 2 * 159 * 159 = 50562 triangles per mesh
+
+bool writeGridOBJ(const char* path, int seed) {
+	FILE* file = fopen(path, "w");
+	if (file == NULL)
+		return false;
+	for (int z = 0; z < GridSize; z++)
+		for (int x = 0; x < GridSize; x++)
+			fprintf(file, "v %f %f %f\n", x * 0.01f, 0.05f * (float)((x * 7 + z * 13 + seed) % 17) / 17.0f, z * 0.01f);
+	for (int z = 0; z + 1 < GridSize; z++) {
+		for (int x = 0; x + 1 < GridSize; x++) {
+			int a = z * GridSize + x + 1, b = a + 1, c = a + GridSize, d = c + 1;
+			fprintf(file, "f %d %d %d\n", a, c, b);
+			fprintf(file, "f %d %d %d\n", b, c, d);
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+// Loads every mesh and returns the wall time, or a negative value on failure
+double loadCell(const std::vector<std::string>& paths, int numThreads) {
+	double start = now();
+	AssetLoader loader;
+	loader.start(numThreads);
+	for (size_t i = 0; i < paths.size(); i++)
+		loader.request(paths[i].c_str(), (int)i);
+	LoadedMesh mesh;
+	int loaded = 0;
+	while (loader.waitNext(mesh)) {
+		if (!mesh.ok)
+			return -1.0;
+		loaded++;
+	}
+	loader.stop();
+	return loaded == (int)paths.size() ? now() - start : -1.0;
+}
+
+int main(void) {
+	std::vector<std::string> paths;
+	for (int i = 0; i < NumMeshes; i++) {
+		char path[64];
+		snprintf(path, sizeof(path), "bench_cell_%02d.obj", i);
+		if (!writeGridOBJ(path, i)) {
+			fprintf(stderr, "Could not write %s\n", path);
+			return 1;
+		}
+		paths.push_back(path);
+	}
+
+	int cores = (int)std::thread::hardware_concurrency();
+	printf("%d meshes x %d triangles, %d hardware threads\n", NumMeshes, 2 * (GridSize - 1) * (GridSize - 1), cores);
+	printf("%8s %12s %12s %10s\n", "threads", "cold (ms)", "warm (ms)", "speedup");
+	double coldSerial = 0.0;
+	bool ok = true;
+	for (int threads = 1; ok; threads *= 2) {
+		if (threads > cores)
+			threads = cores;
+		for (size_t i = 0; i < paths.size(); i++)
+			remove(meshCachePath(paths[i].c_str()).c_str());
+		double cold = loadCell(paths, threads);
+		double warm = loadCell(paths, threads);
+		ok = cold > 0.0 && warm > 0.0;
+		if (threads == 1)
+			coldSerial = cold;
+		if (ok)
+			printf("%8d %12.1f %12.1f %9.1fx\n", threads, 1000.0 * cold, 1000.0 * warm, coldSerial / cold);
+		if (threads >= cores)
+			break;
+	}
+
+	for (size_t i = 0; i < paths.size(); i++) {
+		remove(meshCachePath(paths[i].c_str()).c_str());
+		remove(paths[i].c_str());
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// Headless benchmark: arm self and ground collision checks (AABB broad phase, GJK, EPA for
+// the contact version) on random arm states, one at a time and batched across 1, 2, 4, ...
+// threads with ArmCollider::checkPath(). Run it from a folder that has the models folder.
+//
+// Build (from the repo root):
+//   g++ -O2 -pthread -I. -I<path to glm> benchmarks/bench_collision.cpp common/collision.cpp common/kinematics.cpp
+//       common/threadpool.cpp common/objparser.cpp common/mappedfile.cpp -o bench_collision
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include <common/kinematics.hpp>
+#include <common/objparser.hpp>
+#include <common/threadpool.hpp>
+#include <common/collision.hpp>
+#include "benchutil.hpp"
+
+const int NumSamples = 200000;
+const char* linkNames[NUM_ARM_LINKS] = { "base", "top", "arm1", "joint", "arm2", "pen", "button" };
+const char* partFiles[NUM_ARM_LINKS] = { "models/base.obj", "models/top.obj", "models/arm1.obj", "models/joint.obj",
+	"models/arm2.obj", "models/pen.obj", "models/button.obj" };
+
+float randomRange(float lo, float hi) {
+	return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// Joint angles in the chain's units: degrees(angle) radians, see jointRotation()
+ArmJoints randomArm() {
+	ArmJoints j;
+	j.baseTranslate = glm::vec3(0.0f);
+	j.topRotate = glm::radians(randomRange(-3.1f, 3.1f));
+	j.arm1Rotate = glm::radians(randomRange(-2.0f, 2.0f));
+	j.arm2Rotate = glm::radians(randomRange(-2.6f, 2.6f));
+	j.penRotateLongitude = glm::radians(randomRange(-3.1f, 3.1f));
+	j.penRotateLatitude = glm::radians(randomRange(-1.5f, 1.5f));
+	j.penRotateAxis = glm::radians(randomRange(-3.1f, 3.1f));
+	return j;
+}
+
+int main(void) {
+	ArmCollider collider;
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		std::vector<glm::vec3> vertices, normals;
+		std::vector<glm::vec2> uvs;
+		if (!parseOBJ(partFiles[link], vertices, uvs, normals)) {
+			fprintf(stderr, "Could not load %s\n", partFiles[link]);
+			return 1;
+		}
+		collider.setLinkShape(link, vertices);
+	}
+	printf("checked pairs:");
+	for (int i = 0; i < NUM_ARM_LINKS; i++)
+		for (int j = i + 1; j < NUM_ARM_LINKS; j++)
+			if (collider.isPairChecked(i, j))
+				printf(" %s-%s", linkNames[i], linkNames[j]);
+	printf("\n");
+
+	srand(11);
+	std::vector<ArmJoints> samples(NumSamples);
+	for (int i = 0; i < NumSamples; i++)
+		samples[i] = randomArm();
+
+	// One state at a time: yes/no, then every contact with its depth
+	double start = now();
+	int colliding = 0;
+	for (int i = 0; i < NumSamples; i++)
+		colliding += collider.checkConfiguration(samples[i]);
+	const double boolTime = now() - start;
+
+	CollisionContact contacts[16];
+	int totalContacts = 0, groundContacts = 0;
+	float maxDepth = 0.0f;
+	start = now();
+	for (int i = 0; i < NumSamples; i++) {
+		const int found = collider.checkConfiguration(samples[i], contacts, 16);
+		totalContacts += found;
+		for (int c = 0; c < found; c++) {
+			groundContacts += contacts[c].linkB == CollisionGround;
+			maxDepth = std::max(maxDepth, contacts[c].depth);
+		}
+	}
+	const double contactTime = now() - start;
+	printf("%d random states, %.1f%% colliding\n", NumSamples, 100.0 * colliding / NumSamples);
+	printf("checkConfiguration (first hit)  %10.0f checks/s\n", NumSamples / boolTime);
+	printf("checkConfiguration (contacts)   %10.0f checks/s, %d contacts (%d ground), max depth %.3f\n",
+		NumSamples / contactTime, totalContacts, groundContacts, maxDepth);
+
+	// Batched, as for validating every sample of a planned trajectory
+	std::vector<unsigned char> collides(NumSamples);
+	int cores = (int)std::thread::hardware_concurrency();
+	printf("%8s %12s %12s %9s\n", "threads", "time (ms)", "checks/s", "speedup");
+	double single = 0.0;
+	for (int threads = 1; ; threads *= 2) {
+		if (threads > cores)
+			threads = cores;
+		ThreadPool pool;
+		pool.start(threads);
+		double best = 1e30;
+		size_t found = 0;
+		for (int run = 0; run < 3; run++) {
+			start = now();
+			found = collider.checkPath(samples.data(), samples.size(), collides.data(), &pool);
+			best = std::min(best, now() - start);
+		}
+		pool.stop();
+		if (threads == 1)
+			single = best;
+		if ((int)found != colliding) {
+			fprintf(stderr, "checkPath found %d colliding states, expected %d\n", (int)found, colliding);
+			return 1;
+		}
+		printf("%8d %12.1f %12.0f %8.1fx\n", threads, 1000.0 * best, NumSamples / best, single / best);
+		if (threads >= cores)
+			break;
+	}
+	return 0;
+}
@@ -0,0 +1,87 @@
+// Headless benchmark: view frustum culling of the part instances of a 10k arm cell, seen from
+// close to the first arm, from a corner of the cell and from high above it. Prints how many
+// instances are in view, and instances tested per second by cullArmBatchLink() (straight from
+// the batch's SoA link matrices, AVX2/SSE4.1/scalar) and by boundsInFrustum() one matrix at a
+// time, with the number of instances the two disagree on. Run it from a folder that has the
+// models folder.
+//
+// Build (from the repo root), -march=native for the AVX2 path:
+//   g++ -O2 -march=native -I. -I<path to glm> benchmarks/bench_frustum_culling.cpp common/frustum.cpp
+//       common/arm_batch.cpp common/kinematics.cpp common/objparser.cpp common/mappedfile.cpp -o bench_frustum_culling
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <common/kinematics.hpp>
+#include <common/arm_batch.hpp>
+#include <common/objparser.hpp>
+#include <common/frustum.hpp>
+#include "benchutil.hpp"
+
+const int NumArms = 10000;
+const int Repeats = 20;
+const char* partFiles[NUM_ARM_LINKS] = { "models/base.obj", "models/top.obj", "models/arm1.obj", "models/joint.obj",
+	"models/arm2.obj", "models/pen.obj", "models/button.obj" };
+
+int main(void) {
+	MeshBounds bounds[NUM_ARM_LINKS];
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		std::vector<glm::vec3> vertices, normals;
+		std::vector<glm::vec2> uvs;
+		if (!parseOBJ(partFiles[link], vertices, uvs, normals)) {
+			fprintf(stderr, "Could not load %s\n", partFiles[link]);
+			return 1;
+		}
+		bounds[link] = computeMeshBounds(vertices);
+	}
+
+	ArmBatch batch;
+	buildArmCell(batch, NumArms, 0.0f);
+	const int side = (int)ceil(sqrt((float)NumArms));
+	const float extent = (side - 1) * CellSpacing;
+	const char* viewNames[3] = { "first arm", "cell corner", "overhead" };
+	const glm::vec3 eyes[3] = { glm::vec3(10.0f, 10.0f, 10.0f), glm::vec3(-5.0f, 8.0f, 5.0f),
+		glm::vec3(0.5f * extent, 90.0f, -0.5f * extent + 1.0f) };
+	const glm::vec3 targets[3] = { glm::vec3(0.0f), glm::vec3(0.5f * extent, 0.0f, -0.5f * extent),
+		glm::vec3(0.5f * extent, 0.0f, -0.5f * extent) };
+	// Same projection as the demo
+	const glm::mat4 projection = glm::perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+	const int instances = NumArms * NUM_ARM_LINKS;
+
+	std::vector<unsigned char> visible(NUM_ARM_LINKS * NumArms + ArmBatchLanes), reference(NUM_ARM_LINKS * NumArms);
+	printf("%d arms, %d part instances\n", NumArms, instances);
+	printf("%12s %10s %16s %16s %10s\n", "view", "in view", "batch (M/s)", "one by one (M/s)", "disagree");
+	for (int view = 0; view < 3; view++) {
+		const Frustum frustum = extractFrustum(projection * glm::lookAt(eyes[view], targets[view], glm::vec3(0.0f, 1.0f, 0.0f)));
+
+		// Best of Repeats each
+		double batchTime = 1e30, singleTime = 1e30;
+		int inView = 0, disagree = 0;
+		for (int run = 0; run < Repeats; run++) {
+			double start = now();
+			int count = 0;
+			for (int link = 0; link < NUM_ARM_LINKS; link++)
+				count += cullArmBatchLink(frustum, bounds[link], batch, link, 0, NumArms, &visible[link * NumArms]);
+			batchTime = std::min(batchTime, now() - start);
+			inView = count;
+
+			start = now();
+			for (int link = 0; link < NUM_ARM_LINKS; link++)
+				for (int arm = 0; arm < NumArms; arm++)
+					reference[link * NumArms + arm] = boundsInFrustum(frustum, bounds[link], batch.getLinkMatrix(arm, link)) ? 1 : 0;
+			singleTime = std::min(singleTime, now() - start);
+		}
+
+		// The batch path can round differently (FMA), so instances right on a plane may disagree
+		for (int i = 0; i < instances; i++)
+			disagree += visible[i] != reference[i];
+		printf("%12s %10d %16.1f %16.1f %10d\n", viewNames[view], inView, instances / batchTime / 1e6,
+			instances / singleTime / 1e6, disagree);
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+// Headless benchmark: pen tip IK (analytic J1-J3, damped least squares J4-J6) on random
+// reachable poses, solved cold from the rest pose and warm from a nearby solution, in solves
+// per second with iteration counts and the remaining position and orientation errors.
+// Also checks penPose() against the KinematicChain the demo draws with.
+//
+// Build (from the repo root):
+//   g++ -O2 -pthread -I. -I<path to glm> benchmarks/bench_ik.cpp common/arm_ik.cpp common/kinematics.cpp
+//       common/quaternion_utils.cpp common/threadpool.cpp -o bench_ik
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <common/kinematics.hpp>
+#include <common/arm_ik.hpp>
+#include "benchutil.hpp"
+
+const int NumTargets = 100000;
+
+float randomRange(float lo, float hi) {
+	return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// Joint angles in the chain's units: degrees(angle) radians, see jointRotation()
+ArmJoints randomArm() {
+	ArmJoints j;
+	j.baseTranslate = glm::vec3(0.0f);
+	j.topRotate = glm::radians(randomRange(-3.1f, 3.1f));
+	j.arm1Rotate = glm::radians(randomRange(-1.4f, 1.4f));
+	j.arm2Rotate = glm::radians(randomRange(-2.4f, 2.4f));
+	j.penRotateLongitude = glm::radians(randomRange(-3.1f, 3.1f));
+	j.penRotateLatitude = glm::radians(randomRange(-1.4f, 1.4f));
+	j.penRotateAxis = glm::radians(randomRange(-3.1f, 3.1f));
+	return j;
+}
+
+ArmJoints nudged(ArmJoints j, float amount) {
+	j.topRotate += glm::radians(randomRange(-amount, amount));
+	j.arm1Rotate += glm::radians(randomRange(-amount, amount));
+	j.arm2Rotate += glm::radians(randomRange(-amount, amount));
+	j.penRotateLongitude += glm::radians(randomRange(-amount, amount));
+	j.penRotateLatitude += glm::radians(randomRange(-amount, amount));
+	j.penRotateAxis += glm::radians(randomRange(-amount, amount));
+	return j;
+}
+
+void run(const char * label, const std::vector<PenPose> & targets, const std::vector<ArmJoints> & seeds) {
+	std::vector<IKResult> results(targets.size());
+	const IKSettings settings;
+	double start = now();
+	for (size_t i = 0; i < targets.size(); i++) {
+		ArmJoints joints = seeds[i];
+		results[i] = solvePenIK(targets[i], joints, settings);
+	}
+	double elapsed = now() - start;
+
+	int converged = 0;
+	float maxPosition = 0.0f, maxOrientation = 0.0f;
+	std::vector<int> iterations(results.size());
+	for (size_t i = 0; i < results.size(); i++) {
+		converged += results[i].converged;
+		iterations[i] = results[i].iterations;
+		maxPosition = std::max(maxPosition, results[i].positionError);
+		maxOrientation = std::max(maxOrientation, results[i].orientationError);
+	}
+	std::sort(iterations.begin(), iterations.end());
+	double meanIterations = 0.0;
+	for (size_t i = 0; i < iterations.size(); i++)
+		meanIterations += iterations[i];
+	meanIterations /= iterations.size();
+	printf("%-6s %12.0f %10.2f%% %8.2f %5d %5d %12.2e %12.2e\n", label, targets.size() / elapsed,
+		100.0 * converged / targets.size(), meanIterations, iterations[iterations.size() * 95 / 100],
+		iterations.back(), maxPosition, maxOrientation);
+}
+
+int main(void) {
+	srand(7);
+	std::vector<ArmJoints> solutions(NumTargets);
+	std::vector<PenPose> targets(NumTargets);
+	for (int i = 0; i < NumTargets; i++) {
+		solutions[i] = randomArm();
+		targets[i] = penPose(solutions[i]);
+	}
+
+	// penPose() has to agree with the chain the demo draws
+	KinematicChain chain;
+	buildRobotArmChain(chain);
+	float maxDeviation = 0.0f;
+	for (int i = 0; i < 1000; i++) {
+		setRobotArmJoints(chain, solutions[i]);
+		chain.update();
+		glm::vec3 tip = glm::vec3(chain.getWorldMatrix(LINK_PEN) * glm::vec4(PenTipOffset, 1.0f));
+		maxDeviation = std::max(maxDeviation, glm::length(tip - targets[i].position));
+	}
+	printf("penPose vs. KinematicChain: max tip deviation %.2e\n", maxDeviation);
+
+	printf("%-6s %12s %11s %8s %5s %5s %12s %12s\n", "seed", "solves/s", "converged", "iters", "p95", "max",
+		"max pos err", "max rot err");
+	// Cold: every solve starts from the rest pose
+	std::vector<ArmJoints> seeds(NumTargets, ArmJoints());
+	run("cold", targets, seeds);
+	for (int i = 0; i < NumTargets; i++)
+		seeds[i] = nudged(solutions[i], 0.1f);
+	run("warm", targets, seeds);
+	return 0;
+}
@@ -0,0 +1,84 @@
+// Headless benchmark: solvePenIKPath() on a 100k waypoint drawing (a Lissajous figure traced
+// with a slowly tilting pen) with 1, 2, 4, ... worker threads. Prints waypoints per second,
+// the speedup over one thread, the largest joint step between neighbouring waypoints and how
+// far the result strays from the serial solution.
+//
+// Build (from the repo root):
+//   g++ -O2 -pthread -I. -I<path to glm> benchmarks/bench_ik_path.cpp common/arm_ik.cpp common/kinematics.cpp
+//       common/quaternion_utils.cpp common/threadpool.cpp -o bench_ik_path
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <common/kinematics.hpp>
+#include <common/threadpool.hpp>
+#include <common/arm_ik.hpp>
+#include "benchutil.hpp"
+
+const int NumWaypoints = 100000;
+
+// Largest change of any joint, radians (the chain's units are radians(angle), see jointRotation)
+float jointDistance(const ArmJoints & a, const ArmJoints & b) {
+	float d = fabsf(a.topRotate - b.topRotate);
+	d = std::max(d, fabsf(a.arm1Rotate - b.arm1Rotate));
+	d = std::max(d, fabsf(a.arm2Rotate - b.arm2Rotate));
+	d = std::max(d, fabsf(a.penRotateLongitude - b.penRotateLongitude));
+	d = std::max(d, fabsf(a.penRotateLatitude - b.penRotateLatitude));
+	d = std::max(d, fabsf(a.penRotateAxis - b.penRotateAxis));
+	return glm::degrees(d);
+}
+
+int main(void) {
+	std::vector<PenPose> path(NumWaypoints);
+	for (int i = 0; i < NumWaypoints; i++) {
+		const float t = 6.2831853f * i / NumWaypoints;
+		path[i].position = glm::vec3(1.3f + 0.4f * sinf(3.0f * t), 0.6f, 0.6f * sinf(2.0f * t));
+		const glm::vec3 direction(0.3f * sinf(5.0f * t), -1.0f, 0.3f * cosf(7.0f * t));
+		path[i].orientation = penOrientation(direction, glm::vec3(-1.0f, 0.0f, 0.0f));
+	}
+	const ArmJoints seed = ArmJoints();   // rest pose
+
+	std::vector<ArmJoints> serial(NumWaypoints), joints(NumWaypoints);
+	solvePenIKPath(path.data(), path.size(), seed, serial.data());
+
+	int cores = (int)std::thread::hardware_concurrency();
+	printf("%d waypoints, %d hardware threads\n", NumWaypoints, cores);
+	printf("%8s %12s %12s %9s %10s %10s %12s\n", "threads", "time (ms)", "waypoints/s", "speedup", "converged",
+		"max step", "vs. serial");
+	double single = 0.0;
+	for (int threads = 1; ; threads *= 2) {
+		if (threads > cores)
+			threads = cores;
+		ThreadPool pool;
+		pool.start(threads);
+		// Best of three, the pool is already up
+		double best = 1e30;
+		size_t converged = 0;
+		for (int run = 0; run < 3; run++) {
+			double start = now();
+			converged = solvePenIKPath(path.data(), path.size(), seed, joints.data(), &pool);
+			best = std::min(best, now() - start);
+		}
+		pool.stop();
+		if (threads == 1)
+			single = best;
+
+		float maxStep = 0.0f, maxDeviation = 0.0f;
+		for (int i = 0; i < NumWaypoints; i++) {
+			if (i > 0)
+				maxStep = std::max(maxStep, jointDistance(joints[i], joints[i - 1]));
+			maxDeviation = std::max(maxDeviation, jointDistance(joints[i], serial[i]));
+		}
+		printf("%8d %12.1f %12.0f %8.1fx %9.2f%% %10.2e %12.2e\n", threads, 1000.0 * best, NumWaypoints / best,
+			single / best, 100.0 * converged / NumWaypoints, maxStep, maxDeviation);
+		if (threads >= cores)
+			break;
+	}
+	return 0;
+}
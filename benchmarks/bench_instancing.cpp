@@ -0,0 +1,221 @@
+// Headless benchmark: frame time of a work cell of 1 to 10k robot arms, drawn one part of
+// one arm at a time (7 draws per arm, per-draw constant attributes) vs. one instanced draw
+// per part with the link matrices of every arm streamed into an instance buffer.
+// The arms' links come from computeArmBatch() once, outside the timings. Rasterization is
+// discarded so the numbers are draw submission plus vertex work.
+// Run it from a folder that has the models folder and the StandardShading shaders.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_instancing.cpp common/arm_batch.cpp common/kinematics.cpp
+//       common/mesharena.cpp common/objparser.cpp common/mappedfile.cpp common/vboindexer.cpp
+//       common/vertexpacking.cpp common/headless.cpp common/shader.cpp -lGLEW -lglfw -lEGL -lGL -o bench_instancing
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <common/shader.hpp>
+#include <common/headless.hpp>
+#include <common/objparser.hpp>
+#include <common/vboindexer.hpp>
+#include <common/vertexpacking.hpp>
+#include <common/kinematics.hpp>
+#include <common/arm_batch.hpp>
+#include <common/mesharena.hpp>
+#include "benchutil.hpp"
+
+const int ArmCounts[] = { 1, 10, 100, 1000, 10000 };
+const char* partFiles[NUM_ARM_LINKS] = { "models/base.obj", "models/top.obj", "models/arm1.obj", "models/joint.obj",
+	"models/arm2.obj", "models/pen.obj", "models/button.obj" };
+const glm::vec4 linkColor[NUM_ARM_LINKS] = { glm::vec4(1.0, 0.0, 0.0, 1.0), glm::vec4(0.0, 1.0, 0.0, 1.0),
+	glm::vec4(0.0, 0.0, 1.0, 1.0), glm::vec4(1.0, 0.0, 1.0, 1.0), glm::vec4(0.0, 1.0, 1.0, 1.0),
+	glm::vec4(1.0, 1.0, 0.0, 1.0), glm::vec4(1.0, 0.0, 0.0, 1.0) };
+
+// Same layout as the demo's Vertex
+struct CompactVertex {
+	float Position[3];
+	GLuint Normal;
+	GLubyte Color[4];
+};
+
+struct DrawData {
+	glm::mat4 Model;
+	glm::vec4 Color;
+};
+
+// std140 layout of the shaders' FrameData block
+struct FrameData {
+	glm::mat4 V;
+	glm::mat4 P;
+};
+
+void setVertexAttributes(void) {
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CompactVertex), 0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactVertex), (GLvoid*)16);
+	glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(CompactVertex), (GLvoid*)12);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+}
+
+void setInstanceAttributes(size_t firstInstance) {
+	for (int i = 0; i < 5; i++)
+		glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(DrawData),
+			(GLvoid*)(firstInstance * sizeof(DrawData) + i * sizeof(glm::vec4)));
+}
+
+int main(void) {
+	if (initHeadlessContext(64, 64) != 0)
+		return 1;
+	OffscreenTarget target;
+	if (!createOffscreenTarget(target, 64, 64))
+		return 1;
+
+	GLuint programID = LoadShaders("StandardShading.vertexshader", "StandardShading.fragmentshader");
+	if (programID == 0)
+		return 1;
+
+	// Every part in one arena, as in the demo
+	MeshArena arena;
+	arena.init(sizeof(CompactVertex), 1024, 4096);
+	ArenaRange parts[NUM_ARM_LINKS];
+	int trianglesPerArm = 0;
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		std::vector<glm::vec3> vertices, normals, indexed_vertices, indexed_normals;
+		std::vector<glm::vec2> uvs;
+		std::vector<unsigned int> indices;
+		if (!parseOBJ(partFiles[link], vertices, uvs, normals))
+			return 1;
+		indexVBO(vertices, normals, indices, indexed_vertices, indexed_normals);
+		std::vector<CompactVertex> packed(indexed_vertices.size());
+		float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (size_t i = 0; i < packed.size(); i++) {
+			for (int k = 0; k < 3; k++)
+				packed[i].Position[k] = indexed_vertices[i][k];
+			packed[i].Normal = packNormal2_10_10_10(indexed_normals[i]);
+			packColorRGBA8(white, packed[i].Color);
+		}
+		bool reallocated;
+		parts[link] = arena.add(&packed[0], (GLsizei)packed.size(), &indices[0], (GLsizei)indices.size(), reallocated);
+		trianglesPerArm += (int)indices.size() / 3;
+	}
+
+	// Per-draw VAO: attributes 3-7 are left disabled and set as constants before each draw
+	GLuint perDrawVAO, instancedVAO, instanceBuffer;
+	glGenVertexArrays(1, &perDrawVAO);
+	glBindVertexArray(perDrawVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, arena.getVertexBuffer());
+	setVertexAttributes();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.getIndexBuffer());
+
+	// Instanced VAO: attributes 3-7 advance once per instance through the instance buffer
+	glGenBuffers(1, &instanceBuffer);
+	glGenVertexArrays(1, &instancedVAO);
+	glBindVertexArray(instancedVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, arena.getVertexBuffer());
+	setVertexAttributes();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.getIndexBuffer());
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	setInstanceAttributes(0);
+	for (int i = 0; i < 5; i++) {
+		glVertexAttribDivisor(3 + i, 1);
+		glEnableVertexAttribArray(3 + i);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glm::mat4 Projection = glm::perspective(45.0f, 1.0f, 0.1f, 100.0f);
+	glm::mat4 View = glm::lookAt(glm::vec3(10.0f, 10.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glUseProgram(programID);
+	// V and P are the shaders' FrameData uniform block. The light blocks stay unbound:
+	// rasterization is discarded, so no fragment shader runs.
+	FrameData frame = { View, Projection };
+	GLuint frameBuffer;
+	glGenBuffers(1, &frameBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(frame), &frame, GL_STATIC_DRAW);
+	glUniformBlockBinding(programID, glGetUniformBlockIndex(programID, "FrameData"), 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, 0, frameBuffer);
+	glEnable(GL_RASTERIZER_DISCARD);
+
+	printf("%s\n", (const char*)glGetString(GL_RENDERER));
+	printf("%d triangles per arm\n", trianglesPerArm);
+	printf("%6s %10s %14s %10s %14s %8s\n", "arms", "draws", "per part ms", "draws", "instanced ms", "speedup");
+	std::vector<DrawData> instances;
+	for (size_t c = 0; c < sizeof(ArmCounts) / sizeof(ArmCounts[0]); c++) {
+		const int numArms = ArmCounts[c];
+		const int numFrames = numArms >= 1000 ? 3 : 20;
+		ArmBatch batch;
+		buildArmCell(batch, numArms, 0.0f);
+
+		// One part of one arm per draw
+		double start = 0.0;
+		glBindVertexArray(perDrawVAO);
+		for (int frame = -1; frame < numFrames; frame++) {
+			if (frame == 0) {
+				glFinish();	// frame -1 warms up
+				start = now();
+			}
+			for (int arm = 0; arm < numArms; arm++) {
+				for (int link = 0; link < NUM_ARM_LINKS; link++) {
+					glm::mat4 Model = batch.getLinkMatrix(arm, link);
+					for (int i = 0; i < 4; i++)
+						glVertexAttrib4fv(3 + i, &Model[i][0]);
+					glVertexAttrib4fv(7, &linkColor[link][0]);
+					glDrawElementsBaseVertex(GL_TRIANGLES, parts[link].indexCount, GL_UNSIGNED_INT,
+						(void*)(parts[link].firstIndex * sizeof(GLuint)), parts[link].baseVertex);
+				}
+			}
+		}
+		glFinish();
+		const double perDrawTime = (now() - start) / numFrames;
+
+		// Every arm's instances of a part, then one instanced draw per part
+		instances.resize((size_t)numArms * NUM_ARM_LINKS);
+		glBindVertexArray(instancedVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		for (int frame = -1; frame < numFrames; frame++) {
+			if (frame == 0) {
+				glFinish();
+				start = now();
+			}
+			for (int link = 0; link < NUM_ARM_LINKS; link++) {
+				for (int arm = 0; arm < numArms; arm++) {
+					DrawData& d = instances[(size_t)link * numArms + arm];
+					d.Model = batch.getLinkMatrix(arm, link);
+					d.Color = linkColor[link];
+				}
+			}
+			glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(DrawData), &instances[0], GL_STREAM_DRAW);
+			for (int link = 0; link < NUM_ARM_LINKS; link++) {
+				setInstanceAttributes((size_t)link * numArms);
+				glDrawElementsInstancedBaseVertex(GL_TRIANGLES, parts[link].indexCount, GL_UNSIGNED_INT,
+					(void*)(parts[link].firstIndex * sizeof(GLuint)), numArms, parts[link].baseVertex);
+			}
+		}
+		glFinish();
+		const double instancedTime = (now() - start) / numFrames;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		printf("%6d %10d %14.3f %10d %14.3f %7.2fx\n", numArms, numArms * NUM_ARM_LINKS, 1000.0 * perDrawTime,
+			NUM_ARM_LINKS, 1000.0 * instancedTime, perDrawTime / instancedTime);
+	}
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(0);
+
+	glDeleteVertexArrays(1, &perDrawVAO);
+	glDeleteVertexArrays(1, &instancedVAO);
+	glDeleteBuffers(1, &instanceBuffer);
+	glDeleteBuffers(1, &frameBuffer);
+	arena.cleanup();
+	glDeleteProgram(programID);
+	deleteOffscreenTarget(target);
+	cleanupHeadlessContext();
+	return 0;
+}
@@ -0,0 +1,118 @@
+// Headless benchmark: world matrices of 10k robot arms per frame,
+// hand-unrolled (like renderScene() used to do) vs. KinematicChain with dirty flags.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_kinematic_chain.cpp common/kinematics.cpp -o bench_kinematic_chain
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <common/kinematics.hpp>
+#include "benchutil.hpp"
+
+const int NumArms = 10000;
+const int NumFrames = 200;
+
+// Straight copy of the transform sequence renderScene() used before KinematicChain
+void unrolledArm(const ArmJoints & j, glm::mat4 out[NUM_ARM_LINKS]) {
+	glm::mat4 ModelMatrix = glm::translate(glm::mat4(1.0), j.baseTranslate);
+	out[LINK_BASE] = ModelMatrix;
+	ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 1.0f, 0.0f));
+	ModelMatrix = glm::rotate(ModelMatrix, glm::degrees(j.topRotate), glm::vec3(0.0, 1.0, 0.0));
+	out[LINK_TOP] = ModelMatrix;
+	ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 0.4f, 0.0f));
+	ModelMatrix = glm::rotate(ModelMatrix, glm::degrees(j.arm1Rotate), glm::vec3(1.0f, 0.0f, 0.0f));
+	out[LINK_ARM1] = ModelMatrix;
+	ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 1.25f, 0.0f));
+	out[LINK_JOINT] = ModelMatrix;
+	ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 0.0f, 0.0f));
+	ModelMatrix = glm::rotate(ModelMatrix, glm::degrees(j.arm2Rotate), glm::vec3(1.0f, 0.0f, 0.0f));
+	out[LINK_ARM2] = ModelMatrix;
+	ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 1.0f, 0.0f));
+	ModelMatrix = glm::rotate(ModelMatrix, glm::degrees(j.penRotateLongitude), glm::vec3(0.0f, 0.0f, 1.0f));
+	ModelMatrix = glm::rotate(ModelMatrix, glm::degrees(j.penRotateLatitude), glm::vec3(1.0f, 0.0f, 0.0f));
+	ModelMatrix = glm::rotate(ModelMatrix, glm::degrees(j.penRotateAxis), glm::vec3(0.0f, 1.0f, 0.0f));
+	out[LINK_PEN] = ModelMatrix;
+	ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 0.25f, 0.1f));
+	out[LINK_BUTTON] = ModelMatrix;
+}
+
+ArmJoints randomArm() {
+	ArmJoints j;
+	j.baseTranslate = glm::vec3(rand() % 100 - 50, 0.0f, rand() % 100 - 50);
+	j.topRotate = rand() / (float)RAND_MAX * 0.1f;
+	j.arm1Rotate = rand() / (float)RAND_MAX * 0.01f;
+	j.arm2Rotate = rand() / (float)RAND_MAX * 0.01f;
+	j.penRotateLongitude = 0.0f;
+	j.penRotateLatitude = 0.0f;
+	j.penRotateAxis = 0.0f;
+	return j;
+}
+
+int main(void) {
+	std::vector<ArmJoints> arms(NumArms);
+	for (int i = 0; i < NumArms; i++)
+		arms[i] = randomArm();
+
+	std::vector<KinematicChain> chains(NumArms);
+	for (int i = 0; i < NumArms; i++) {
+		buildRobotArmChain(chains[i]);
+		setRobotArmJoints(chains[i], arms[i]);
+		chains[i].update();
+	}
+
+	std::vector<glm::mat4> unrolled(NumArms * NUM_ARM_LINKS);
+	float checksum = 0.0f;
+
+	// Two workloads: every arm twisting its pen (a single joint moves), and all arms idle
+	const char * names[2] = { "pen moving", "idle" };
+	for (int scenario = 0; scenario < 2; scenario++) {
+		double start = now();
+		for (int frame = 0; frame < NumFrames; frame++) {
+			for (int i = 0; i < NumArms; i++) {
+				if (scenario == 0)
+					arms[i].penRotateAxis += 0.0001f;
+				unrolledArm(arms[i], &unrolled[i * NUM_ARM_LINKS]);
+			}
+			checksum += unrolled[NUM_ARM_LINKS - 1][3][0];
+		}
+		double unrolledTime = now() - start;
+
+		long recomputed = 0;
+		start = now();
+		for (int frame = 0; frame < NumFrames; frame++) {
+			for (int i = 0; i < NumArms; i++) {
+				if (scenario == 0)
+					arms[i].penRotateAxis += 0.0001f;
+				setRobotArmJoints(chains[i], arms[i]);
+				recomputed += chains[i].update();
+			}
+			checksum += chains[0].getWorldMatrix(LINK_BUTTON)[3][0];
+		}
+		double chainTime = now() - start;
+
+		printf("%-10s: unrolled %8.3f ms/frame | chain %8.3f ms/frame (%.2f matrices/arm) | speedup %.2fx\n",
+			names[scenario],
+			1000.0 * unrolledTime / NumFrames,
+			1000.0 * chainTime / NumFrames,
+			recomputed / double(NumFrames * NumArms),
+			unrolledTime / chainTime);
+	}
+
+	// Both paths must agree on the final pose
+	float maxError = 0.0f;
+	for (int i = 0; i < NumArms; i++) {
+		unrolledArm(arms[i], &unrolled[i * NUM_ARM_LINKS]);
+		for (int link = 0; link < NUM_ARM_LINKS; link++)
+			for (int c = 0; c < 4; c++)
+				for (int r = 0; r < 4; r++)
+					maxError = glm::max(maxError, glm::abs(unrolled[i * NUM_ARM_LINKS + link][c][r] - chains[i].getWorldMatrix(link)[c][r]));
+	}
+	printf("max |unrolled - chain| = %g (checksum %f)\n", maxError, checksum);
+
+	return maxError < 1e-4f ? 0 : 1;
+}
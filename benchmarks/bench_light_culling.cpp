@@ -0,0 +1,64 @@
+// Headless benchmark: CPU cost of the clustered light culling pass for 16 to 255 work lights
+// spread over a cell, seen from the demo camera, and how many lights the average and the
+// busiest cluster end up with compared to shading every light everywhere.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_light_culling.cpp common/lightculling.cpp -o bench_light_culling
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <common/lightculling.hpp>
+#include "benchutil.hpp"
+
+const int Width = 1024, Height = 768;
+const int NumFrames = 200;
+const int LightCounts[] = { 16, 32, 64, 128, 255 };
+
+int main(void) {
+	glm::mat4 Projection = glm::perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+	glm::mat4 View = glm::lookAt(glm::vec3(10.0f, 10.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	LightClusterGrid clusters;
+	clusters.resize(Width, Height, 32, 16, 0.1f, 100.0f);
+	const int numClusters = clusters.getTilesX() * clusters.getTilesY() * clusters.getNumSlices();
+	printf("%d x %d tiles x %d slices = %d clusters\n", clusters.getTilesX(), clusters.getTilesY(),
+		clusters.getNumSlices(), numClusters);
+	printf("%7s %12s %16s %16s\n", "lights", "us/cull", "mean per cluster", "max per cluster");
+
+	for (size_t c = 0; c < sizeof(LightCounts) / sizeof(LightCounts[0]); c++) {
+		// Same layout as the demo's work lights over a 5x5 arm cell
+		const int numLights = LightCounts[c];
+		const int side = (int)ceil(sqrt((double)numLights));
+		std::vector<PointLight> lights(numLights);
+		for (int i = 0; i < numLights; i++) {
+			lights[i].position = glm::vec3(-5.0f + 21.0f * ((i % side) + 0.5f) / side, 2.5f, 5.0f - 21.0f * ((i / side) + 0.5f) / side);
+			lights[i].radius = 4.0f;
+			lights[i].color = glm::vec3(1.0f);
+			lights[i].power = 2.0f;
+		}
+
+		clusters.cull(lights, View, Projection);	// warm up
+		double start = now();
+		for (int frame = 0; frame < NumFrames; frame++)
+			clusters.cull(lights, View, Projection);
+		double cullTime = (now() - start) / NumFrames;
+
+		// Only clusters that hold any light, the others are empty space
+		const std::vector<unsigned int>& ranges = clusters.getClusterRanges();
+		long long total = 0;
+		int nonEmpty = 0;
+		for (int i = 0; i < numClusters; i++) {
+			total += ranges[i * 2 + 1];
+			nonEmpty += ranges[i * 2 + 1] > 0;
+		}
+		printf("%7d %12.1f %16.2f %16d\n", numLights, 1e6 * cullTime, nonEmpty > 0 ? (double)total / nonEmpty : 0.0,
+			clusters.getMaxLightsPerCluster());
+	}
+	return 0;
+}
@@ -0,0 +1,88 @@
+// Benchmark: cold start (parseOBJ + indexVBO + writing the cache) vs. warm start
+// (mapping the binary mesh cache) for the bundled models and a generated 1M-triangle grid.
+// Run it from a folder that has the models folder. The caches it writes have no levels of
+// detail, so they are removed again and the demo rebuilds its own on the next start.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_mesh_cache.cpp common/meshcache.cpp common/objparser.cpp
+//       common/mappedfile.cpp common/vboindexer.cpp -o bench_mesh_cache
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <common/objparser.hpp>
+#include <common/vboindexer.hpp>
+#include <common/meshcache.hpp>
+#include "benchutil.hpp"
+
+const int GridSize = 708;	// 2 * 707 * 707 = 999698 triangles
+const char* SyntheticPath = "bench_synthetic.obj";
+const char* modelFiles[] = { "models/base.obj", "models/top.obj", "models/arm1.obj", "models/joint.obj",
+	"models/arm2.obj", "models/pen.obj", "models/button.obj" };
+const int NumModels = sizeof(modelFiles) / sizeof(modelFiles[0]);
+
+// Returns false on any failure, or when the warm load does not give back the cold result
+bool timeModel(const char* path, double& coldTime, double& warmTime, size_t& numTriangles) {
+	remove(meshCachePath(path).c_str());
+
+	double start = now();
+	std::vector<glm::vec3> vertices, normals;
+	std::vector<glm::vec2> uvs;
+	if (!parseOBJ(path, vertices, uvs, normals))
+		return false;
+	std::vector<unsigned int> indices;
+	std::vector<glm::vec3> indexed_vertices, indexed_normals;
+	indexVBO(vertices, normals, indices, indexed_vertices, indexed_normals);
+	// Only the mesh: the levels of detail would time the simplifier, not the cache
+	const std::vector<MeshLod> lods;
+	if (!saveMeshCache(path, indexed_vertices, indexed_normals, indices, lods))
+		return false;
+	coldTime = now() - start;
+
+	start = now();
+	std::vector<unsigned int> cachedIndices;
+	std::vector<glm::vec3> cachedVertices, cachedNormals;
+	std::vector<MeshLod> cachedLods;
+	if (!loadMeshCache(path, cachedVertices, cachedNormals, cachedIndices, cachedLods))
+		return false;
+	warmTime = now() - start;
+
+	remove(meshCachePath(path).c_str());
+	numTriangles = indices.size() / 3;
+	return cachedIndices == indices && cachedVertices == indexed_vertices && cachedNormals == indexed_normals &&
+		cachedLods.empty();
+}
+
+int main(void) {
+	if (!writeSyntheticOBJ(SyntheticPath, GridSize)) {
+		fprintf(stderr, "Could not write %s\n", SyntheticPath);
+		return 1;
+	}
+
+	double coldTotal = 0.0, warmTotal = 0.0;
+	double coldTime, warmTime;
+	size_t numTriangles;
+	printf("%-22s %10s %12s %12s\n", "model", "triangles", "cold (ms)", "warm (ms)");
+	for (int i = 0; i < NumModels; i++) {
+		if (!timeModel(modelFiles[i], coldTime, warmTime, numTriangles)) {
+			fprintf(stderr, "%s: cache failed\n", modelFiles[i]);
+			return 1;
+		}
+		printf("%-22s %10d %12.3f %12.3f\n", modelFiles[i], (int)numTriangles, 1000.0 * coldTime, 1000.0 * warmTime);
+		coldTotal += coldTime;
+		warmTotal += warmTime;
+	}
+	printf("%-22s %10s %12.3f %12.3f\n", "all models", "", 1000.0 * coldTotal, 1000.0 * warmTotal);
+
+	bool ok = timeModel(SyntheticPath, coldTime, warmTime, numTriangles);
+	if (ok)
+		printf("%-22s %10d %12.3f %12.3f (%.0fx)\n", SyntheticPath, (int)numTriangles, 1000.0 * coldTime, 1000.0 * warmTime, coldTime / warmTime);
+	else
+		fprintf(stderr, "%s: cache failed\n", SyntheticPath);
+
+	remove(SyntheticPath);
+	return ok ? 0 : 1;
+}
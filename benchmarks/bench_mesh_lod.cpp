@@ -0,0 +1,146 @@
+// Headless benchmark: levels of detail built by buildMeshLods() for the arm's parts and for a
+// dense sphere, with the triangles and error of each level and the time to build them all.
+// Then a part is moved slowly away from and back towards the camera with a little jitter, and
+// the triangles drawn and the level switches counted by selectMeshLod() with and without
+// hysteresis. Run it from a folder that has the models folder.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_mesh_lod.cpp common/meshsimplify.cpp common/vboindexer.cpp
+//       common/objparser.cpp common/mappedfile.cpp -o bench_mesh_lod
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include <common/objparser.hpp>
+#include <common/vboindexer.hpp>
+#include <common/meshsimplify.hpp>
+#include "benchutil.hpp"
+
+const int NumParts = 7;
+const char* partFiles[NumParts] = { "models/base.obj", "models/top.obj", "models/arm1.obj", "models/joint.obj",
+	"models/arm2.obj", "models/pen.obj", "models/button.obj" };
+const int SphereRings = 256;
+const int SphereSegments = 512;
+const int Repeats = 5;
+// Same as the demo: 45 degree field of view, 768 pixel high window
+const float PixelsPerUnitAtOne = 0.5f / tanf(0.5f * 45.0f * 3.14159265f / 180.0f) * 768.0f;
+const float LodErrorPixels = 0.5f;
+const int PathFrames = 20000;
+
+struct Mesh {
+	const char* name;
+	std::vector<glm::vec3> vertices, normals;
+	std::vector<unsigned int> indices;
+	std::vector<MeshLod> lods;
+	float errors[MaxMeshLods];
+	size_t indexCounts[MaxMeshLods];
+	int count;
+};
+
+// A unit sphere with smooth normals, as the corner lists parseOBJ() gives
+void buildSphere(std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals) {
+	for (int ring = 0; ring < SphereRings; ring++) {
+		for (int segment = 0; segment < SphereSegments; segment++) {
+			glm::vec3 p[4];
+			for (int corner = 0; corner < 4; corner++) {
+				const float theta = 3.14159265f * (ring + (corner >> 1)) / SphereRings;
+				const float phi = 2.0f * 3.14159265f * ((segment + (corner & 1)) % SphereSegments) / SphereSegments;
+				p[corner] = glm::vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+			}
+			const int quad[6] = { 0, 2, 1, 1, 2, 3 };
+			for (int i = 0; i < 6; i++) {
+				vertices.push_back(p[quad[i]]);
+				normals.push_back(p[quad[i]]);
+			}
+		}
+	}
+}
+
+// Builds the levels, best time of Repeats, and prints them
+void buildLevels(Mesh& mesh) {
+	glm::vec3 boxMin = mesh.vertices[0], boxMax = mesh.vertices[0];
+	for (size_t i = 1; i < mesh.vertices.size(); i++) {
+		boxMin = glm::min(boxMin, mesh.vertices[i]);
+		boxMax = glm::max(boxMax, mesh.vertices[i]);
+	}
+	double best = 1e30;
+	for (int run = 0; run < Repeats; run++) {
+		const double start = now();
+		buildMeshLods(mesh.vertices, mesh.normals, mesh.indices, LodMaxError * glm::length(boxMax - boxMin), mesh.lods);
+		best = std::min(best, now() - start);
+	}
+
+	mesh.count = 1 + (int)mesh.lods.size();
+	mesh.errors[0] = 0.0f;
+	mesh.indexCounts[0] = mesh.indices.size();
+	for (size_t lod = 0; lod < mesh.lods.size(); lod++) {
+		mesh.errors[lod + 1] = mesh.lods[lod].error;
+		mesh.indexCounts[lod + 1] = mesh.lods[lod].indices.size();
+	}
+	printf("%18s %10.2f ", mesh.name, best * 1e3);
+	for (int lod = 0; lod < mesh.count; lod++)
+		printf(" %8d (%.4f)", (int)mesh.indexCounts[lod] / 3, mesh.errors[lod]);
+	printf("\n");
+}
+
+// Away from 2 to 60 units and back, each frame jittered by up to 1%; returns the level switches
+int runPath(const Mesh& mesh, float hysteresis, double& out_triangles) {
+	int lod = 0, switches = 0;
+	out_triangles = 0.0;
+	unsigned int seed = 1;
+	for (int frame = 0; frame < PathFrames; frame++) {
+		const float t = (float)frame / (PathFrames - 1);
+		const float distance = 2.0f + 58.0f * (1.0f - fabsf(2.0f * t - 1.0f));
+		seed = seed * 1664525u + 1013904223u;
+		const float jitter = 1.0f + 0.01f * ((seed >> 8) / 8388608.0f - 1.0f);
+		const int next = selectMeshLod(mesh.errors, mesh.count, PixelsPerUnitAtOne / (distance * jitter), lod,
+			LodErrorPixels, hysteresis);
+		switches += next != lod;
+		lod = next;
+		out_triangles += mesh.indexCounts[lod] / 3;
+	}
+	out_triangles /= PathFrames;
+	return switches;
+}
+
+int main(void) {
+	std::vector<Mesh> meshes(NumParts + 1);
+	for (int part = 0; part <= NumParts; part++) {
+		Mesh& mesh = meshes[part];
+		std::vector<glm::vec3> vertices, normals;
+		if (part < NumParts) {
+			std::vector<glm::vec2> uvs;
+			if (!parseOBJ(partFiles[part], vertices, uvs, normals)) {
+				fprintf(stderr, "Could not load %s\n", partFiles[part]);
+				return 1;
+			}
+			mesh.name = partFiles[part];
+		} else {
+			buildSphere(vertices, normals);
+			mesh.name = "sphere";
+		}
+		indexVBO(vertices, normals, mesh.indices, mesh.vertices, mesh.normals);
+	}
+
+	printf("Levels of detail, max error %.2f of the box diagonal\n", LodMaxError);
+	printf("%18s %10s  triangles (error) per level\n", "mesh", "build (ms)");
+	for (size_t i = 0; i < meshes.size(); i++)
+		buildLevels(meshes[i]);
+
+	printf("\n%d frames from 2 to 60 units and back, 1%% jitter, %.1f px error\n", PathFrames, LodErrorPixels);
+	printf("%18s %12s %10s %12s %10s\n", "mesh", "triangles", "switches", "triangles", "switches");
+	printf("%18s %23s %23s\n", "", "no hysteresis", "20% hysteresis");
+	for (size_t i = 0; i < meshes.size(); i++) {
+		if (meshes[i].count < 2)
+			continue;
+		double plain, steady;
+		const int plainSwitches = runPath(meshes[i], 0.0f, plain);
+		const int steadySwitches = runPath(meshes[i], 0.2f, steady);
+		printf("%18s %12.1f %10d %12.1f %10d\n", meshes[i].name, plain, plainSwitches, steady, steadySwitches);
+	}
+	return 0;
+}
@@ -0,0 +1,57 @@
+// Benchmark: the memory-mapped parseOBJ() vs. the fscanf-based loadOBJ() on a synthetic
+// CAD-sized file (a 1M-triangle v//vn grid, the only face format loadOBJ() reads).
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_obj_parser.cpp common/objparser.cpp common/mappedfile.cpp common/objloader.cpp -o bench_obj_parser
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <common/objloader.hpp>
+#include <common/objparser.hpp>
+#include "benchutil.hpp"
+
+const int GridSize = 708;	// 2 * 707 * 707 = 999698 triangles
+const char* SyntheticPath = "bench_synthetic.obj";
+
+int main(void) {
+	if (!writeSyntheticOBJ(SyntheticPath, GridSize)) {
+		fprintf(stderr, "Could not write %s\n", SyntheticPath);
+		return 1;
+	}
+
+	std::vector<glm::vec3> oldVertices, oldNormals;
+	double start = now();
+	if (!loadOBJ(SyntheticPath, oldVertices, oldNormals))
+		return 1;
+	double oldTime = now() - start;
+
+	std::vector<glm::vec3> newVertices, newNormals;
+	std::vector<glm::vec2> newUVs;
+	std::vector<ObjObject> objects;
+	start = now();
+	if (!parseOBJ(SyntheticPath, newVertices, newUVs, newNormals, &objects))
+		return 1;
+	double newTime = now() - start;
+
+	bool same = oldVertices.size() == newVertices.size() && oldNormals.size() == newNormals.size();
+	float maxError = 0.0f;
+	for (size_t i = 0; same && i < oldVertices.size(); i++) {
+		maxError = glm::max(maxError, glm::length(oldVertices[i] - newVertices[i]));
+		maxError = glm::max(maxError, glm::length(oldNormals[i] - newNormals[i]));
+	}
+	same = same && maxError < 1e-6f;
+
+	printf("%d triangles\n", (int)(newVertices.size() / 3));
+	printf("loadOBJ (fscanf) : %8.1f ms\n", 1000.0 * oldTime);
+	printf("parseOBJ (mmap)  : %8.1f ms (%.1fx)\n", 1000.0 * newTime, oldTime / newTime);
+	printf("objects: %d ('%s', %d triangles), outputs %s\n", (int)objects.size(),
+		objects.empty() ? "" : objects[0].name.c_str(), objects.empty() ? 0 : (int)objects[0].triangleCount,
+		same ? "identical" : "DIFFER");
+
+	remove(SyntheticPath);
+	return same ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+// Headless benchmark: CPU ray-cast picking against per-part BVHs vs. the
+// glFinish() + glReadPixels() picking pass, on the same random cursor positions.
+// Run it from a folder that has the models folder and the Picking shaders.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_picking.cpp common/bvh.cpp common/kinematics.cpp common/headless.cpp
+//       common/objloader.cpp common/vboindexer.cpp common/shader.cpp -lGLEW -lglfw -lEGL -lGL -o bench_picking
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <common/shader.hpp>
+#include <common/objloader.hpp>
+#include <common/vboindexer.hpp>
+#include <common/kinematics.hpp>
+#include <common/headless.hpp>
+#include <common/bvh.hpp>
+#include "benchutil.hpp"
+
+const int Width = 1024, Height = 768;
+const int NumPicks = 2000;
+const char* partFiles[NUM_ARM_LINKS] = { "models/base.obj", "models/top.obj", "models/arm1.obj", "models/joint.obj",
+	"models/arm2.obj", "models/pen.obj", "models/button.obj" };
+
+// std140 layout of the Picking shaders' ObjectData block
+struct PickObjectData {
+	glm::mat4 MVP;
+	glm::vec4 PickingColor;
+};
+
+int main(void) {
+	if (initHeadlessContext(Width, Height) != 0)
+		return 1;
+	OffscreenTarget target;
+	if (!createOffscreenTarget(target, Width, Height))
+		return 1;
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+
+	GLuint pickingProgramID = LoadShaders("Picking.vertexshader", "Picking.fragmentshader");
+	glUniformBlockBinding(pickingProgramID, glGetUniformBlockIndex(pickingProgramID, "ObjectData"), 0);
+
+	MeshBVH bvh[NUM_ARM_LINKS];
+	GLuint vao[NUM_ARM_LINKS], vbo[NUM_ARM_LINKS], ibo[NUM_ARM_LINKS];
+	GLsizei numIndices[NUM_ARM_LINKS];
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		std::vector<glm::vec3> vertices, normals;
+		if (!loadOBJ(partFiles[link], vertices, normals))
+			return 1;
+		bvh[link].build(vertices);
+
+		std::vector<unsigned short> indices;
+		std::vector<glm::vec3> indexed_vertices, indexed_normals;
+		indexVBO(vertices, normals, indices, indexed_vertices, indexed_normals);
+		numIndices[link] = (GLsizei)indices.size();
+
+		glGenVertexArrays(1, &vao[link]);
+		glBindVertexArray(vao[link]);
+		glGenBuffers(1, &vbo[link]);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo[link]);
+		glBufferData(GL_ARRAY_BUFFER, indexed_vertices.size() * sizeof(glm::vec3), &indexed_vertices[0], GL_STATIC_DRAW);
+		glGenBuffers(1, &ibo[link]);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo[link]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), &indices[0], GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		glEnableVertexAttribArray(0);
+	}
+	glBindVertexArray(0);
+
+	// A slightly bent arm seen from the default camera
+	KinematicChain chain;
+	buildRobotArmChain(chain);
+	ArmJoints joints = { glm::vec3(0.0f), 0.01f, 0.005f, -0.008f, 0.004f, 0.006f, 0.0f };
+	setRobotArmJoints(chain, joints);
+	chain.update();
+	glm::mat4 Projection = glm::perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+	glm::mat4 View = glm::lookAt(glm::vec3(10.0f, 10.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	// The arm does not move, so every part's ObjectData block is written once, each on an offset
+	// uniform blocks may be bound at
+	GLint alignment;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	const size_t objectStride = (sizeof(PickObjectData) + alignment - 1) / alignment * alignment;
+	std::vector<char> objects(objectStride * NUM_ARM_LINKS);
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		PickObjectData& object = *(PickObjectData*)&objects[link * objectStride];
+		object.MVP = Projection * View * chain.getWorldMatrix(link);
+		object.PickingColor = glm::vec4(link / 255.0f, 0.0f, 0.0f, 1.0f);
+	}
+	GLuint objectBuffer;
+	glGenBuffers(1, &objectBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, objectBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, objects.size(), &objects[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	// Cursor positions around the arm's screen footprint, where clicks land in practice
+	std::vector<int> px(NumPicks), py(NumPicks);
+	for (int i = 0; i < NumPicks; i++) {
+		px[i] = Width / 2 - 40 + rand() % 80;
+		py[i] = Height / 4 + rand() % (Height / 4 + 20);
+	}
+
+	// CPU path
+	std::vector<int> cpuResult(NumPicks);
+	double start = now();
+	for (int i = 0; i < NumPicks; i++) {
+		glm::vec3 rayOrigin, rayDirection;
+		screenPointToRay(px[i], py[i], Width, Height, Projection, View, rayOrigin, rayDirection);
+		float nearestT = 1.0f;
+		cpuResult[i] = 255;
+		for (int link = 0; link < NUM_ARM_LINKS; link++) {
+			glm::mat4 InverseModel = glm::inverse(chain.getWorldMatrix(link));
+			RayHit hit;
+			if (bvh[link].intersect(glm::vec3(InverseModel * glm::vec4(rayOrigin, 1.0f)),
+					glm::vec3(InverseModel * glm::vec4(rayDirection, 0.0f)), nearestT, hit)) {
+				nearestT = hit.t;
+				cpuResult[i] = link;
+			}
+		}
+	}
+	double cpuTime = now() - start;
+
+	// Readback path: draw the ID scene, wait for it, read one pixel
+	std::vector<int> gpuResult(NumPicks);
+	start = now();
+	for (int i = 0; i < NumPicks; i++) {
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glUseProgram(pickingProgramID);
+		for (int link = 0; link < NUM_ARM_LINKS; link++) {
+			glBindBufferRange(GL_UNIFORM_BUFFER, 0, objectBuffer, link * objectStride, sizeof(PickObjectData));
+			glBindVertexArray(vao[link]);
+			glDrawElements(GL_TRIANGLES, numIndices[link], GL_UNSIGNED_SHORT, (void*)0);
+		}
+		glFlush();
+		glFinish();
+		unsigned char data[4];
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(px[i], Height - 1 - py[i], 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		gpuResult[i] = data[0];
+	}
+	double gpuTime = now() - start;
+
+	int agree = 0, hits = 0;
+	for (int i = 0; i < NumPicks; i++) {
+		agree += cpuResult[i] == gpuResult[i];
+		hits += cpuResult[i] != 255;
+	}
+
+	printf("%s\n", (const char*)glGetString(GL_RENDERER));
+	printf("CPU ray cast (BVH): %10.3f us/pick\n", 1e6 * cpuTime / NumPicks);
+	printf("glReadPixels pass : %10.3f us/pick\n", 1e6 * gpuTime / NumPicks);
+	printf("%d/%d picks agree (%d hit a part; edge pixels can differ)\n", agree, NumPicks, hits);
+
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		glDeleteBuffers(1, &vbo[link]);
+		glDeleteBuffers(1, &ibo[link]);
+		glDeleteVertexArrays(1, &vao[link]);
+	}
+	glDeleteBuffers(1, &objectBuffer);
+	glDeleteProgram(pickingProgramID);
+	deleteOffscreenTarget(target);
+	cleanupHeadlessContext();
+	return agree > NumPicks * 95 / 100 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// Headless benchmark: records a 1M tick (about 17 minutes at 1 kHz) session of random key
+// presses, target switches and speed changes through SimRecorder, then reads it back with
+// SimReplay. Prints the cost of a tick with and without recording, bytes per tick, the
+// replay rate, and checks that every tick reads back bit for bit.
+//
+// Build (from the repo root):
+//   g++ -O2 -pthread -I. -I<path to glm> benchmarks/bench_simlog.cpp common/simlog.cpp common/simulation.cpp
+//       common/controls.cpp common/kinematics.cpp common/mappedfile.cpp -lglfw -o bench_simlog
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <GLFW/glfw3.h>
+
+#include <common/simulation.hpp>
+#include <common/simlog.hpp>
+#include "benchutil.hpp"
+
+const int NumTicks = 1000000;
+const float TickSeconds = 0.001f;
+const char* LogPath = "bench_simlog.log";
+
+// controls.cpp reads the keys from the demo's window; the benchmark only steps the simulation
+GLFWwindow* window = NULL;
+
+// A user holding keys for 0.05 to 2 s at a time, now and then picking another part or speed
+std::vector<SimInput> randomSession(int ticks) {
+	std::vector<SimInput> inputs(ticks);
+	srand(1);
+	SimInput held;
+	held.target = CONTROL_BASE;
+	for (int i = 0; i < ticks; ) {
+		const int run = 50 + rand() % 1950;
+		if (rand() % 4 == 0)
+			held.target = (ControlTarget)(rand() % (CONTROL_PEN + 1));
+		if (rand() % 16 == 0)
+			held.speedScale = 0.25f * (1 + rand() % 8);
+		const int keys = rand() % 3 == 0 ? 0 : rand() % 16;
+		held.keys.left = (keys & 1) != 0;
+		held.keys.right = (keys & 2) != 0;
+		held.keys.up = (keys & 4) != 0;
+		held.keys.down = (keys & 8) != 0;
+		held.shift = rand() % 3 == 0;
+		for (int j = 0; j < run && i < ticks; j++, i++)
+			inputs[i] = held;
+	}
+	return inputs;
+}
+
+bool sameBits(const ArmJoints & a, const ArmJoints & b) {
+	return memcmp(&a.baseTranslate, &b.baseTranslate, sizeof(a.baseTranslate)) == 0 &&
+		memcmp(&a.topRotate, &b.topRotate, sizeof(float)) == 0 && memcmp(&a.arm1Rotate, &b.arm1Rotate, sizeof(float)) == 0 &&
+		memcmp(&a.arm2Rotate, &b.arm2Rotate, sizeof(float)) == 0 &&
+		memcmp(&a.penRotateLongitude, &b.penRotateLongitude, sizeof(float)) == 0 &&
+		memcmp(&a.penRotateLatitude, &b.penRotateLatitude, sizeof(float)) == 0 &&
+		memcmp(&a.penRotateAxis, &b.penRotateAxis, sizeof(float)) == 0;
+}
+
+int main(void) {
+	const std::vector<SimInput> inputs = randomSession(NumTicks);
+	std::vector<ArmJoints> states(NumTicks);
+
+	// The session is stepped once without recording (for the baseline and the expected
+	// joints), and recording is timed on top
+	SimState state = SimState();
+	double start = now();
+	for (int i = 0; i < NumTicks; i++) {
+		stepSimulation(inputs[i], state, TickSeconds);
+		states[i] = state.joints;
+	}
+	const double stepSeconds = now() - start;
+
+	SimRecorder recorder;
+	SimState first = SimState();
+	if (!recorder.open(LogPath, TickSeconds, first)) {
+		fprintf(stderr, "Could not write %s\n", LogPath);
+		return 1;
+	}
+	start = now();
+	for (int i = 0; i < NumTicks; i++) {
+		state.joints = states[i];
+		recorder.record(inputs[i], state);
+	}
+	if (!recorder.close()) {
+		fprintf(stderr, "Could not write %s\n", LogPath);
+		return 1;
+	}
+	const double recordSeconds = now() - start;
+	const unsigned long long bytes = recorder.getBytes();
+
+	SimReplay replay;
+	if (!replay.open(LogPath)) {
+		fprintf(stderr, "Could not read %s\n", LogPath);
+		return 1;
+	}
+	int mismatches = 0;
+	start = now();
+	SimInput input;
+	ArmJoints recorded;
+	int ticks = 0;
+	while (replay.next(input, recorded)) {
+		if (ticks >= NumTicks || input.target != inputs[ticks].target || input.shift != inputs[ticks].shift ||
+			input.speedScale != inputs[ticks].speedScale || input.keys.left != inputs[ticks].keys.left ||
+			input.keys.right != inputs[ticks].keys.right || input.keys.up != inputs[ticks].keys.up ||
+			input.keys.down != inputs[ticks].keys.down || !sameBits(recorded, states[ticks]))
+			mismatches++;
+		ticks++;
+	}
+	const double replaySeconds = now() - start;
+	replay.close();
+	remove(LogPath);
+
+	printf("%d ticks of %.0f ms\n", NumTicks, 1000.0 * TickSeconds);
+	printf("step:   %8.1f ns/tick\n", 1e9 * stepSeconds / NumTicks);
+	printf("record: %8.1f ns/tick (%.2f%% of a tick's step), %.2f bytes/tick, %.1f KB per minute at 1 kHz\n",
+		1e9 * recordSeconds / NumTicks, 100.0 * recordSeconds / stepSeconds,
+		(double)(bytes - sizeof(SimLogHeader)) / NumTicks, (bytes - sizeof(SimLogHeader)) * 60000.0 / NumTicks / 1024.0);
+	printf("replay: %8.1f ns/tick, %d ticks read, %d mismatches\n", 1e9 * replaySeconds / ticks, ticks, mismatches);
+	return mismatches == 0 && ticks == NumTicks ? 0 : 1;
+}
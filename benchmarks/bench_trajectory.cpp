@@ -0,0 +1,145 @@
+// Headless benchmark: a 64 s arm trajectory through 33 keys (one of them with the pen in gimbal
+// lock, latitude 90 degrees), sampled at 1 kHz with cubic and quintic splines. Prints samples per
+// second for one sample() call per sample and for the whole trajectory in one call, how
+// closely the samples hit the keys, and the largest pen turn, change of turn rate and joint
+// step between samples, next to the same keys interpolated linearly joint by joint.
+//
+// Build (from the repo root), -march=native for the AVX2 path:
+//   g++ -O2 -march=native -pthread -I. -I<path to glm> benchmarks/bench_trajectory.cpp common/trajectory.cpp
+//       common/quaternion_utils.cpp common/arm_ik.cpp common/kinematics.cpp common/threadpool.cpp -o bench_trajectory
+
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <common/kinematics.hpp>
+#include <common/arm_ik.hpp>
+#include <common/trajectory.hpp>
+#include "benchutil.hpp"
+
+const int NumKeys = 33;
+const float KeySpacing = 2.0f;
+const float SampleRate = 1000.0f;
+
+// Joint angle from degrees, in the chain's units (see jointRotation)
+float jointAngle(float degrees) {
+	return glm::radians(glm::radians(degrees));
+}
+
+float randomIn(float lo, float hi) {
+	return lo + (hi - lo) * (float)rand() / RAND_MAX;
+}
+
+// Angle between two orientations, degrees (atan2 stays accurate for small angles, acos does not)
+float turn(const glm::quat & a, const glm::quat & b) {
+	const glm::quat d = glm::conjugate(a) * b;
+	return glm::degrees(2.0f * atan2f(sqrtf(d.x * d.x + d.y * d.y + d.z * d.z), fabsf(d.w)));
+}
+
+// Largest J1-J6 step between samples, degrees
+float jointStep(const ArmJoints & a, const ArmJoints & b) {
+	float d = fabsf(a.topRotate - b.topRotate);
+	d = std::max(d, fabsf(a.arm1Rotate - b.arm1Rotate));
+	d = std::max(d, fabsf(a.arm2Rotate - b.arm2Rotate));
+	d = std::max(d, fabsf(a.penRotateLongitude - b.penRotateLongitude));
+	d = std::max(d, fabsf(a.penRotateLatitude - b.penRotateLatitude));
+	d = std::max(d, fabsf(a.penRotateAxis - b.penRotateAxis));
+	return glm::degrees(glm::degrees(d));
+}
+
+// Largest pen turn between samples, largest change of that turn (degrees per sample, and per
+// sample squared), and largest joint step
+void penMotion(const std::vector<ArmJoints> & samples, float & maxTurn, float & maxTurnChange, float & maxStep) {
+	maxTurn = maxTurnChange = maxStep = 0.0f;
+	glm::quat previous = penPose(samples[0]).orientation;
+	float previousTurn = 0.0f;
+	for (size_t i = 1; i < samples.size(); i++) {
+		const glm::quat current = penPose(samples[i]).orientation;
+		const float t = turn(previous, current);
+		maxTurn = std::max(maxTurn, t);
+		maxStep = std::max(maxStep, jointStep(samples[i], samples[i - 1]));
+		if (i > 1)
+			maxTurnChange = std::max(maxTurnChange, fabsf(t - previousTurn));
+		previous = current;
+		previousTurn = t;
+	}
+}
+
+int main(void) {
+	srand(7);
+	std::vector<TrajectoryKey> keys(NumKeys);
+	for (int i = 0; i < NumKeys; i++) {
+		ArmJoints & joints = keys[i].joints;
+		keys[i].time = i * KeySpacing;
+		joints.baseTranslate = glm::vec3(randomIn(-1.0f, 1.0f), 0.0f, randomIn(-1.0f, 1.0f));
+		joints.topRotate = jointAngle(randomIn(-180.0f, 180.0f));
+		joints.arm1Rotate = jointAngle(randomIn(-60.0f, 60.0f));
+		joints.arm2Rotate = jointAngle(randomIn(-90.0f, 90.0f));
+		joints.penRotateLongitude = jointAngle(randomIn(-150.0f, 150.0f));
+		joints.penRotateLatitude = jointAngle(i == NumKeys / 2 ? 90.0f : randomIn(-80.0f, 80.0f));
+		joints.penRotateAxis = jointAngle(randomIn(-150.0f, 150.0f));
+	}
+	const float duration = keys.back().time;
+	const size_t count = (size_t)(duration * SampleRate) + 1;
+	std::vector<ArmJoints> samples(count);
+	printf("%d keys, %.0f s at %.0f Hz: %d samples\n", NumKeys, duration, SampleRate, (int)count);
+
+	const char * names[2] = { "cubic", "quintic" };
+	printf("%8s %14s %14s %12s %15s %16s %15s\n", "spline", "single (M/s)", "batch (M/s)", "key error", "max turn (deg)",
+		"max turn change", "max J step (deg)");
+	for (int kind = 0; kind < 2; kind++) {
+		ArmTrajectory trajectory;
+		trajectory.build(keys.data(), keys.size(), kind == 0 ? SPLINE_CUBIC : SPLINE_QUINTIC);
+
+		// Best of three each
+		double single = 1e30, batch = 1e30;
+		for (int run = 0; run < 3; run++) {
+			double start = now();
+			for (size_t i = 0; i < count; i++)
+				samples[i] = trajectory.sample(i / SampleRate);
+			single = std::min(single, now() - start);
+			start = now();
+			trajectory.sample(0.0f, 1.0f / SampleRate, count, samples.data());
+			batch = std::min(batch, now() - start);
+		}
+
+		// The samples at the keys should land on the keys' pen poses
+		float keyError = 0.0f;
+		for (int i = 0; i < NumKeys; i++) {
+			const ArmJoints joints = trajectory.sample(keys[i].time);
+			const PenPose expected = penPose(keys[i].joints), got = penPose(joints);
+			keyError = std::max(keyError, glm::length(expected.position - got.position));
+			keyError = std::max(keyError, glm::radians(turn(expected.orientation, got.orientation)));
+		}
+		float maxTurn, maxTurnChange, maxStep;
+		penMotion(samples, maxTurn, maxTurnChange, maxStep);
+		printf("%8s %14.2f %14.2f %12.2e %15.4f %16.2e %15.3f\n", names[kind], count / single / 1e6, count / batch / 1e6,
+			keyError, maxTurn, maxTurnChange, maxStep);
+	}
+
+	// The same keys with J4-J6 (and the rest) interpolated linearly
+	for (size_t i = 0; i < count; i++) {
+		const float t = i / SampleRate;
+		const int k = std::min((int)(t / KeySpacing), NumKeys - 2);
+		const float u = (t - keys[k].time) / KeySpacing;
+		const ArmJoints & a = keys[k].joints;
+		const ArmJoints & b = keys[k + 1].joints;
+		ArmJoints & s = samples[i];
+		s.baseTranslate = a.baseTranslate + (b.baseTranslate - a.baseTranslate) * u;
+		s.topRotate = a.topRotate + (b.topRotate - a.topRotate) * u;
+		s.arm1Rotate = a.arm1Rotate + (b.arm1Rotate - a.arm1Rotate) * u;
+		s.arm2Rotate = a.arm2Rotate + (b.arm2Rotate - a.arm2Rotate) * u;
+		s.penRotateLongitude = a.penRotateLongitude + (b.penRotateLongitude - a.penRotateLongitude) * u;
+		s.penRotateLatitude = a.penRotateLatitude + (b.penRotateLatitude - a.penRotateLatitude) * u;
+		s.penRotateAxis = a.penRotateAxis + (b.penRotateAxis - a.penRotateAxis) * u;
+	}
+	float maxTurn, maxTurnChange, maxStep;
+	penMotion(samples, maxTurn, maxTurnChange, maxStep);
+	printf("%8s %14s %14s %12s %15.4f %16.2e %15.3f\n", "linear", "", "", "", maxTurn, maxTurnChange, maxStep);
+	return 0;
+}
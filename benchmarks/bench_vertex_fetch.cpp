@@ -0,0 +1,182 @@
+// Headless benchmark: vertex fetch cost of the old 44-byte vertex (float position/color/normal)
+// vs. the compact 20-byte one (3 float position, RGBA8 color, 10_10_10_2 normal) on a large
+// mesh drawn with the StandardShading shaders. Rasterization is discarded so the numbers
+// are dominated by vertex fetch and shading. Run it from a folder that has the shaders.
+//
+// Build (from the repo root):
+//   g++ -O2 -I. -I<path to glm> benchmarks/bench_vertex_fetch.cpp common/vertexpacking.cpp common/headless.cpp
+//       common/shader.cpp -lGLEW -lglfw -lEGL -lGL -o bench_vertex_fetch
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <common/shader.hpp>
+#include <common/headless.hpp>
+#include <common/vertexpacking.hpp>
+#include "benchutil.hpp"
+
+const int GridSize = 1024;	// 1M vertices, 2M triangles
+const int NumDraws = 20;
+
+struct WideVertex {
+	float Position[4];
+	float Color[4];
+	float Normal[3];
+};
+
+struct CompactVertex {
+	float Position[3];
+	GLuint Normal;
+	GLubyte Color[4];
+};
+
+// std140 layout of the shaders' FrameData block
+struct FrameData {
+	glm::mat4 V;
+	glm::mat4 P;
+};
+
+GLuint createVAO(const void* vertices, size_t vertexBytes, GLuint indexBuffer, bool compact, GLuint& out_vbo) {
+	GLuint vao;
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(1, &out_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, out_vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	if (compact) {
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CompactVertex), 0);
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactVertex), (GLvoid*)16);
+		glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(CompactVertex), (GLvoid*)12);
+	}
+	else {
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(WideVertex), 0);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(WideVertex), (GLvoid*)16);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(WideVertex), (GLvoid*)32);
+	}
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+	return vao;
+}
+
+// Seconds per draw of the whole mesh
+double timeDraws(GLuint vao, GLsizei numIndices) {
+	glBindVertexArray(vao);
+	glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, (void*)0);	// warm up
+	glFinish();
+	double start = now();
+	for (int i = 0; i < NumDraws; i++)
+		glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, (void*)0);
+	glFinish();
+	glBindVertexArray(0);
+	return (now() - start) / NumDraws;
+}
+
+int main(void) {
+	if (initHeadlessContext(64, 64) != 0)
+		return 1;
+	OffscreenTarget target;
+	if (!createOffscreenTarget(target, 64, 64))
+		return 1;
+
+	GLuint programID = LoadShaders("StandardShading.vertexshader", "StandardShading.fragmentshader");
+	if (programID == 0)
+		return 1;
+
+	// A bumpy grid with per-vertex normals and colors
+	const int numVertices = GridSize * GridSize;
+	std::vector<WideVertex> wide(numVertices);
+	std::vector<CompactVertex> compact(numVertices);
+	for (int z = 0; z < GridSize; z++) {
+		for (int x = 0; x < GridSize; x++) {
+			int i = z * GridSize + x;
+			float height = 0.05f * (float)((x * 7 + z * 13) % 17) / 17.0f;
+			glm::vec3 normal = glm::normalize(glm::vec3(0.1f * ((x % 5) - 2), 1.0f, 0.1f * ((z % 3) - 1)));
+			float color[4] = { x / (float)GridSize, z / (float)GridSize, 0.5f, 1.0f };
+			float position[4] = { x * 0.01f - 5.0f, height, z * 0.01f - 5.0f, 1.0f };
+			for (int k = 0; k < 4; k++) {
+				wide[i].Position[k] = position[k];
+				wide[i].Color[k] = color[k];
+			}
+			for (int k = 0; k < 3; k++) {
+				wide[i].Normal[k] = normal[k];
+				compact[i].Position[k] = position[k];
+			}
+			compact[i].Normal = packNormal2_10_10_10(normal);
+			packColorRGBA8(color, compact[i].Color);
+		}
+	}
+	std::vector<GLuint> indices;
+	indices.reserve((GridSize - 1) * (GridSize - 1) * 6);
+	for (int z = 0; z + 1 < GridSize; z++) {
+		for (int x = 0; x + 1 < GridSize; x++) {
+			GLuint a = z * GridSize + x, b = a + 1, c = a + GridSize, d = c + 1;
+			GLuint quad[6] = { a, c, b, b, c, d };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+
+	GLuint indexBuffer;
+	glGenBuffers(1, &indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+	GLuint wideVBO, compactVBO;
+	GLuint wideVAO = createVAO(&wide[0], wide.size() * sizeof(WideVertex), indexBuffer, false, wideVBO);
+	GLuint compactVAO = createVAO(&compact[0], compact.size() * sizeof(CompactVertex), indexBuffer, true, compactVBO);
+
+	glm::mat4 Projection = glm::perspective(45.0f, 1.0f, 0.1f, 100.0f);
+	glm::mat4 View = glm::lookAt(glm::vec3(10.0f, 10.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 Model = glm::mat4(1.0f);
+	glUseProgram(programID);
+	// V and P are the shaders' FrameData uniform block. The light blocks stay unbound:
+	// rasterization is discarded, so no fragment shader runs.
+	FrameData frame = { View, Projection };
+	GLuint frameBuffer;
+	glGenBuffers(1, &frameBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(frame), &frame, GL_STATIC_DRAW);
+	glUniformBlockBinding(programID, glGetUniformBlockIndex(programID, "FrameData"), 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, 0, frameBuffer);
+	// Model matrix (locations 3-6) and material color (7) are per-draw vertex attributes
+	for (int i = 0; i < 4; i++)
+		glVertexAttrib4fv(3 + i, &Model[i][0]);
+	glVertexAttrib4f(7, 1.0f, 1.0f, 1.0f, 1.0f);
+	glEnable(GL_RASTERIZER_DISCARD);
+
+	// Alternate the two layouts so clock or cache drift hits both
+	double wideTime = 0.0, compactTime = 0.0;
+	for (int round = 0; round < 3; round++) {
+		wideTime += timeDraws(wideVAO, (GLsizei)indices.size());
+		compactTime += timeDraws(compactVAO, (GLsizei)indices.size());
+	}
+	wideTime /= 3.0;
+	compactTime /= 3.0;
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	printf("%s\n", (const char*)glGetString(GL_RENDERER));
+	printf("%d vertices, %d triangles\n", numVertices, (int)indices.size() / 3);
+	printf("44-byte vertex: %8.3f ms/draw, %6.1f MB vertex data, %6.2f GB/s fetched\n", 1000.0 * wideTime,
+		wide.size() * sizeof(WideVertex) / 1e6, wide.size() * sizeof(WideVertex) / wideTime / 1e9);
+	printf("20-byte vertex: %8.3f ms/draw, %6.1f MB vertex data, %6.2f GB/s fetched (%.2fx)\n", 1000.0 * compactTime,
+		compact.size() * sizeof(CompactVertex) / 1e6, compact.size() * sizeof(CompactVertex) / compactTime / 1e9,
+		wideTime / compactTime);
+
+	glDeleteBuffers(1, &wideVBO);
+	glDeleteBuffers(1, &compactVBO);
+	glDeleteBuffers(1, &indexBuffer);
+	glDeleteBuffers(1, &frameBuffer);
+	glDeleteVertexArrays(1, &wideVAO);
+	glDeleteVertexArrays(1, &compactVAO);
+	glDeleteProgram(programID);
+	deleteOffscreenTarget(target);
+	cleanupHeadlessContext();
+	return 0;
+}
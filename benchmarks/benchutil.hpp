@@ -0,0 +1,36 @@
+#ifndef BENCHUTIL_HPP
+#define BENCHUTIL_HPP
+
+// Helpers shared by the benchmarks. Header only, so the build lines do not change.
+
+#include <stdio.h>
+#include <chrono>
+
+// Seconds on the steady clock
+inline double now() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A CAD-sized test file: a gridSize x gridSize v//vn grid with a little height noise,
+// 2 * (gridSize - 1)^2 triangles
+inline bool writeSyntheticOBJ(const char* path, int gridSize) {
+	FILE* file = fopen(path, "w");
+	if (file == NULL)
+		return false;
+	fprintf(file, "# synthetic benchmark grid\no Grid\n");
+	for (int z = 0; z < gridSize; z++)
+		for (int x = 0; x < gridSize; x++)
+			fprintf(file, "v %f %f %f\n", x * 0.01f, 0.05f * (float)((x * 7 + z * 13) % 17) / 17.0f, z * 0.01f);
+	fprintf(file, "vn 0.000000 1.000000 0.000000\n");
+	for (int z = 0; z + 1 < gridSize; z++) {
+		for (int x = 0; x + 1 < gridSize; x++) {
+			int a = z * gridSize + x + 1, b = a + 1, c = a + gridSize, d = c + 1;
+			fprintf(file, "f %d//1 %d//1 %d//1\n", a, c, b);
+			fprintf(file, "f %d//1 %d//1 %d//1\n", b, c, d);
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+#endif
@@ -0,0 +1,251 @@
+#include <vector>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "simdlanes.hpp"
+#include "arm_batch.hpp"
+
+void ArmBatch::resize(int n) {
+	count = n;
+	size_t padded = (size_t)((n + ArmBatchLanes - 1) / ArmBatchLanes) * ArmBatchLanes;
+	baseX.resize(padded, 0.0f);
+	baseY.resize(padded, 0.0f);
+	baseZ.resize(padded, 0.0f);
+	topRotate.resize(padded, 0.0f);
+	arm1Rotate.resize(padded, 0.0f);
+	arm2Rotate.resize(padded, 0.0f);
+	penRotateLongitude.resize(padded, 0.0f);
+	penRotateLatitude.resize(padded, 0.0f);
+	penRotateAxis.resize(padded, 0.0f);
+	for (int link = 0; link < NUM_ARM_LINKS; link++)
+		for (int e = 0; e < 12; e++)
+			links[link][e].resize(padded, 0.0f);
+	tipX.resize(padded, 0.0f);
+	tipY.resize(padded, 0.0f);
+	tipZ.resize(padded, 0.0f);
+}
+
+void ArmBatch::setArm(int arm, const ArmJoints & joints) {
+	baseX[arm] = joints.baseTranslate.x;
+	baseY[arm] = joints.baseTranslate.y;
+	baseZ[arm] = joints.baseTranslate.z;
+	topRotate[arm] = joints.topRotate;
+	arm1Rotate[arm] = joints.arm1Rotate;
+	arm2Rotate[arm] = joints.arm2Rotate;
+	penRotateLongitude[arm] = joints.penRotateLongitude;
+	penRotateLatitude[arm] = joints.penRotateLatitude;
+	penRotateAxis[arm] = joints.penRotateAxis;
+}
+
+ArmJoints ArmBatch::getArm(int arm) const {
+	ArmJoints joints;
+	joints.baseTranslate = glm::vec3(baseX[arm], baseY[arm], baseZ[arm]);
+	joints.topRotate = topRotate[arm];
+	joints.arm1Rotate = arm1Rotate[arm];
+	joints.arm2Rotate = arm2Rotate[arm];
+	joints.penRotateLongitude = penRotateLongitude[arm];
+	joints.penRotateLatitude = penRotateLatitude[arm];
+	joints.penRotateAxis = penRotateAxis[arm];
+	return joints;
+}
+
+glm::mat4 ArmBatch::getLinkMatrix(int arm, int link) const {
+	glm::mat4 m(1.0f);
+	for (int col = 0; col < 4; col++)
+		for (int row = 0; row < 3; row++)
+			m[col][row] = links[link][col * 3 + row][arm];
+	return m;
+}
+
+glm::vec3 ArmBatch::getPenTip(int arm) const {
+	return glm::vec3(tipX[arm], tipY[arm], tipZ[arm]);
+}
+
+void computeArmBatchReference(ArmBatch & batch, int begin, int end) {
+	KinematicChain chain;
+	buildRobotArmChain(chain);
+
+	for (int arm = begin; arm < end; arm++) {
+		setRobotArmJoints(chain, batch.getArm(arm));
+		chain.update();
+		for (int link = 0; link < NUM_ARM_LINKS; link++) {
+			const glm::mat4 & m = chain.getWorldMatrix(link);
+			for (int col = 0; col < 4; col++)
+				for (int row = 0; row < 3; row++)
+					batch.links[link][col * 3 + row][arm] = m[col][row];
+		}
+		glm::vec4 tip = chain.getWorldMatrix(LINK_PEN) * glm::vec4(PenTipOffset, 1.0f);
+		batch.tipX[arm] = tip.x;
+		batch.tipY[arm] = tip.y;
+		batch.tipZ[arm] = tip.z;
+	}
+}
+
+//-- SIMD KERNEL --//
+
+// The kernel is written once against the lane interface of simdlanes.hpp and instantiated
+// for AVX2 (8 lanes), SSE4.1 (4 lanes) and plain floats (1 lane).
+
+// sin and cos of x: reduction to [-pi/4, pi/4] around the nearest multiple of pi/2
+// (three-part Cody-Waite constant) and the Cephes single precision polynomials.
+template <class V>
+inline void sinCos(typename V::T x, typename V::T & s, typename V::T & c) {
+	typedef typename V::T T;
+	T j = V::round(V::mul(x, V::set(0.636619772f)));	// x / (pi/2)
+	T r = V::sub(x, V::mul(j, V::set(1.5703125f)));
+	r = V::sub(r, V::mul(j, V::set(4.837512969970703125e-4f)));
+	r = V::sub(r, V::mul(j, V::set(7.54978995489188216e-8f)));
+	T r2 = V::mul(r, r);
+
+	T ps = V::madd(r2, V::set(-1.9515295891e-4f), V::set(8.3321608736e-3f));
+	ps = V::madd(ps, r2, V::set(-1.6666654611e-1f));
+	ps = V::madd(V::mul(ps, r2), r, r);
+
+	T pc = V::madd(r2, V::set(2.443315711809948e-5f), V::set(-1.388731625493765e-3f));
+	pc = V::madd(pc, r2, V::set(4.166664568298827e-2f));
+	pc = V::madd(V::mul(pc, r2), r2, V::sub(V::set(1.0f), V::mul(r2, V::set(0.5f))));
+
+	// Quadrant q = j mod 4 picks which polynomial goes where and the signs
+	T q = V::sub(j, V::mul(V::floor(V::mul(j, V::set(0.25f))), V::set(4.0f)));
+	T odd = V::orMask(V::cmpeq(q, V::set(1.0f)), V::cmpeq(q, V::set(3.0f)));
+	T sinNeg = V::cmpge(q, V::set(2.0f));
+	T cosNeg = V::orMask(V::cmpeq(q, V::set(1.0f)), V::cmpeq(q, V::set(2.0f)));
+
+	T sv = V::select(odd, pc, ps);
+	T cv = V::select(odd, ps, pc);
+	s = V::select(sinNeg, V::neg(sv), sv);
+	c = V::select(cosNeg, V::neg(cv), cv);
+}
+
+// 3x4 affine matrix, one arm per lane: m[col * 3 + row]
+template <class V>
+struct Affine {
+	typename V::T m[12];
+};
+
+template <class V>
+inline void translate(Affine<V> & a, float x, float y, float z) {
+	for (int row = 0; row < 3; row++) {
+		typename V::T t = a.m[9 + row];
+		if (x != 0.0f) t = V::madd(a.m[row], V::set(x), t);
+		if (y != 0.0f) t = V::madd(a.m[3 + row], V::set(y), t);
+		if (z != 0.0f) t = V::madd(a.m[6 + row], V::set(z), t);
+		a.m[9 + row] = t;
+	}
+}
+
+// a = a * R, where R rotates about local axis 'axis' (0 = X, 1 = Y, 2 = Z) like glm::rotate
+template <class V>
+inline void rotate(Affine<V> & a, int axis, typename V::T c, typename V::T s) {
+	// Columns mixed by each rotation: X mixes (1, 2), Y mixes (2, 0), Z mixes (0, 1)
+	const int u = (axis + 1) % 3, w = (axis + 2) % 3;
+	for (int row = 0; row < 3; row++) {
+		typename V::T cu = a.m[u * 3 + row], cw = a.m[w * 3 + row];
+		a.m[u * 3 + row] = V::add(V::mul(cu, c), V::mul(cw, s));
+		a.m[w * 3 + row] = V::sub(V::mul(cw, c), V::mul(cu, s));
+	}
+}
+
+template <class V>
+inline void storeLink(ArmBatch & batch, int link, int arm, const Affine<V> & a) {
+	for (int e = 0; e < 12; e++)
+		V::store(&batch.links[link][e][arm], a.m[e]);
+}
+
+template <class V>
+void computeArmBatchKernel(ArmBatch & batch, int begin, int end) {
+	typedef typename V::T T;
+	// Joint angles go through degrees() before glm::rotate (see jointRotation)
+	const T toRadians = V::set(57.295779513f);
+
+	for (int arm = begin; arm < end; arm += V::Width) {
+		Affine<V> a;
+		for (int e = 0; e < 12; e++)
+			a.m[e] = V::set((e % 4 == 0) ? 1.0f : 0.0f);	// identity in the 3x3 part
+		a.m[9] = V::load(&batch.baseX[arm]);
+		a.m[10] = V::load(&batch.baseY[arm]);
+		a.m[11] = V::load(&batch.baseZ[arm]);
+		storeLink(batch, LINK_BASE, arm, a);
+
+		T s, c;
+		translate(a, TopOffset.x, TopOffset.y, TopOffset.z);
+		sinCos<V>(V::mul(V::load(&batch.topRotate[arm]), toRadians), s, c);
+		rotate(a, 1, c, s);
+		storeLink(batch, LINK_TOP, arm, a);
+
+		translate(a, Arm1Offset.x, Arm1Offset.y, Arm1Offset.z);
+		sinCos<V>(V::mul(V::load(&batch.arm1Rotate[arm]), toRadians), s, c);
+		rotate(a, 0, c, s);
+		storeLink(batch, LINK_ARM1, arm, a);
+
+		translate(a, JointOffset.x, JointOffset.y, JointOffset.z);
+		storeLink(batch, LINK_JOINT, arm, a);
+
+		sinCos<V>(V::mul(V::load(&batch.arm2Rotate[arm]), toRadians), s, c);
+		rotate(a, 0, c, s);
+		storeLink(batch, LINK_ARM2, arm, a);
+
+		translate(a, PenOffset.x, PenOffset.y, PenOffset.z);
+		sinCos<V>(V::mul(V::load(&batch.penRotateLongitude[arm]), toRadians), s, c);
+		rotate(a, 2, c, s);
+		sinCos<V>(V::mul(V::load(&batch.penRotateLatitude[arm]), toRadians), s, c);
+		rotate(a, 0, c, s);
+		sinCos<V>(V::mul(V::load(&batch.penRotateAxis[arm]), toRadians), s, c);
+		rotate(a, 1, c, s);
+		storeLink(batch, LINK_PEN, arm, a);
+
+		Affine<V> tip = a;
+		translate(tip, PenTipOffset.x, PenTipOffset.y, PenTipOffset.z);
+		V::store(&batch.tipX[arm], tip.m[9]);
+		V::store(&batch.tipY[arm], tip.m[10]);
+		V::store(&batch.tipZ[arm], tip.m[11]);
+
+		translate(a, ButtonOffset.x, ButtonOffset.y, ButtonOffset.z);
+		storeLink(batch, LINK_BUTTON, arm, a);
+	}
+}
+
+void computeArmBatch(ArmBatch & batch, int begin, int end) {
+	// Arrays are padded, so rounding the end up to a full vector is always in bounds
+	end = ((end + ArmBatchLanes - 1) / ArmBatchLanes) * ArmBatchLanes;
+#if defined(__AVX2__)
+	computeArmBatchKernel<AvxLanes>(batch, begin, end);
+#elif defined(__SSE4_1__) || defined(__AVX__)
+	computeArmBatchKernel<SseLanes>(batch, begin, end);
+#else
+	computeArmBatchKernel<ScalarLanes>(batch, begin, end);
+#endif
+}
+
+const char * armBatchKernelName(void) {
+#if defined(__AVX2__)
+	return "AVX2";
+#elif defined(__SSE4_1__) || defined(__AVX__)
+	return "SSE4.1";
+#else
+	return "scalar";
+#endif
+}
+
+ArmJoints cellArmJoints(int arm, int numArms, float cellTime) {
+	const int side = (int)ceil(sqrt((float)numArms));
+	const float phase = cellTime + arm * 0.37f;
+	ArmJoints joints;
+	joints.baseTranslate = glm::vec3((arm % side) * CellSpacing, 0.0f, -(arm / side) * CellSpacing);
+	joints.topRotate = 0.01f * phase;
+	joints.arm1Rotate = 0.006f * sinf(phase);
+	joints.arm2Rotate = -0.008f + 0.005f * sinf(1.3f * phase);
+	joints.penRotateLongitude = 0.01f * sinf(0.7f * phase);
+	joints.penRotateLatitude = 0.005f * cosf(phase);
+	joints.penRotateAxis = 0.02f * phase;
+	return joints;
+}
+
+void buildArmCell(ArmBatch & batch, int numArms, float cellTime) {
+	batch.resize(numArms);
+	for (int arm = 0; arm < numArms; arm++)
+		batch.setArm(arm, cellArmJoints(arm, numArms, cellTime));
+	computeArmBatch(batch, 0, numArms);
+}
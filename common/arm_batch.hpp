@@ -0,0 +1,59 @@
+#ifndef ARM_BATCH_HPP
+#define ARM_BATCH_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "kinematics.hpp"
+
+// Joint state and forward kinematics results of many arms in structure-of-arrays layout.
+// Arrays are padded to a multiple of ArmBatchLanes so the SIMD kernels never need a scalar tail.
+const int ArmBatchLanes = 8;
+
+struct ArmBatch {
+	int count;
+
+	// Joint state, one entry per arm (J0..J6)
+	std::vector<float> baseX, baseY, baseZ;
+	std::vector<float> topRotate;
+	std::vector<float> arm1Rotate;
+	std::vector<float> arm2Rotate;
+	std::vector<float> penRotateLongitude;
+	std::vector<float> penRotateLatitude;
+	std::vector<float> penRotateAxis;
+
+	// World matrix of every link as a 3x4 affine matrix: element [col * 3 + row]
+	std::vector<float> links[NUM_ARM_LINKS][12];
+	// World position of the pen tip
+	std::vector<float> tipX, tipY, tipZ;
+
+	ArmBatch() : count(0) {}
+
+	void resize(int n);
+	void setArm(int arm, const ArmJoints & joints);
+	ArmJoints getArm(int arm) const;
+	glm::mat4 getLinkMatrix(int arm, int link) const;
+	glm::vec3 getPenTip(int arm) const;
+};
+
+// Computes the links and pen tip of arms [begin, end) with the widest kernel this
+// build supports (AVX2, then SSE4.1, then scalar lanes). begin must be a multiple of ArmBatchLanes.
+void computeArmBatch(ArmBatch & batch, int begin, int end);
+
+// Reference path: the same results through glm, one arm at a time
+void computeArmBatchReference(ArmBatch & batch, int begin, int end);
+
+// Name of the kernel computeArmBatch() dispatches to
+const char * armBatchKernelName(void);
+
+// The work cell of the demo's --arms: numArms arms on a square grid along +x and -z,
+// CellSpacing apart, each at its own point of one canned motion
+const float CellSpacing = 4.0f;
+
+// Joint state of one arm of the cell, cellTime seconds into the motion
+ArmJoints cellArmJoints(int arm, int numArms, float cellTime);
+
+// Fills batch with the whole cell at cellTime and computes its links
+void buildArmCell(ArmBatch & batch, int numArms, float cellTime);
+
+#endif
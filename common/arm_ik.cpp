@@ -0,0 +1,243 @@
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <functional>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+using namespace glm;
+
+#include "quaternion_utils.hpp"
+#include "arm_ik.hpp"
+
+// Link lengths of buildRobotArmChain(): the arm1 pivot above the base, arm1 up to the
+// arm2 pivot, arm2 up to the pen
+const float ShoulderHeight = TopOffset.y + Arm1Offset.y;
+const float Arm1Length = JointOffset.y;
+const float Arm2Length = PenOffset.y;
+const float Pi = 3.14159265358979f;
+
+// The chain turns each joint by degrees(angle) radians (see jointRotation), so the solvers
+// work in actual radians and convert at the edges
+static float toRadians(float jointAngle) {
+	return glm::degrees(jointAngle);
+}
+
+static float toJointAngle(float radians) {
+	return glm::radians(radians);
+}
+
+// Into (-pi, pi]
+static float wrapAngle(float a) {
+	return a - 2.0f * Pi * floorf((a + Pi) / (2.0f * Pi));
+}
+
+// Axis * angle of a rotation, taking the short way round
+static glm::vec3 rotationVector(glm::quat q) {
+	if (q.w < 0.0f)
+		q = q * -1.0f;
+	const glm::vec3 v(q.x, q.y, q.z);
+	const float s = glm::length(v);
+	if (s < 1e-7f)
+		return v * 2.0f;
+	return v * (2.0f * atan2f(s, q.w) / s);
+}
+
+PenPose penPose(const ArmJoints & joints) {
+	const glm::vec3 X(1.0f, 0.0f, 0.0f), Y(0.0f, 1.0f, 0.0f), Z(0.0f, 0.0f, 1.0f);
+	glm::mat4 m = glm::translate(glm::mat4(1.0f), joints.baseTranslate + TopOffset);
+	m = m * jointRotation(joints.topRotate, Y);
+	m = glm::translate(m, Arm1Offset) * jointRotation(joints.arm1Rotate, X);
+	m = glm::translate(m, JointOffset) * jointRotation(joints.arm2Rotate, X);
+	m = glm::translate(m, PenOffset);
+	m = m * jointRotation(joints.penRotateLongitude, Z) * jointRotation(joints.penRotateLatitude, X) *
+		jointRotation(joints.penRotateAxis, Y);
+
+	PenPose pose;
+	pose.position = glm::vec3(m * glm::vec4(PenTipOffset, 1.0f));
+	pose.orientation = glm::normalize(glm::quat_cast(glm::mat3(m)));
+	return pose;
+}
+
+glm::quat penOrientation(glm::vec3 direction, glm::vec3 up) {
+	// Pen +Y onto +Z (its +Z goes to -Y), then LookAt takes +Z along direction and +Y towards
+	// -up, which leaves the button side facing up
+	const glm::quat penToForward = RotationBetweenVectors(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	return glm::normalize(LookAt(glm::normalize(direction), -up) * penToForward);
+}
+
+bool solveArmPosition(glm::vec3 wrist, ArmJoints & joints) {
+	const glm::vec3 d = wrist - (joints.baseTranslate + glm::vec3(0.0f, ShoulderHeight, 0.0f));
+	const float horizontal = sqrtf(d.x * d.x + d.z * d.z);
+	float cosElbow = (horizontal * horizontal + d.y * d.y - Arm1Length * Arm1Length - Arm2Length * Arm2Length) /
+		(2.0f * Arm1Length * Arm2Length);
+	const bool reachable = cosElbow >= -1.0f - 1e-5f && cosElbow <= 1.0f + 1e-5f;
+	cosElbow = std::min(std::max(cosElbow, -1.0f), 1.0f);
+	const float elbow = acosf(cosElbow);
+
+	const float top = toRadians(joints.topRotate);
+	const float arm1 = toRadians(joints.arm1Rotate);
+	const float arm2 = toRadians(joints.arm2Rotate);
+	// Straight above the shoulder any heading works: keep the current one
+	const float heading = horizontal > 1e-6f ? atan2f(d.x, d.z) : top;
+
+	// Arm1 and arm2 swing in the top's YZ plane, angles measured from +Y towards +Z
+	float bestCost = 1e30f;
+	float bestTop = top, bestArm1 = arm1, bestArm2 = arm2;
+	for (int facing = 0; facing < 2; facing++) {
+		const float t1 = top + wrapAngle((facing == 0 ? heading : heading + Pi) - top);
+		const float reach = facing == 0 ? horizontal : -horizontal;
+		for (int bend = 0; bend < 2; bend++) {
+			const float t3 = bend == 0 ? elbow : -elbow;
+			const float t2 = arm1 + wrapAngle(atan2f(reach, d.y) - atan2f(Arm2Length * sinf(t3), Arm1Length + Arm2Length * cosf(t3)) - arm1);
+			const float cost = (t1 - top) * (t1 - top) + (t2 - arm1) * (t2 - arm1) + (t3 - arm2) * (t3 - arm2);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestTop = t1;
+				bestArm1 = t2;
+				bestArm2 = t3;
+			}
+		}
+	}
+	joints.topRotate = toJointAngle(bestTop);
+	joints.arm1Rotate = toJointAngle(bestArm1);
+	joints.arm2Rotate = toJointAngle(bestArm2);
+	return reachable;
+}
+
+// Orientation error of the wrist at the given J4-J6 angles, as a world space rotation vector
+static glm::vec3 wristError(const glm::quat & arm, const glm::quat & target, const float angles[3]) {
+	const glm::quat current = arm * glm::angleAxis(angles[0], glm::vec3(0.0f, 0.0f, 1.0f)) *
+		glm::angleAxis(angles[1], glm::vec3(1.0f, 0.0f, 0.0f)) * glm::angleAxis(angles[2], glm::vec3(0.0f, 1.0f, 0.0f));
+	return rotationVector(target * glm::inverse(current));
+}
+
+int solveWristOrientation(const glm::quat & orientation, ArmJoints & joints, const IKSettings & settings,
+	float & error) {
+	const glm::vec3 X(1.0f, 0.0f, 0.0f), Y(0.0f, 1.0f, 0.0f), Z(0.0f, 0.0f, 1.0f);
+	const glm::quat target = glm::normalize(orientation);
+	// Frame the wrist hangs from: top about Y, then arm1 and arm2 about X
+	const glm::quat arm = glm::angleAxis(toRadians(joints.topRotate), Y) *
+		glm::angleAxis(toRadians(joints.arm1Rotate) + toRadians(joints.arm2Rotate), X);
+	float angles[3] = { toRadians(joints.penRotateLongitude), toRadians(joints.penRotateLatitude),
+		toRadians(joints.penRotateAxis) };
+
+	// Levenberg-Marquardt style: a step that makes the error worse is dropped and retried with
+	// more damping, a good one lets the damping back down to settings.damping
+	float lambda = settings.damping;
+	glm::vec3 e = wristError(arm, target, angles);
+	error = glm::length(e);
+	int iteration = 0;
+	for (; iteration < settings.maxIterations && error > settings.tolerance; iteration++) {
+		// Columns: world axis of each wrist rotation. step = J^T (J J^T + lambda^2 I)^-1 e
+		const glm::quat longitude = arm * glm::angleAxis(angles[0], Z);
+		const glm::quat latitude = longitude * glm::angleAxis(angles[1], X);
+		const glm::mat3 J(arm * Z, longitude * X, latitude * Y);
+		const glm::mat3 JT = glm::transpose(J);
+		glm::mat3 A = J * JT;
+		for (int i = 0; i < 3; i++)
+			A[i][i] += lambda * lambda;
+		const glm::vec3 step = JT * (glm::inverse(A) * e);
+
+		const float next[3] = { angles[0] + step[0], angles[1] + step[1], angles[2] + step[2] };
+		const glm::vec3 nextError = wristError(arm, target, next);
+		if (glm::length(nextError) < error) {
+			for (int i = 0; i < 3; i++)
+				angles[i] = next[i];
+			e = nextError;
+			error = glm::length(e);
+			lambda = std::max(lambda * 0.5f, settings.damping);
+		}
+		else {
+			lambda *= 4.0f;
+		}
+	}
+	joints.penRotateLongitude = toJointAngle(angles[0]);
+	joints.penRotateLatitude = toJointAngle(angles[1]);
+	joints.penRotateAxis = toJointAngle(angles[2]);
+	return iteration;
+}
+
+IKResult solvePenIK(const PenPose & target, ArmJoints & joints, const IKSettings & settings) {
+	IKResult result;
+	const glm::quat orientation = glm::normalize(target.orientation);
+	// The tip offset lies along the twist axis, so the wrist centre only depends on the pose
+	const glm::vec3 wrist = target.position - orientation * PenTipOffset;
+	result.reachable = solveArmPosition(wrist, joints);
+	result.iterations = solveWristOrientation(orientation, joints, settings, result.orientationError);
+	result.positionError = glm::length(penPose(joints).position - target.position);
+	result.converged = result.reachable && result.orientationError <= settings.tolerance;
+	return result;
+}
+
+// Same solution up to the solver's accuracy
+static bool sameJoints(const ArmJoints & a, const ArmJoints & b) {
+	const float eps = 1e-3f;
+	return fabsf(toRadians(a.topRotate - b.topRotate)) < eps && fabsf(toRadians(a.arm1Rotate - b.arm1Rotate)) < eps &&
+		fabsf(toRadians(a.arm2Rotate - b.arm2Rotate)) < eps &&
+		fabsf(toRadians(a.penRotateLongitude - b.penRotateLongitude)) < eps &&
+		fabsf(toRadians(a.penRotateLatitude - b.penRotateLatitude)) < eps &&
+		fabsf(toRadians(a.penRotateAxis - b.penRotateAxis)) < eps;
+}
+
+// targets[begin, end) in order, each from the one before, the first from joints
+static void solvePathRun(const PenPose * targets, size_t begin, size_t end, ArmJoints joints, ArmJoints * out,
+	IKResult * results, const IKSettings & settings) {
+	for (size_t i = begin; i < end; i++) {
+		results[i] = solvePenIK(targets[i], joints, settings);
+		out[i] = joints;
+	}
+}
+
+// One run from its head, for ThreadPool::parallelForChunks()
+static void solvePathChunk(const PenPose * targets, size_t count, const ArmJoints * heads, ArmJoints * out,
+	IKResult * results, const IKSettings * settings, size_t chunk) {
+	solvePathRun(targets, chunk * IKPathChunk, std::min(count, (chunk + 1) * IKPathChunk), heads[chunk], out, results,
+		*settings);
+}
+
+size_t solvePenIKPath(const PenPose * targets, size_t count, const ArmJoints & seed, ArmJoints * joints,
+	ThreadPool * pool, const IKSettings & settings, IKResult * results) {
+	std::vector<IKResult> scratch;
+	if (results == NULL) {
+		scratch.resize(count);
+		results = scratch.data();
+	}
+	const size_t chunks = (count + IKPathChunk - 1) / IKPathChunk;
+	if (pool == NULL || pool->size() <= 1 || chunks <= 1) {
+		solvePathRun(targets, 0, count, seed, joints, results, settings);
+	}
+	else {
+		// Seed every run from the first waypoint solved from the previous run's first waypoint:
+		// one serial solve per run, and the runs mostly start on the branch the path is on
+		std::vector<ArmJoints> heads(chunks);
+		ArmJoints head = seed;
+		for (size_t c = 0; c < chunks; c++) {
+			solvePenIK(targets[c * IKPathChunk], head, settings);
+			heads[c] = head;
+		}
+
+		// Runs go to whichever worker asks next, so a slow run does not hold the others up
+		pool->parallelForChunks(chunks, std::bind(solvePathChunk, targets, count, heads.data(), joints, results,
+			&settings, std::placeholders::_1));
+
+		// Stitch: a run may still start on another branch (or 2 pi away) from where its
+		// neighbour ended. Carry the neighbour's solution forward until the two agree.
+		for (size_t c = 1; c < chunks; c++) {
+			ArmJoints current = joints[c * IKPathChunk - 1];
+			for (size_t i = c * IKPathChunk; i < count; i++) {
+				results[i] = solvePenIK(targets[i], current, settings);
+				const bool agrees = sameJoints(current, joints[i]);
+				joints[i] = current;
+				if (agrees)
+					break;
+			}
+		}
+	}
+
+	size_t converged = 0;
+	for (size_t i = 0; i < count; i++)
+		converged += results[i].converged;
+	return converged;
+}
@@ -0,0 +1,66 @@
+#ifndef ARM_IK_HPP
+#define ARM_IK_HPP
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "kinematics.hpp"
+#include "threadpool.hpp"
+
+// Pose of the pen: tip position and pen frame orientation, world space.
+// The pen points along its local +Y, the button sits on its +Z side.
+struct PenPose {
+	glm::vec3 position;
+	glm::quat orientation;
+};
+
+struct IKSettings {
+	int maxIterations;      // damped least squares steps on the wrist
+	float damping;          // lambda: larger is steadier near singularities, slower to converge
+	float tolerance;        // orientation error to stop at, radians
+
+	IKSettings() : maxIterations(32), damping(0.05f), tolerance(1e-4f) {}
+};
+
+struct IKResult {
+	bool converged;         // reachable and the orientation got within tolerance
+	bool reachable;         // the wrist is within reach of arm1 + arm2
+	int iterations;
+	float positionError;    // tip distance to the target
+	float orientationError; // radians
+};
+
+// Tip pose of an arm state, as the KinematicChain built by buildRobotArmChain() places it
+PenPose penPose(const ArmJoints & joints);
+
+// Orientation pointing the pen along direction with its button side towards up (from LookAt).
+// up must not be parallel to direction.
+glm::quat penOrientation(glm::vec3 direction, glm::vec3 up);
+
+// Analytic J1-J3: puts the wrist (origin of the pen link) at wrist, keeping J0. Of the four
+// solutions (turned towards or away from the target, elbow either way) takes the one closest
+// to the current angles. Out of reach, stretches towards the target and returns false.
+bool solveArmPosition(glm::vec3 wrist, ArmJoints & joints);
+
+// J4-J6 by damped least squares on the orientation error, from the current angles.
+// Returns the iterations run; error gets the remaining orientation error in radians.
+int solveWristOrientation(const glm::quat & orientation, ArmJoints & joints, const IKSettings & settings,
+	float & error);
+
+// Pen tip to target: the wrist centre follows from the pose, J1-J3 are solved analytically,
+// then J4-J6 iteratively. joints holds the starting guess (and J0) and receives the solution.
+IKResult solvePenIK(const PenPose & target, ArmJoints & joints, const IKSettings & settings = IKSettings());
+
+// Waypoints solved per chunk by solvePenIKPath()
+const size_t IKPathChunk = 256;
+
+// IK for a path of count targets into joints[0, count), each solve warm started from the
+// previous waypoint's solution so the joints move continuously (seed starts the first one).
+// With a pool, workers take IKPathChunk-long runs off a shared counter, each seeded from a
+// solve of its first waypoint; a serial pass then re-solves the head of every run from its
+// neighbour until it lands where the run already was. Waits on the whole pool: do not call from one of its
+// tasks. results, when not NULL, gets count entries. Returns how many converged.
+size_t solvePenIKPath(const PenPose * targets, size_t count, const ArmJoints & seed, ArmJoints * joints,
+	ThreadPool * pool = NULL, const IKSettings & settings = IKSettings(), IKResult * results = NULL);
+
+#endif
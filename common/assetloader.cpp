@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "objparser.hpp"
+#include "vboindexer.hpp"
+#include "meshcache.hpp"
+#include "meshsimplify.hpp"
+#include "assetloader.hpp"
+
+bool loadIndexedMesh(
+	const char * path,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<unsigned int> & out_indices,
+	std::vector<MeshLod> & out_lods
+){
+	if (loadMeshCache(path, out_vertices, out_normals, out_indices, out_lods))
+		return true;
+
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> normals;
+	if (!parseOBJ(path, vertices, uvs, normals))
+		return false;
+	indexVBO(vertices, normals, out_indices, out_vertices, out_normals);
+	// Simplifying costs far more than parsing, so the levels are cached with the mesh
+	if (!out_vertices.empty()) {
+		glm::vec3 boxMin = out_vertices[0], boxMax = out_vertices[0];
+		for (size_t i = 1; i < out_vertices.size(); i++) {
+			boxMin = glm::min(boxMin, out_vertices[i]);
+			boxMax = glm::max(boxMax, out_vertices[i]);
+		}
+		buildMeshLods(out_vertices, out_normals, out_indices, LodMaxError * glm::length(boxMax - boxMin), out_lods);
+	}
+	if (!saveMeshCache(path, out_vertices, out_normals, out_indices, out_lods))
+		printf("Could not write %s\n", meshCachePath(path).c_str());
+	return true;
+}
+
+AssetLoader::AssetLoader() : numOutstanding(0) {
+}
+
+void AssetLoader::start(int numThreads) {
+	pool.start(numThreads);
+}
+
+void AssetLoader::stop(void) {
+	pool.stop();
+	std::lock_guard<std::mutex> lock(mutex);
+	completed.clear();
+	numOutstanding = 0;
+}
+
+void AssetLoader::request(const char * path, int id) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		numOutstanding++;
+	}
+	pool.submit(std::bind(&AssetLoader::load, this, std::string(path), id));
+}
+
+void AssetLoader::load(const std::string & path, int id) {
+	LoadedMesh mesh;
+	mesh.id = id;
+	mesh.path = path;
+	mesh.ok = loadIndexedMesh(path.c_str(), mesh.vertices, mesh.normals, mesh.indices, mesh.lods);
+
+	// The BVH wants the triangle soup back
+	std::vector<glm::vec3> triangles(mesh.indices.size());
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+		triangles[i] = mesh.vertices[mesh.indices[i]];
+	mesh.bvh.build(triangles);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		completed.push_back(std::move(mesh));
+	}
+	meshReady.notify_one();
+}
+
+bool AssetLoader::poll(LoadedMesh & out_mesh) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (completed.empty())
+		return false;
+	out_mesh = std::move(completed.front());
+	completed.pop_front();
+	numOutstanding--;
+	return true;
+}
+
+bool AssetLoader::waitNext(LoadedMesh & out_mesh) {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (completed.empty() && numOutstanding > 0)
+		meshReady.wait(lock);
+	if (completed.empty())
+		return false;
+	out_mesh = std::move(completed.front());
+	completed.pop_front();
+	numOutstanding--;
+	return true;
+}
+
+int AssetLoader::outstanding(void) {
+	std::lock_guard<std::mutex> lock(mutex);
+	return numOutstanding;
+}
@@ -0,0 +1,68 @@
+#ifndef ASSETLOADER_HPP
+#define ASSETLOADER_HPP
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <glm/glm.hpp>
+
+#include "threadpool.hpp"
+#include "bvh.hpp"
+#include "meshsimplify.hpp"
+
+// Indexed mesh as it comes out of a worker, ready to be uploaded
+struct LoadedMesh {
+	int id;             // whatever the caller passed to request()
+	std::string path;
+	bool ok;
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec3> normals;
+	std::vector<unsigned int> indices;
+	MeshBVH bvh;        // over the triangles, in model space
+	std::vector<MeshLod> lods;  // coarser index lists over the same vertices, see buildMeshLods()
+};
+
+// Maps the mesh cache of an .obj when it is current, otherwise parses and indexes the
+// .obj, builds its levels of detail and writes the cache. Safe to call from several threads.
+bool loadIndexedMesh(
+	const char * path,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<unsigned int> & out_indices,
+	std::vector<MeshLod> & out_lods
+);
+
+// Parses, indexes and builds the BVH and the levels of detail of meshes on a thread pool.
+// Finished meshes go to a completion queue that the GL thread drains, so only the upload
+// happens on that thread.
+class AssetLoader {
+public:
+	AssetLoader();
+
+	void start(int numThreads);
+	// Waits for the requests in flight; their results are dropped
+	void stop(void);
+
+	void request(const char * path, int id);
+
+	// Pops a finished mesh. Never waits.
+	bool poll(LoadedMesh & out_mesh);
+	// Waits for the next finished mesh. Returns false once nothing is outstanding.
+	bool waitNext(LoadedMesh & out_mesh);
+
+	// Requested meshes not yet popped
+	int outstanding(void);
+
+private:
+	void load(const std::string & path, int id);
+
+	ThreadPool pool;
+	std::mutex mutex;
+	std::condition_variable meshReady;
+	std::deque<LoadedMesh> completed;
+	int numOutstanding;
+};
+
+#endif
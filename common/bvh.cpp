@@ -0,0 +1,204 @@
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+#include <glm/glm.hpp>
+
+#include "bvh.hpp"
+
+// Leaves stop splitting at this many triangles
+const int MaxLeafTriangles = 4;
+
+void MeshBVH::build(const std::vector<glm::vec3> & triangleVertices) {
+	nodes.clear();
+	triangles.clear();
+	maxDepth = 0;
+
+	const int numTriangles = (int)(triangleVertices.size() / 3);
+	if (numTriangles == 0)
+		return;
+
+	std::vector<glm::vec3> centroids(numTriangles);
+	triangles.resize(numTriangles);
+	for (int i = 0; i < numTriangles; i++) {
+		const glm::vec3 & a = triangleVertices[3 * i];
+		const glm::vec3 & b = triangleVertices[3 * i + 1];
+		const glm::vec3 & c = triangleVertices[3 * i + 2];
+		triangles[i].v0 = a;
+		triangles[i].e1 = b - a;
+		triangles[i].e2 = c - a;
+		triangles[i].original = i;
+		centroids[i] = (a + b + c) / 3.0f;
+	}
+
+	// A binary tree over n leaves never needs more than 2n - 1 nodes
+	nodes.reserve(2 * numTriangles);
+	Node root;
+	root.first = 0;
+	root.count = numTriangles;
+	nodes.push_back(root);
+	updateBounds(0);
+	subdivide(0, 0, centroids);
+}
+
+void MeshBVH::updateBounds(int node) {
+	Node & n = nodes[node];
+	n.min = glm::vec3(FLT_MAX);
+	n.max = glm::vec3(-FLT_MAX);
+	for (int i = n.first; i < n.first + n.count; i++) {
+		const Triangle & tri = triangles[i];
+		glm::vec3 b = tri.v0 + tri.e1, c = tri.v0 + tri.e2;
+		n.min = glm::min(n.min, glm::min(tri.v0, glm::min(b, c)));
+		n.max = glm::max(n.max, glm::max(tri.v0, glm::max(b, c)));
+	}
+}
+
+void MeshBVH::subdivide(int node, int depth, std::vector<glm::vec3> & centroids) {
+	maxDepth = std::max(maxDepth, depth);
+	if (nodes[node].count <= MaxLeafTriangles)
+		return;
+
+	// Split the centroid bounds in the middle of their longest axis
+	glm::vec3 cmin(FLT_MAX), cmax(-FLT_MAX);
+	const int first = nodes[node].first, count = nodes[node].count;
+	for (int i = first; i < first + count; i++) {
+		cmin = glm::min(cmin, centroids[i]);
+		cmax = glm::max(cmax, centroids[i]);
+	}
+	glm::vec3 extent = cmax - cmin;
+	int axis = 0;
+	if (extent.y > extent.x) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+	if (extent[axis] <= 0.0f)
+		return;	// all centroids coincide, keep as a leaf
+	float split = cmin[axis] + extent[axis] * 0.5f;
+
+	int i = first, j = first + count - 1;
+	while (i <= j) {
+		if (centroids[i][axis] < split) {
+			i++;
+		}
+		else {
+			std::swap(centroids[i], centroids[j]);
+			std::swap(triangles[i], triangles[j]);
+			j--;
+		}
+	}
+	int leftCount = i - first;
+	if (leftCount == 0 || leftCount == count)
+		return;
+
+	int left = (int)nodes.size();
+	Node child;
+	child.first = first;
+	child.count = leftCount;
+	nodes.push_back(child);
+	child.first = i;
+	child.count = count - leftCount;
+	nodes.push_back(child);
+
+	nodes[node].first = left;
+	nodes[node].count = 0;
+	updateBounds(left);
+	updateBounds(left + 1);
+	subdivide(left, depth + 1, centroids);
+	subdivide(left + 1, depth + 1, centroids);
+}
+
+// Slab test; returns the entry distance or FLT_MAX on a miss
+static inline float intersectBox(const glm::vec3 & origin, const glm::vec3 & invDir,
+	const glm::vec3 & bmin, const glm::vec3 & bmax, float maxT) {
+	glm::vec3 t0 = (bmin - origin) * invDir;
+	glm::vec3 t1 = (bmax - origin) * invDir;
+	glm::vec3 tmin = glm::min(t0, t1), tmax = glm::max(t0, t1);
+	float enter = glm::max(glm::max(tmin.x, tmin.y), glm::max(tmin.z, 0.0f));
+	float exit = glm::min(glm::min(tmax.x, tmax.y), glm::min(tmax.z, maxT));
+	return enter <= exit ? enter : FLT_MAX;
+}
+
+bool MeshBVH::intersect(const glm::vec3 & origin, const glm::vec3 & direction, float maxT, RayHit & hit) const {
+	if (nodes.empty())
+		return false;
+
+	const glm::vec3 invDir = glm::vec3(1.0f) / direction;
+	float bestT = maxT;
+	int bestTriangle = -1;
+
+	// Each level leaves at most one farther child waiting, so maxDepth + 1 entries always do.
+	// Degenerate trees deeper than the fixed stack get one on the heap.
+	int fixedStack[64];
+	std::vector<int> heapStack;
+	int * stack = fixedStack;
+	if (maxDepth + 1 > 64) {
+		heapStack.resize(maxDepth + 1);
+		stack = &heapStack[0];
+	}
+	int stackSize = 0;
+	if (intersectBox(origin, invDir, nodes[0].min, nodes[0].max, bestT) == FLT_MAX)
+		return false;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const Node & n = nodes[stack[--stackSize]];
+
+		if (n.count > 0) {
+			// Moller-Trumbore ray/triangle test, two-sided
+			for (int i = n.first; i < n.first + n.count; i++) {
+				const Triangle & tri = triangles[i];
+				glm::vec3 p = glm::cross(direction, tri.e2);
+				float det = glm::dot(tri.e1, p);
+				if (glm::abs(det) < 1e-12f)
+					continue;
+				float invDet = 1.0f / det;
+				glm::vec3 s = origin - tri.v0;
+				float u = glm::dot(s, p) * invDet;
+				if (u < 0.0f || u > 1.0f)
+					continue;
+				glm::vec3 q = glm::cross(s, tri.e1);
+				float v = glm::dot(direction, q) * invDet;
+				if (v < 0.0f || u + v > 1.0f)
+					continue;
+				float t = glm::dot(tri.e2, q) * invDet;
+				if (t > 0.0f && t < bestT) {
+					bestT = t;
+					bestTriangle = tri.original;
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first so farther boxes get culled by bestT
+		int left = n.first, right = n.first + 1;
+		float tl = intersectBox(origin, invDir, nodes[left].min, nodes[left].max, bestT);
+		float tr = intersectBox(origin, invDir, nodes[right].min, nodes[right].max, bestT);
+		if (tl > tr) {
+			std::swap(tl, tr);
+			std::swap(left, right);
+		}
+		if (tr != FLT_MAX)
+			stack[stackSize++] = right;
+		if (tl != FLT_MAX)
+			stack[stackSize++] = left;
+	}
+
+	if (bestTriangle < 0)
+		return false;
+	hit.t = bestT;
+	hit.triangle = bestTriangle;
+	hit.point = origin + direction * bestT;
+	return true;
+}
+
+void screenPointToRay(double xpos, double ypos, int width, int height,
+	const glm::mat4 & projection, const glm::mat4 & view,
+	glm::vec3 & out_origin, glm::vec3 & out_direction) {
+	// Window coordinates have (0,0) on top, normalized device coordinates on the bottom
+	float x = 2.0f * (float)(xpos + 0.5) / width - 1.0f;
+	float y = 1.0f - 2.0f * (float)(ypos + 0.5) / height;
+
+	glm::mat4 inverseVP = glm::inverse(projection * view);
+	glm::vec4 nearPoint = inverseVP * glm::vec4(x, y, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseVP * glm::vec4(x, y, 1.0f, 1.0f);
+	out_origin = glm::vec3(nearPoint) / nearPoint.w;
+	out_direction = glm::vec3(farPoint) / farPoint.w - out_origin;
+}
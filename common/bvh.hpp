@@ -0,0 +1,54 @@
+#ifndef BVH_HPP
+#define BVH_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+struct RayHit {
+	float t;        // distance along the (unnormalized) ray direction
+	int triangle;   // index into the triangle list the BVH was built from
+	glm::vec3 point;
+};
+
+// Bounding volume hierarchy over the triangles of one mesh, for CPU ray casts in model space
+class MeshBVH {
+public:
+	// triangleVertices holds 3 consecutive vertices per triangle, as returned by loadOBJ()
+	void build(const std::vector<glm::vec3> & triangleVertices);
+
+	// Nearest hit with t in (0, maxT]. The direction does not need to be normalized, so a
+	// ray transformed into model space by an affine matrix keeps the same t as in world space.
+	bool intersect(const glm::vec3 & origin, const glm::vec3 & direction, float maxT, RayHit & hit) const;
+
+	bool empty() const { return nodes.empty(); }
+	int nodeCount() const { return (int)nodes.size(); }
+	glm::vec3 getMin() const { return nodes.empty() ? glm::vec3(0.0f) : nodes[0].min; }
+	glm::vec3 getMax() const { return nodes.empty() ? glm::vec3(0.0f) : nodes[0].max; }
+
+private:
+	struct Node {
+		glm::vec3 min;
+		int first;      // first triangle (leaf) or left child (inner node)
+		glm::vec3 max;
+		int count;      // triangles in a leaf, 0 for inner nodes
+	};
+	// Stored as v0 plus the two edges used by the Moller-Trumbore test
+	struct Triangle {
+		glm::vec3 v0, e1, e2;
+		int original;
+	};
+
+	void subdivide(int node, int depth, std::vector<glm::vec3> & centroids);
+	void updateBounds(int node);
+
+	std::vector<Node> nodes;
+	std::vector<Triangle> triangles;
+	int maxDepth;       // levels below the root, sizes the traversal stack
+};
+
+// Ray through a window pixel (origin at (0,0) top left, like glfwGetCursorPos) in world space
+void screenPointToRay(double xpos, double ypos, int width, int height,
+	const glm::mat4 & projection, const glm::mat4 & view,
+	glm::vec3 & out_origin, glm::vec3 & out_direction);
+
+#endif
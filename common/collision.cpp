@@ -0,0 +1,461 @@
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <float.h>
+#include <math.h>
+
+#include <glm/glm.hpp>
+
+#include "collision.hpp"
+
+static bool lessPoint(const glm::vec3 & a, const glm::vec3 & b) {
+	if (a.x != b.x)
+		return a.x < b.x;
+	if (a.y != b.y)
+		return a.y < b.y;
+	return a.z < b.z;
+}
+
+void ConvexShape::build(const std::vector<glm::vec3> & vertices) {
+	// Indexed meshes repeat a position once per normal; one copy is enough for the support
+	points = vertices;
+	std::sort(points.begin(), points.end(), lessPoint);
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+	min = max = points.empty() ? glm::vec3(0.0f) : points[0];
+	for (size_t i = 1; i < points.size(); i++) {
+		min = glm::min(min, points[i]);
+		max = glm::max(max, points[i]);
+	}
+}
+
+glm::vec3 ConvexShape::support(const glm::vec3 & direction) const {
+	int best = 0;
+	float bestDot = glm::dot(points[0], direction);
+	for (int i = 1; i < (int)points.size(); i++) {
+		const float d = glm::dot(points[i], direction);
+		if (d > bestDot) {
+			bestDot = d;
+			best = i;
+		}
+	}
+	return points[best];
+}
+
+// GJK works on the Minkowski difference a - b: the shapes overlap when it holds the origin
+static glm::vec3 minkowskiSupport(const PlacedShape & a, const PlacedShape & b, const glm::vec3 & direction) {
+	return a.support(direction) - b.support(-direction);
+}
+
+struct Simplex {
+	glm::vec3 p[4];
+	int count;
+};
+
+// Closest point to the origin on triangle abc (Ericson's Voronoi region tests). The simplex is
+// cut down to the feature it lies on.
+static glm::vec3 closestOnTriangle(Simplex & s, const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) {
+	const glm::vec3 ab = b - a, ac = c - a;
+	const float d1 = -glm::dot(ab, a), d2 = -glm::dot(ac, a);
+	if (d1 <= 0.0f && d2 <= 0.0f) {
+		s.p[0] = a;
+		s.count = 1;
+		return a;
+	}
+	const float d3 = -glm::dot(ab, b), d4 = -glm::dot(ac, b);
+	if (d3 >= 0.0f && d4 <= d3) {
+		s.p[0] = b;
+		s.count = 1;
+		return b;
+	}
+	const float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		s.p[0] = a;
+		s.p[1] = b;
+		s.count = 2;
+		return a + ab * (d1 / (d1 - d3));
+	}
+	const float d5 = -glm::dot(ab, c), d6 = -glm::dot(ac, c);
+	if (d6 >= 0.0f && d5 <= d6) {
+		s.p[0] = c;
+		s.count = 1;
+		return c;
+	}
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		s.p[0] = a;
+		s.p[1] = c;
+		s.count = 2;
+		return a + ac * (d2 / (d2 - d6));
+	}
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+		s.p[0] = b;
+		s.p[1] = c;
+		s.count = 2;
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	}
+	s.p[0] = a;
+	s.p[1] = b;
+	s.p[2] = c;
+	s.count = 3;
+	const float denominator = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// Closest point to the origin on the simplex, which keeps only the points needed to express
+// it. Returns false when the origin is inside the tetrahedron.
+static bool closestOnSimplex(Simplex & s, glm::vec3 & closest) {
+	if (s.count == 1) {
+		closest = s.p[0];
+	}
+	else if (s.count == 2) {
+		const glm::vec3 a = s.p[0], ab = s.p[1] - s.p[0];
+		const float t = -glm::dot(a, ab);
+		if (t <= 0.0f) {
+			s.count = 1;
+			closest = a;
+		}
+		else if (t >= glm::dot(ab, ab)) {
+			s.p[0] = s.p[1];
+			s.count = 1;
+			closest = s.p[0];
+		}
+		else {
+			closest = a + ab * (t / glm::dot(ab, ab));
+		}
+	}
+	else if (s.count == 3) {
+		closest = closestOnTriangle(s, s.p[0], s.p[1], s.p[2]);
+	}
+	else {
+		// Nearest of the faces the origin is outside of; none means it is inside
+		const Simplex tetrahedron = s;
+		const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+		float best = FLT_MAX;
+		for (int f = 0; f < 4; f++) {
+			const glm::vec3 a = tetrahedron.p[faces[f][0]], b = tetrahedron.p[faces[f][1]];
+			const glm::vec3 c = tetrahedron.p[faces[f][2]], d = tetrahedron.p[faces[f][3]];
+			const glm::vec3 n = glm::cross(b - a, c - a);
+			if (glm::dot(n, -a) * glm::dot(n, d - a) > 0.0f)
+				continue;
+			Simplex face;
+			const glm::vec3 point = closestOnTriangle(face, a, b, c);
+			if (glm::dot(point, point) < best) {
+				best = glm::dot(point, point);
+				closest = point;
+				s = face;
+			}
+		}
+		if (best == FLT_MAX)
+			return false;
+	}
+	return true;
+}
+
+// Distance GJK: walks the simplex towards the origin until it encloses it, or a support point
+// shows the origin outside a - b, or the distance stops shrinking. Leaves the last simplex in s.
+static bool gjk(const PlacedShape & a, const PlacedShape & b, Simplex & s) {
+	glm::vec3 v = a.translation - b.translation;
+	if (glm::dot(v, v) < 1e-12f)
+		v = glm::vec3(1.0f, 0.0f, 0.0f);
+	s.p[0] = minkowskiSupport(a, b, v);
+	s.count = 1;
+	v = s.p[0];
+	for (int iteration = 0; iteration < 64; iteration++) {
+		const float distance2 = glm::dot(v, v);
+		// The origin is on the simplex: touching, or too close to tell
+		if (distance2 < 1e-12f)
+			return true;
+		const glm::vec3 w = minkowskiSupport(a, b, -v);
+		// A separating axis, or no more progress towards the origin
+		if (glm::dot(w, v) > 0.0f || distance2 - glm::dot(v, w) <= 1e-6f * distance2)
+			return false;
+		s.p[s.count++] = w;
+		if (!closestOnSimplex(s, v))
+			return true;
+	}
+	return glm::dot(v, v) < 1e-8f;
+}
+
+bool shapesIntersect(const PlacedShape & a, const PlacedShape & b) {
+	Simplex s;
+	return gjk(a, b, s);
+}
+
+// EPA: grows the GJK tetrahedron towards the boundary of a - b until the face nearest the
+// origin is on it. Faces are wound counter-clockwise seen from outside.
+const int MaxEPAVertices = 64;
+const int MaxEPAFaces = 2 * MaxEPAVertices;
+
+struct EPAFace {
+	int v[3];
+	glm::vec3 normal;
+	float distance;
+};
+
+static void setFace(EPAFace & face, const glm::vec3 * vertices, int a, int b, int c) {
+	face.v[0] = a;
+	face.v[1] = b;
+	face.v[2] = c;
+	const glm::vec3 n = glm::cross(vertices[b] - vertices[a], vertices[c] - vertices[a]);
+	const float length = glm::length(n);
+	if (length < 1e-12f) {
+		// Sliver: never the nearest face, never visible
+		face.normal = glm::vec3(0.0f);
+		face.distance = FLT_MAX;
+		return;
+	}
+	face.normal = n / length;
+	face.distance = glm::dot(face.normal, vertices[a]);
+}
+
+static void epa(const PlacedShape & a, const PlacedShape & b, const Simplex & s, float & depth, glm::vec3 & normal) {
+	glm::vec3 vertices[MaxEPAVertices];
+	EPAFace faces[MaxEPAFaces];
+	for (int i = 0; i < 4; i++)
+		vertices[i] = s.p[i];
+	int numVertices = 4, numFaces = 0;
+
+	const glm::vec3 centre = 0.25f * (vertices[0] + vertices[1] + vertices[2] + vertices[3]);
+	const int start[4][3] = { { 0, 1, 2 }, { 0, 2, 3 }, { 0, 3, 1 }, { 1, 3, 2 } };
+	for (int f = 0; f < 4; f++) {
+		setFace(faces[numFaces], vertices, start[f][0], start[f][1], start[f][2]);
+		if (glm::dot(faces[numFaces].normal, vertices[start[f][0]] - centre) < 0.0f)
+			setFace(faces[numFaces], vertices, start[f][0], start[f][2], start[f][1]);
+		numFaces++;
+	}
+
+	while (numFaces > 0) {
+		int nearest = 0;
+		for (int f = 1; f < numFaces; f++)
+			if (faces[f].distance < faces[nearest].distance)
+				nearest = f;
+		const glm::vec3 n = faces[nearest].normal;
+		// The origin leaves a - b along n when a moves by -n
+		depth = std::max(faces[nearest].distance, 0.0f);
+		normal = -n;
+		const glm::vec3 p = minkowskiSupport(a, b, n);
+		if (glm::dot(p, n) - faces[nearest].distance < 1e-4f || numVertices == MaxEPAVertices)
+			return;
+
+		// Drop the faces p sees; the edges they share with the faces left are the horizon. A face
+		// p lies in the plane of goes too, or the new face on their shared edge folds over it.
+		int horizon[MaxEPAFaces * 3][2];
+		int numEdges = 0;
+		for (int f = 0; f < numFaces; ) {
+			if (glm::dot(faces[f].normal, p - vertices[faces[f].v[0]]) <= -1e-5f) {
+				f++;
+				continue;
+			}
+			for (int e = 0; e < 3; e++) {
+				const int from = faces[f].v[e], to = faces[f].v[(e + 1) % 3];
+				int shared = -1;
+				for (int h = 0; h < numEdges; h++)
+					if (horizon[h][0] == to && horizon[h][1] == from)
+						shared = h;
+				if (shared >= 0) {
+					horizon[shared][0] = horizon[numEdges - 1][0];
+					horizon[shared][1] = horizon[numEdges - 1][1];
+					numEdges--;
+				}
+				else {
+					horizon[numEdges][0] = from;
+					horizon[numEdges][1] = to;
+					numEdges++;
+				}
+			}
+			faces[f] = faces[--numFaces];
+		}
+		if (numFaces + numEdges > MaxEPAFaces)
+			return;
+
+		vertices[numVertices] = p;
+		for (int h = 0; h < numEdges; h++)
+			setFace(faces[numFaces++], vertices, horizon[h][0], horizon[h][1], numVertices);
+		numVertices++;
+	}
+}
+
+// GJK can stop with the origin on a point, edge or face of the simplex. EPA needs a
+// tetrahedron around it: add support points off the simplex until there is one.
+static bool growToTetrahedron(const PlacedShape & a, const PlacedShape & b, Simplex & s) {
+	const glm::vec3 axes[3] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+	if (s.count == 1) {
+		for (int i = 0; i < 6 && s.count == 1; i++) {
+			const glm::vec3 w = minkowskiSupport(a, b, i < 3 ? axes[i] : -axes[i - 3]);
+			if (glm::length(w - s.p[0]) > 1e-5f)
+				s.p[s.count++] = w;
+		}
+	}
+	if (s.count == 2) {
+		// Around the edge in 60 degree steps, starting off its least aligned axis
+		const glm::vec3 edge = glm::normalize(s.p[1] - s.p[0]);
+		int least = 0;
+		for (int i = 1; i < 3; i++)
+			if (fabsf(edge[i]) < fabsf(edge[least]))
+				least = i;
+		const glm::vec3 u = glm::normalize(glm::cross(edge, axes[least]));
+		const glm::vec3 v = glm::cross(edge, u);
+		for (int i = 0; i < 6 && s.count == 2; i++) {
+			const float angle = i * 1.04719755f;
+			const glm::vec3 w = minkowskiSupport(a, b, cosf(angle) * u + sinf(angle) * v);
+			if (glm::length(glm::cross(w - s.p[0], edge)) > 1e-5f)
+				s.p[s.count++] = w;
+		}
+	}
+	if (s.count == 3) {
+		const glm::vec3 n = glm::normalize(glm::cross(s.p[1] - s.p[0], s.p[2] - s.p[0]));
+		glm::vec3 w = minkowskiSupport(a, b, n);
+		if (fabsf(glm::dot(w - s.p[0], n)) <= 1e-5f)
+			w = minkowskiSupport(a, b, -n);
+		if (fabsf(glm::dot(w - s.p[0], n)) > 1e-5f)
+			s.p[s.count++] = w;
+	}
+	return s.count == 4;
+}
+
+bool shapesPenetration(const PlacedShape & a, const PlacedShape & b, float & depth, glm::vec3 & normal) {
+	Simplex s;
+	if (!gjk(a, b, s))
+		return false;
+	if (s.count < 4 && !growToTetrahedron(a, b, s)) {
+		// a - b is flat: the shapes only touch
+		depth = 0.0f;
+		normal = a.translation - b.translation;
+		normal = glm::dot(normal, normal) > 1e-12f ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+		return true;
+	}
+	epa(a, b, s, depth, normal);
+	return true;
+}
+
+ArmCollider::ArmCollider() {
+	for (int i = 0; i < NUM_ARM_LINKS; i++)
+		for (int j = 0; j < NUM_ARM_LINKS; j++)
+			pairChecked[i][j] = false;
+}
+
+void ArmCollider::setLinkShape(int link, const std::vector<glm::vec3> & vertices) {
+	shapes[link].build(vertices);
+	updatePairs();
+}
+
+void ArmCollider::updatePairs(void) {
+	glm::mat4 links[NUM_ARM_LINKS];
+	computeRobotArmLinks(ArmJoints(), links);
+	for (int i = 0; i < NUM_ARM_LINKS; i++) {
+		pairChecked[i][i] = false;
+		for (int j = i + 1; j < NUM_ARM_LINKS; j++) {
+			bool checked = false;
+			if (!shapes[i].empty() && !shapes[j].empty()) {
+				const PlacedShape a = { &shapes[i], glm::mat3(links[i]), glm::vec3(links[i][3]) };
+				const PlacedShape b = { &shapes[j], glm::mat3(links[j]), glm::vec3(links[j][3]) };
+				checked = !shapesIntersect(a, b);
+			}
+			pairChecked[i][j] = pairChecked[j][i] = checked;
+		}
+	}
+}
+
+bool ArmCollider::checkConfiguration(const ArmJoints & joints) const {
+	return check(joints, NULL, 1) > 0;
+}
+
+int ArmCollider::checkConfiguration(const ArmJoints & joints, CollisionContact * contacts, int maxContacts) const {
+	return maxContacts > 0 ? check(joints, contacts, maxContacts) : 0;
+}
+
+// Without contacts, stops at the first collision and skips EPA
+int ArmCollider::check(const ArmJoints & joints, CollisionContact * contacts, int maxContacts) const {
+	glm::mat4 links[NUM_ARM_LINKS];
+	computeRobotArmLinks(joints, links);
+
+	// Broad phase: world AABB of each link from its model space box
+	PlacedShape placed[NUM_ARM_LINKS];
+	glm::vec3 boxMin[NUM_ARM_LINKS], boxMax[NUM_ARM_LINKS];
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		if (shapes[link].empty())
+			continue;
+		placed[link].shape = &shapes[link];
+		placed[link].rotation = glm::mat3(links[link]);
+		placed[link].translation = glm::vec3(links[link][3]);
+		const glm::vec3 centre = 0.5f * (shapes[link].getMin() + shapes[link].getMax());
+		const glm::vec3 extent = 0.5f * (shapes[link].getMax() - shapes[link].getMin());
+		const glm::mat3 & r = placed[link].rotation;
+		glm::vec3 worldExtent;
+		for (int row = 0; row < 3; row++)
+			worldExtent[row] = fabsf(r[0][row]) * extent.x + fabsf(r[1][row]) * extent.y + fabsf(r[2][row]) * extent.z;
+		const glm::vec3 worldCentre = r * centre + placed[link].translation;
+		boxMin[link] = worldCentre - worldExtent;
+		boxMax[link] = worldCentre + worldExtent;
+	}
+
+	int found = 0;
+	// The base stands on the grid, everything else has to stay above it
+	for (int link = LINK_BASE + 1; link < NUM_ARM_LINKS; link++) {
+		if (shapes[link].empty() || boxMin[link].y >= 0.0f)
+			continue;
+		const float lowest = placed[link].support(glm::vec3(0.0f, -1.0f, 0.0f)).y;
+		if (lowest >= 0.0f)
+			continue;
+		if (contacts == NULL)
+			return 1;
+		CollisionContact & contact = contacts[found++];
+		contact.linkA = link;
+		contact.linkB = CollisionGround;
+		contact.depth = -lowest;
+		contact.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+		if (found == maxContacts)
+			return found;
+	}
+
+	for (int i = 0; i < NUM_ARM_LINKS; i++) {
+		for (int j = i + 1; j < NUM_ARM_LINKS; j++) {
+			if (!pairChecked[i][j])
+				continue;
+			if (boxMin[i].x > boxMax[j].x || boxMin[j].x > boxMax[i].x || boxMin[i].y > boxMax[j].y ||
+				boxMin[j].y > boxMax[i].y || boxMin[i].z > boxMax[j].z || boxMin[j].z > boxMax[i].z)
+				continue;
+			if (contacts == NULL) {
+				if (shapesIntersect(placed[i], placed[j]))
+					return 1;
+				continue;
+			}
+			CollisionContact & contact = contacts[found];
+			if (!shapesPenetration(placed[i], placed[j], contact.depth, contact.normal))
+				continue;
+			contact.linkA = i;
+			contact.linkB = j;
+			if (++found == maxContacts)
+				return found;
+		}
+	}
+	return found;
+}
+
+// Samples per run handed to a pool worker by checkPath()
+const size_t CollisionPathChunk = 1024;
+
+// One run of samples, for ThreadPool::parallelForChunks()
+static void checkPathChunk(const ArmCollider * collider, const ArmJoints * joints, size_t count,
+	unsigned char * collides, size_t chunk) {
+	const size_t end = std::min(count, (chunk + 1) * CollisionPathChunk);
+	for (size_t i = chunk * CollisionPathChunk; i < end; i++)
+		collides[i] = collider->checkConfiguration(joints[i]) ? 1 : 0;
+}
+
+size_t ArmCollider::checkPath(const ArmJoints * joints, size_t count, unsigned char * collides, ThreadPool * pool) const {
+	const size_t chunks = (count + CollisionPathChunk - 1) / CollisionPathChunk;
+	if (pool == NULL) {
+		for (size_t c = 0; c < chunks; c++)
+			checkPathChunk(this, joints, count, collides, c);
+	}
+	else {
+		pool->parallelForChunks(chunks, std::bind(checkPathChunk, this, joints, count, collides, std::placeholders::_1));
+	}
+
+	size_t colliding = 0;
+	for (size_t i = 0; i < count; i++)
+		colliding += collides[i];
+	return colliding;
+}
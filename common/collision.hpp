@@ -0,0 +1,91 @@
+#ifndef COLLISION_HPP
+#define COLLISION_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "kinematics.hpp"
+#include "threadpool.hpp"
+
+// Convex hull of a part mesh, kept as the mesh's distinct vertices: GJK and EPA only ask for
+// support points, and the support point of a point set is always a vertex of its hull.
+class ConvexShape {
+public:
+	void build(const std::vector<glm::vec3> & vertices);
+
+	// Point furthest along direction, model space
+	glm::vec3 support(const glm::vec3 & direction) const;
+
+	bool empty() const { return points.empty(); }
+	int size() const { return (int)points.size(); }
+	glm::vec3 getMin() const { return min; }
+	glm::vec3 getMax() const { return max; }
+
+private:
+	std::vector<glm::vec3> points;
+	glm::vec3 min, max;
+};
+
+// A convex shape placed in the world by a rigid transform
+struct PlacedShape {
+	const ConvexShape * shape;
+	glm::mat3 rotation;
+	glm::vec3 translation;
+
+	glm::vec3 support(const glm::vec3 & direction) const {
+		return rotation * shape->support(glm::transpose(rotation) * direction) + translation;
+	}
+};
+
+// GJK: true when the two shapes overlap (touching counts as apart)
+bool shapesIntersect(const PlacedShape & a, const PlacedShape & b);
+
+// GJK, then EPA on the overlap: false when apart, otherwise depth and normal give the
+// shortest move of a out of b (move a by normal * depth).
+bool shapesPenetration(const PlacedShape & a, const PlacedShape & b, float & depth, glm::vec3 & normal);
+
+// The grid plane the arm stands on
+const int CollisionGround = -1;
+
+struct CollisionContact {
+	int linkA;              // RobotArmLink
+	int linkB;              // RobotArmLink, or CollisionGround
+	float depth;
+	glm::vec3 normal;       // world space, moving linkA this way separates the two
+};
+
+// Self and ground collision of the robot arm, one convex shape per link.
+// Checked pairs are every pair of links that is apart in the rest pose (all joints 0): links
+// that already overlap there (a link and its parent, arm1 and arm2 at the elbow) touch by
+// construction at the joint between them. Every link but the base is checked against y = 0.
+// A configuration is checked by a broad phase over the links' world AABBs and GJK on the
+// pairs whose boxes overlap. Const methods are safe to call from several threads.
+class ArmCollider {
+public:
+	ArmCollider();
+
+	// Collision shape of a link from its mesh vertices (model space, as loaded). Links
+	// without a shape are left out of every check.
+	void setLinkShape(int link, const std::vector<glm::vec3> & vertices);
+	bool hasLinkShape(int link) const { return !shapes[link].empty(); }
+	bool isPairChecked(int linkA, int linkB) const { return pairChecked[linkA][linkB]; }
+
+	// True at the first collision found
+	bool checkConfiguration(const ArmJoints & joints) const;
+	// Every collision, with its penetration depth, up to maxContacts. Returns the number found.
+	int checkConfiguration(const ArmJoints & joints, CollisionContact * contacts, int maxContacts) const;
+
+	// Checks count arm states, e.g. the samples of a planned trajectory: collides[i] is set to 1
+	// when joints[i] collides, 0 otherwise. Split into runs across the pool when given (waits on
+	// the whole pool). Returns how many collide.
+	size_t checkPath(const ArmJoints * joints, size_t count, unsigned char * collides, ThreadPool * pool = NULL) const;
+
+private:
+	int check(const ArmJoints & joints, CollisionContact * contacts, int maxContacts) const;
+	void updatePairs(void);
+
+	ConvexShape shapes[NUM_ARM_LINKS];
+	bool pairChecked[NUM_ARM_LINKS][NUM_ARM_LINKS];
+};
+
+#endif
@@ -1,256 +1,202 @@
-// Include GLFW
-#include <iostream>
-#include <GLFW/glfw3.h>
-extern GLFWwindow* window; // The "extern" keyword here is to access the variable "window" declared in tutorialXXX.cpp. This is a hack to keep the tutorials simple. Please avoid this.
-
-// Include GLM
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-using namespace glm;
-
-#include "controls.hpp"
-
-glm::mat4 ViewMatrix;
-glm::mat4 ProjectionMatrix;
-
-/*
-// Initial position : on +Z
-glm::vec3 position = glm::vec3(0, 0, 5);
-// Initial horizontal angle : toward -Z
-float horizontalAngle = 3.14f;
-// Initial vertical angle : none
-float verticalAngle = 0.0f;
-// Initial Field of View
-float initialFoV = 45.0f;
-// Speeds
-float speed = 3.0f; // 3 units / second
-float mouseSpeed = 0.005f;
-*/
-
-const float r = 15.0f;
-float theta = radians(45.0f), phi = radians(45.0f);
-glm::vec3 position = glm::vec3(10.0f, 10.0f, 10.0f);
-glm::vec3 origin = glm::vec3(0.0f, 0.0f, 0.0f);
-glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
-
-glm::vec3 BaseTranslation;
-float TopRotation;
-float Arm1Rotation;
-float Arm2Rotation;
-float PenRotateLongitude;
-float PenRotateLatitude;
-float PenRotateAxis;
-float speed = 3.0f;
-
-glm::mat4 getViewMatrix(){
-	return ViewMatrix;
-}
-
-glm::mat4 getProjectionMatrix(){
-	return ProjectionMatrix;
-}
-
-glm::vec3 getCameraPosition() {
-	return position;
-}
-
-void computeMatricesFromInputs() {
-	/*
-	//--  GIVEN APPROACH --//
-
-	// glfwGetTime is called only once, the first time this function is called
-	static double lastTime = glfwGetTime();
-
-	// Compute time difference between current and last frame
-	double currentTime = glfwGetTime();
-	float deltaTime = float(currentTime - lastTime);
-
-	// Get mouse position
-	double xpos, ypos;
-	glfwGetCursorPos(window, &xpos, &ypos);
-
-	// Reset mouse position for next frame
-	glfwSetCursorPos(window, 1024/2, 768/2);
-
-	// Compute new orientation
-	horizontalAngle += mouseSpeed * float(1024/2 - xpos );
-	verticalAngle   += mouseSpeed * float( 768/2 - ypos );
-
-	// Direction : Spherical coordinates to Cartesian coordinates conversion
-	glm::vec3 direction(
-		cos(verticalAngle) * sin(horizontalAngle),
-		sin(verticalAngle),
-		cos(verticalAngle) * cos(horizontalAngle)
-	);
-
-	// Right vector
-	glm::vec3 right = glm::vec3(
-		sin(horizontalAngle - 3.14f/2.0f),
-		0,
-		cos(horizontalAngle - 3.14f/2.0f)
-	);
-
-	// Up vector : perpendicular to both direction and right
-	glm::vec3 up = glm::cross(right, direction);
-
-	// Move forward
-	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-		position += direction * deltaTime * speed;
-	}
-	// Move backward
-	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-		position -= direction * deltaTime * speed;
-	}
-	// Strafe right
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		position += right * deltaTime * speed;
-	}
-	// Strafe left
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		position -= right * deltaTime * speed;
-	}
-
-	float FoV = initialFoV;// - 5 * glfwGetMouseWheel(); // Now GLFW 3 requires setting up a callback for this. It's a bit too complicated for this beginner's tutorial, so it's disabled instead.
-
-	// Projection matrix : 45 Field of View, 4:3 ratio, display range : 0.1 unit <-> 100 units
-	ProjectionMatrix = glm::perspective(glm::radians(FoV), 4.0f / 3.0f, 0.1f, 100.0f);
-	// Camera matrix
-	ViewMatrix		 = glm::lookAt(
-								position,           // Camera is here
-								position + direction, // and looks here : at the same position, plus "direction"
-								up                  // Head is up (set to 0,-1,0 to look upside-down)
-	);
-
-	// For the next frame, the "last time" will be "now"
-	lastTime = currentTime;
-	*/
-
-	//--  MY APPROACH --//
-
-	// Generally...
-	// x = r * cos(latitudeAngle) * sin(longitudeAngle)
-	// y = r * cos(longitudeAngle)
-	// z = r * sin(latitudeAngle) * sin(longitudeAngle)
-
-	// Update the camera position according to the new axes orientations
-	position.x = r * cos(theta) * cos(phi);
-	position.y = r * sin(phi);
-	position.z = r * sin(theta) * cos(phi);
-
-	// If user presses arrow keys, update angles accordingly
-	// Some conditions to ensure camera does not flip weirdly
-	if (-1 * radians(360.0f) < theta && theta < radians(360.0f)) {
-		if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-			theta -= 0.0008f;
-		if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-			theta += 0.0008f;
-	}
-	else {
-		theta = 0.0f;
-	}
-	if (-1 * radians(90.0f) <= phi && phi <= radians(90.0f)) {
-		if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-			phi += 0.0008f;
-		if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-			phi -= 0.0008f;
-	}
-	else if (phi < -1 * radians(90.0f)) {
-		phi = -1 * radians(89.0f);
-	}
-	else if (phi > radians(90.0f)) {
-		phi = radians(89.0f);
-	}
-	//std::cout << "Theta: " << theta << ", Phi: " << phi << std::endl;
-
-	// Projection matrix : 45 Field of View, 4:3 ratio, display range : 0.1 unit <-> 100 units
-	ProjectionMatrix = glm::perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
-	// Camera matrix
-	ViewMatrix = glm::lookAt(
-		position, // Camera is here
-		origin, // and looks here
-		up // while head is up (set to 0,-1,0 to look upside-down)
-	);
-}
-
-glm::vec3 UpdateBaseTranslate() {
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		BaseTranslation.x += 0.0025;
-	}
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		BaseTranslation.x -= 0.0025;
-	}
-	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-		BaseTranslation.z -= 0.0025;
-	}
-	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-		BaseTranslation.z += 0.0025;
-	}
-
-	return BaseTranslation;
-}
-
-float UpdateTopRotate() {
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		TopRotation -= 0.0001;
-	}
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		TopRotation += 0.0001;
-	}
-
-	return TopRotation;
-}
-
-float UpdateArm1Rotate() {
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		Arm1Rotation -= 0.000075;
-	}
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		Arm1Rotation += 0.000075;
-	}
-
-	return Arm1Rotation;
-}
-
-float UpdateArm2Rotate() {
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		Arm2Rotation -= 0.000075;
-	}
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		Arm2Rotation += 0.000075;
-	}
-
-	return Arm2Rotation;
-}
-
-float UpdatePenLongitudeRotate() {
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		PenRotateLongitude -= 0.0001;
-	}
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		PenRotateLongitude += 0.0001;
-	}
-
-	return PenRotateLongitude;
-}
-
-float UpdatePenLatitudeRotate() {
-	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-		PenRotateLatitude -= 0.0001;
-	}
-	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-		PenRotateLatitude += 0.0001;
-	}
-
-	return PenRotateLatitude;
-}
-
-float UpdatePenAxisRotate() {
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-		PenRotateAxis -= 0.0001;
-	}
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-		PenRotateAxis += 0.0001;
-	}
-
-	return PenRotateAxis;
-}
+// Include GLFW
+#include <iostream>
+#include <GLFW/glfw3.h>
+extern GLFWwindow* window; // The "extern" keyword here is to access the variable "window" declared in tutorialXXX.cpp. This is a hack to keep the tutorials simple. Please avoid this.
+
+// Include GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+using namespace glm;
+
+#include "controls.hpp"
+
+glm::mat4 ViewMatrix;
+glm::mat4 ProjectionMatrix;
+
+/*
+// Initial position : on +Z
+glm::vec3 position = glm::vec3(0, 0, 5);
+// Initial horizontal angle : toward -Z
+float horizontalAngle = 3.14f;
+// Initial vertical angle : none
+float verticalAngle = 0.0f;
+// Initial Field of View
+float initialFoV = 45.0f;
+// Speeds
+float speed = 3.0f; // 3 units / second
+float mouseSpeed = 0.005f;
+*/
+
+const float r = 15.0f;
+float theta = radians(45.0f), phi = radians(45.0f);
+glm::vec3 position = glm::vec3(10.0f, 10.0f, 10.0f);
+glm::vec3 origin = glm::vec3(0.0f, 0.0f, 0.0f);
+glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+
+ControlConfig Config = {
+	{ 0.8f, 4.0f },         // camera, radians
+	{ 2.5f, 12.5f },        // base translation
+	{ 0.1f, 0.5f },         // top
+	{ 0.075f, 0.375f },     // arm1 and arm2
+	{ 0.1f, 0.5f },         // pen
+	1.0f
+};
+
+ControlConfig & getControlConfig() {
+	return Config;
+}
+
+ControlInput sampleControlInputs() {
+	ControlInput input;
+	if (window == NULL) {
+		return input;   // headless: nothing is held
+	}
+	input.left = glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS;
+	input.right = glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS;
+	input.up = glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS;
+	input.down = glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS;
+	return input;
+}
+
+float stepControlAxis(float value, float & velocity, int direction, const AxisLimits & limits, float speedScale, float dt) {
+	const float target = direction * limits.velocity * speedScale;
+	const float maxChange = limits.acceleration * speedScale * dt;
+	velocity += glm::clamp(target - velocity, -maxChange, maxChange);
+	return value + velocity * dt;
+}
+
+int controlDirection(bool negative, bool positive) {
+	return (positive ? 1 : 0) - (negative ? 1 : 0);
+}
+
+glm::mat4 getViewMatrix(){
+	return ViewMatrix;
+}
+
+glm::mat4 getProjectionMatrix(){
+	return ProjectionMatrix;
+}
+
+glm::vec3 getCameraPosition() {
+	return position;
+}
+
+glm::vec2 getCameraAngles() {
+	return glm::vec2(theta, phi);
+}
+
+void computeMatricesFromAngles(glm::vec2 angles) {
+	/*
+	//--  GIVEN APPROACH --//
+
+	// glfwGetTime is called only once, the first time this function is called
+	static double lastTime = glfwGetTime();
+
+	// Compute time difference between current and last frame
+	double currentTime = glfwGetTime();
+	float deltaTime = float(currentTime - lastTime);
+
+	// Get mouse position
+	double xpos, ypos;
+	glfwGetCursorPos(window, &xpos, &ypos);
+
+	// Reset mouse position for next frame
+	glfwSetCursorPos(window, 1024/2, 768/2);
+
+	// Compute new orientation
+	horizontalAngle += mouseSpeed * float(1024/2 - xpos );
+	verticalAngle   += mouseSpeed * float( 768/2 - ypos );
+
+	// Direction : Spherical coordinates to Cartesian coordinates conversion
+	glm::vec3 direction(
+		cos(verticalAngle) * sin(horizontalAngle),
+		sin(verticalAngle),
+		cos(verticalAngle) * cos(horizontalAngle)
+	);
+
+	// Right vector
+	glm::vec3 right = glm::vec3(
+		sin(horizontalAngle - 3.14f/2.0f),
+		0,
+		cos(horizontalAngle - 3.14f/2.0f)
+	);
+
+	// Up vector : perpendicular to both direction and right
+	glm::vec3 up = glm::cross(right, direction);
+
+	// Move forward
+	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
+		position += direction * deltaTime * speed;
+	}
+	// Move backward
+	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
+		position -= direction * deltaTime * speed;
+	}
+	// Strafe right
+	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+		position += right * deltaTime * speed;
+	}
+	// Strafe left
+	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+		position -= right * deltaTime * speed;
+	}
+
+	float FoV = initialFoV;// - 5 * glfwGetMouseWheel(); // Now GLFW 3 requires setting up a callback for this. It's a bit too complicated for this beginner's tutorial, so it's disabled instead.
+
+	// Projection matrix : 45 Field of View, 4:3 ratio, display range : 0.1 unit <-> 100 units
+	ProjectionMatrix = glm::perspective(glm::radians(FoV), 4.0f / 3.0f, 0.1f, 100.0f);
+	// Camera matrix
+	ViewMatrix		 = glm::lookAt(
+								position,           // Camera is here
+								position + direction, // and looks here : at the same position, plus "direction"
+								up                  // Head is up (set to 0,-1,0 to look upside-down)
+	);
+
+	// For the next frame, the "last time" will be "now"
+	lastTime = currentTime;
+	*/
+
+	//--  MY APPROACH --//
+
+	// Generally...
+	// x = r * cos(latitudeAngle) * sin(longitudeAngle)
+	// y = r * cos(longitudeAngle)
+	// z = r * sin(latitudeAngle) * sin(longitudeAngle)
+
+	// Update the camera position according to the new axes orientations
+	position.x = r * cos(angles.x) * cos(angles.y);
+	position.y = r * sin(angles.y);
+	position.z = r * sin(angles.x) * cos(angles.y);
+
+	// Projection matrix : 45 Field of View, 4:3 ratio, display range : 0.1 unit <-> 100 units
+	ProjectionMatrix = glm::perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+	// Camera matrix
+	ViewMatrix = glm::lookAt(
+		position, // Camera is here
+		origin, // and looks here
+		up // while head is up (set to 0,-1,0 to look upside-down)
+	);
+}
+
+void stepCameraAngles(glm::vec2 & angles, glm::vec2 & velocity, const ControlInput & input, float speedScale, float dt) {
+	// Some conditions to ensure camera does not flip weirdly
+	if (-1 * radians(360.0f) < angles.x && angles.x < radians(360.0f)) {
+		angles.x = stepControlAxis(angles.x, velocity.x, controlDirection(input.right, input.left), Config.camera, speedScale, dt);
+	}
+	else {
+		angles.x = 0.0f;
+		velocity.x = 0.0f;
+	}
+	if (-1 * radians(90.0f) <= angles.y && angles.y <= radians(90.0f)) {
+		angles.y = stepControlAxis(angles.y, velocity.y, controlDirection(input.down, input.up), Config.camera, speedScale, dt);
+	}
+	else if (angles.y < -1 * radians(90.0f)) {
+		angles.y = -1 * radians(89.0f);
+		velocity.y = 0.0f;
+	}
+	else if (angles.y > radians(90.0f)) {
+		angles.y = radians(89.0f);
+		velocity.y = 0.0f;
+	}
+	//std::cout << "Theta: " << angles.x << ", Phi: " << angles.y << std::endl;
+}
@@ -1,16 +1,53 @@
-#ifndef CONTROLS_HPP
-#define CONTROLS_HPP
-
-void computeMatricesFromInputs();
-glm::vec3 UpdateBaseTranslate();
-glm::vec3 getCameraPosition();
-float UpdateTopRotate();
-float UpdateArm1Rotate();
-float UpdateArm2Rotate();
-float UpdatePenLongitudeRotate();
-float UpdatePenLatitudeRotate();
-float UpdatePenAxisRotate();
-glm::mat4 getViewMatrix();
-glm::mat4 getProjectionMatrix();
-
-#endif
\ No newline at end of file
+#ifndef CONTROLS_HPP
+#define CONTROLS_HPP
+
+// The camera and the joints move in fixed simulation ticks, independent of the frame rate:
+// sampleControlInputs() reads the keys once per frame, and each tick stepControlAxis()
+// advances a joint by dt with its velocity ramped towards the held direction. The joints,
+// camera angles and velocities live in a SimState (simulation.hpp), stepped by stepSimulation().
+const float ControlTickSeconds = 1.0f / 120.0f;
+
+// Arrow keys held when the input was sampled
+struct ControlInput {
+	bool left, right, up, down;
+
+	ControlInput() : left(false), right(false), up(false), down(false) {}
+};
+
+// Top speed (units per second) and how fast it is reached or lost (units per second^2).
+// Rotations are in the joint angle units of ArmJoints, the camera in radians.
+struct AxisLimits {
+	float velocity;
+	float acceleration;
+};
+
+struct ControlConfig {
+	AxisLimits camera;
+	AxisLimits baseTranslate;
+	AxisLimits topRotate;
+	AxisLimits armRotate;
+	AxisLimits penRotate;
+	float speedScale;       // multiplies every velocity and acceleration
+};
+
+// Defaults match the old per-call steps at 1000 calls per second
+ControlConfig & getControlConfig();
+
+ControlInput sampleControlInputs();
+// -1, 0 or 1 from a pair of opposite keys
+int controlDirection(bool negative, bool positive);
+// One tick of one axis: ramps velocity towards direction (-1, 0 or 1) times the top speed,
+// then returns value moved by it. Speeds and accelerations are multiplied by speedScale.
+float stepControlAxis(float value, float & velocity, int direction, const AxisLimits & limits, float speedScale, float dt);
+// One tick of the orbit camera from its arrow keys: theta wraps to 0 past a full turn and
+// phi stays short of the poles
+void stepCameraAngles(glm::vec2 & angles, glm::vec2 & velocity, const ControlInput & input, float speedScale, float dt);
+// Orbit angles (theta, phi) the camera starts at
+glm::vec2 getCameraAngles();
+// Places the camera at the given orbit angles; the view matrix and camera position follow
+void computeMatricesFromAngles(glm::vec2 angles);
+glm::vec3 getCameraPosition();
+glm::mat4 getViewMatrix();
+glm::mat4 getProjectionMatrix();
+
+#endif
@@ -0,0 +1,123 @@
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "simdlanes.hpp"
+#include "frustum.hpp"
+
+MeshBounds computeMeshBounds(const std::vector<glm::vec3> & vertices) {
+	MeshBounds bounds;
+	bounds.boxMin = bounds.boxMax = bounds.center = glm::vec3(0.0f);
+	bounds.radius = -1.0f;
+	if (vertices.empty())
+		return bounds;
+
+	bounds.boxMin = bounds.boxMax = vertices[0];
+	for (size_t i = 1; i < vertices.size(); i++) {
+		bounds.boxMin = glm::min(bounds.boxMin, vertices[i]);
+		bounds.boxMax = glm::max(bounds.boxMax, vertices[i]);
+	}
+	bounds.center = 0.5f * (bounds.boxMin + bounds.boxMax);
+	float radius2 = 0.0f;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const glm::vec3 d = vertices[i] - bounds.center;
+		radius2 = std::max(radius2, glm::dot(d, d));
+	}
+	bounds.radius = sqrtf(radius2);
+	return bounds;
+}
+
+Frustum extractFrustum(const glm::mat4 & viewProjection) {
+	// Clip space keeps -w <= x, y, z <= w: each plane is the last row plus or minus another
+	Frustum frustum;
+	for (int i = 0; i < 3; i++) {
+		for (int side = 0; side < 2; side++) {
+			glm::vec4 & plane = frustum.planes[i * 2 + side];
+			for (int col = 0; col < 4; col++) {
+				plane[col] = side == 0 ? viewProjection[col][3] + viewProjection[col][i] :
+					viewProjection[col][3] - viewProjection[col][i];
+			}
+			plane = plane / glm::length(glm::vec3(plane));
+		}
+	}
+	return frustum;
+}
+
+bool boundsInFrustum(const Frustum & frustum, const MeshBounds & bounds, const glm::mat4 & model) {
+	if (bounds.radius < 0.0f)
+		return false;
+	const glm::mat3 turn(model);
+	const glm::vec3 sphereCenter = glm::vec3(model * glm::vec4(bounds.center, 1.0f));
+	// The box centre is the sphere centre; its world extents are the turned half sizes, made positive
+	const glm::vec3 half = 0.5f * (bounds.boxMax - bounds.boxMin);
+	glm::vec3 extent;
+	for (int row = 0; row < 3; row++)
+		extent[row] = fabsf(turn[0][row]) * half.x + fabsf(turn[1][row]) * half.y + fabsf(turn[2][row]) * half.z;
+
+	for (int i = 0; i < 6; i++) {
+		const glm::vec3 normal(frustum.planes[i]);
+		const float distance = glm::dot(normal, sphereCenter) + frustum.planes[i].w;
+		if (distance <= -bounds.radius || distance <= -glm::dot(glm::abs(normal), extent))
+			return false;
+	}
+	return true;
+}
+
+// V::Width arms a time. Masks are all ones (a NaN) or all zeros in the SIMD paths and 1 or 0
+// in the scalar one, so an arm is visible exactly when its "outside" mask compares equal to 0.
+template <class V>
+int cullArmBatchLinkKernel(const Frustum & frustum, const MeshBounds & bounds, const ArmBatch & batch, int link,
+	int begin, int end, unsigned char * visible) {
+	typedef typename V::T T;
+	const glm::vec3 half = 0.5f * (bounds.boxMax - bounds.boxMin);
+	const T minusRadius = V::set(-bounds.radius);
+	int count = 0;
+	for (int arm = begin; arm < end; arm += V::Width) {
+		T m[12];
+		for (int e = 0; e < 12; e++)
+			m[e] = V::load(&batch.links[link][e][arm]);
+		T center[3], extent[3];
+		for (int row = 0; row < 3; row++) {
+			center[row] = V::madd(m[row], V::set(bounds.center.x), m[9 + row]);
+			center[row] = V::madd(m[3 + row], V::set(bounds.center.y), center[row]);
+			center[row] = V::madd(m[6 + row], V::set(bounds.center.z), center[row]);
+			extent[row] = V::mul(V::abs(m[row]), V::set(half.x));
+			extent[row] = V::madd(V::abs(m[3 + row]), V::set(half.y), extent[row]);
+			extent[row] = V::madd(V::abs(m[6 + row]), V::set(half.z), extent[row]);
+		}
+
+		T outside = V::set(0.0f);
+		for (int i = 0; i < 6; i++) {
+			const glm::vec4 & plane = frustum.planes[i];
+			T distance = V::madd(center[0], V::set(plane.x), V::set(plane.w));
+			distance = V::madd(center[1], V::set(plane.y), distance);
+			distance = V::madd(center[2], V::set(plane.z), distance);
+			T reach = V::mul(extent[0], V::set(fabsf(plane.x)));
+			reach = V::madd(extent[1], V::set(fabsf(plane.y)), reach);
+			reach = V::madd(extent[2], V::set(fabsf(plane.z)), reach);
+			outside = V::orMask(outside, V::cmpge(minusRadius, distance));
+			outside = V::orMask(outside, V::cmpge(V::neg(reach), distance));
+		}
+
+		float mask[8];
+		V::store(mask, outside);
+		const int lanes = std::min((int)V::Width, end - arm);
+		for (int lane = 0; lane < lanes; lane++) {
+			visible[arm + lane] = mask[lane] == 0.0f ? 1 : 0;
+			count += visible[arm + lane];
+		}
+	}
+	return count;
+}
+
+int cullArmBatchLink(const Frustum & frustum, const MeshBounds & bounds, const ArmBatch & batch, int link, int begin,
+	int end, unsigned char * visible) {
+	if (bounds.radius < 0.0f) {
+		std::fill(visible + begin, visible + std::max(begin, end), (unsigned char)0);
+		return 0;
+	}
+	// The link arrays are padded, so full vectors past end stay in bounds
+	return cullArmBatchLinkKernel<BestLanes>(frustum, bounds, batch, link, begin, end, visible);
+}
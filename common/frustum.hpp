@@ -0,0 +1,37 @@
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "arm_batch.hpp"
+
+// Model space bounds of a mesh: its box, and a sphere around the box centre
+struct MeshBounds {
+	glm::vec3 boxMin, boxMax;
+	glm::vec3 center;
+	float radius;           // < 0 for a mesh without vertices
+};
+
+MeshBounds computeMeshBounds(const std::vector<glm::vec3> & vertices);
+
+// The six planes of a view frustum in world space, normalized so that dot(plane, (p, 1)) is the
+// distance of p inside the plane: left, right, bottom, top, near, far
+struct Frustum {
+	glm::vec4 planes[6];
+};
+
+Frustum extractFrustum(const glm::mat4 & viewProjection);
+
+// Whether a mesh placed by model (rotation and translation, like the arm's links) can be
+// in view: false when its sphere, or the world box around its turned box, is wholly outside
+// one of the planes. Bounds straddling a frustum corner can pass without being seen.
+bool boundsInFrustum(const Frustum & frustum, const MeshBounds & bounds, const glm::mat4 & model);
+
+// The same test for one link of arms [begin, end) of a batch, straight from its SoA link
+// matrices, with the widest kernel this build supports. Sets visible[arm] to 1 or 0 and
+// returns how many are visible. begin must be a multiple of ArmBatchLanes.
+int cullArmBatchLink(const Frustum & frustum, const MeshBounds & bounds, const ArmBatch & batch, int link, int begin,
+	int end, unsigned char * visible);
+
+#endif
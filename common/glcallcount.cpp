@@ -0,0 +1,3 @@
+#include "glcallcount.hpp"
+
+unsigned int gGLCallCount = 0;
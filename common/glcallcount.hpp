@@ -0,0 +1,22 @@
+#ifndef GLCALLCOUNT_HPP
+#define GLCALLCOUNT_HPP
+
+// Counts GL calls. GLEW reaches every entry point it loads (all of GL past 1.1) through
+// GLEW_GET_FUN, so including this header before <GL/glew.h> makes each such call in that
+// file bump gGLCallCount. The GL 1.1 functions (glClear, glDrawArrays, glReadPixels, ...)
+// are plain library exports and are not counted. Define NO_GL_CALL_COUNT to turn it off.
+extern unsigned int gGLCallCount;
+
+// A function, not a bare ++, so nested calls in one expression are not unsequenced
+inline void countGLCall(void) {
+	gGLCallCount++;
+}
+
+#ifndef NO_GL_CALL_COUNT
+#ifdef GLEW_GET_FUN
+#error "glcallcount.hpp has to be included before GL/glew.h"
+#endif
+#define GLEW_GET_FUN(x) (countGLCall(), x)
+#endif
+
+#endif
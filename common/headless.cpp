@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+
+#include <GL/glew.h>
+
+#if defined(HEADLESS_OSMESA)
+#include <GL/osmesa.h>
+#elif !defined(_WIN32)
+#define HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <GLFW/glfw3.h>
+
+#include "headless.hpp"
+
+#if defined(HEADLESS_EGL)
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+#elif defined(HEADLESS_OSMESA)
+static OSMesaContext osmesaContext = NULL;
+static std::vector<unsigned char> osmesaBuffer;
+#endif
+static GLFWwindow * hiddenWindow = NULL;
+
+// Initialize GLEW once a context is current. GLEW built for GLX reports a missing
+// X display under EGL even though every entry point was loaded.
+static int initGlew(void) {
+	glewExperimental = true; // Needed for core profile
+	GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	if (err == GLEW_ERROR_NO_GLX_DISPLAY)
+		err = GLEW_OK;
+#endif
+	if (err != GLEW_OK) {
+		fprintf(stderr, "Failed to initialize GLEW\n");
+		return -1;
+	}
+	// glewInit() can leave a GL_INVALID_ENUM behind on core profiles
+	glGetError();
+	return 0;
+}
+
+#if defined(HEADLESS_EGL)
+static int initEGL(int width, int height) {
+	// Prefer Mesa's surfaceless platform, it never touches X11 or a DRM device
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+	if (getPlatformDisplay != NULL)
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+#endif
+	if (eglDisplay == EGL_NO_DISPLAY)
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+		fprintf(stderr, "Failed to initialize EGL\n");
+		return -1;
+	}
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		fprintf(stderr, "EGL has no desktop OpenGL support\n");
+		return -1;
+	}
+
+	const EGLint configAttribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint numConfigs = 0;
+	if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+		// Surfaceless displays may expose no pbuffer configs; we render into an FBO anyway
+		const EGLint anyConfig[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+		if (!eglChooseConfig(eglDisplay, anyConfig, &config, 1, &numConfigs) || numConfigs == 0) {
+			fprintf(stderr, "No suitable EGL config\n");
+			return -1;
+		}
+	}
+
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+	if (eglContext == EGL_NO_CONTEXT) {
+		fprintf(stderr, "Failed to create an OpenGL 3.3 core EGL context\n");
+		return -1;
+	}
+
+	// Without EGL_KHR_surfaceless_context we need a (tiny) pbuffer to make the context current
+	if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+		const EGLint pbufferAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+		eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+		if (eglSurface == EGL_NO_SURFACE || !eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+			fprintf(stderr, "Failed to make the EGL context current\n");
+			return -1;
+		}
+	}
+	return 0;
+}
+#endif
+
+#if defined(HEADLESS_OSMESA)
+static int initOSMesa(int width, int height) {
+	const int attribs[] = {
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_DEPTH_BITS, 24,
+		OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+		OSMESA_CONTEXT_MAJOR_VERSION, 3,
+		OSMESA_CONTEXT_MINOR_VERSION, 3,
+		0
+	};
+	osmesaContext = OSMesaCreateContextAttribs(attribs, NULL);
+	if (osmesaContext == NULL) {
+		fprintf(stderr, "Failed to create an OSMesa context\n");
+		return -1;
+	}
+	osmesaBuffer.resize((size_t)width * height * 4);
+	if (!OSMesaMakeCurrent(osmesaContext, &osmesaBuffer[0], GL_UNSIGNED_BYTE, width, height)) {
+		fprintf(stderr, "Failed to make the OSMesa context current\n");
+		return -1;
+	}
+	return 0;
+}
+#endif
+
+static int initHiddenWindow(int width, int height) {
+	if (!glfwInit()) {
+		fprintf(stderr, "Failed to initialize GLFW\n");
+		return -1;
+	}
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	hiddenWindow = glfwCreateWindow(width, height, "headless", NULL, NULL);
+	if (hiddenWindow == NULL) {
+		fprintf(stderr, "Failed to open a hidden GLFW window\n");
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(hiddenWindow);
+	return 0;
+}
+
+int initHeadlessContext(int width, int height) {
+	int errorCode = -1;
+#if defined(HEADLESS_EGL)
+	errorCode = initEGL(width, height);
+#elif defined(HEADLESS_OSMESA)
+	errorCode = initOSMesa(width, height);
+#endif
+	if (errorCode != 0)
+		errorCode = initHiddenWindow(width, height);
+	if (errorCode != 0)
+		return errorCode;
+
+	printf("Headless renderer: %s (%s)\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+	return initGlew();
+}
+
+void cleanupHeadlessContext(void) {
+#if defined(HEADLESS_EGL)
+	if (eglDisplay != EGL_NO_DISPLAY) {
+		eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (eglSurface != EGL_NO_SURFACE)
+			eglDestroySurface(eglDisplay, eglSurface);
+		if (eglContext != EGL_NO_CONTEXT)
+			eglDestroyContext(eglDisplay, eglContext);
+		eglTerminate(eglDisplay);
+		eglDisplay = EGL_NO_DISPLAY;
+	}
+#elif defined(HEADLESS_OSMESA)
+	if (osmesaContext != NULL) {
+		OSMesaDestroyContext(osmesaContext);
+		osmesaContext = NULL;
+	}
+#endif
+	if (hiddenWindow != NULL) {
+		glfwDestroyWindow(hiddenWindow);
+		glfwTerminate();
+		hiddenWindow = NULL;
+	}
+}
+
+bool createOffscreenTarget(OffscreenTarget & target, int width, int height) {
+	target.width = width;
+	target.height = height;
+
+	glGenFramebuffers(1, &target.framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+
+	glGenRenderbuffers(1, &target.colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, target.colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorBuffer);
+
+	glGenRenderbuffers(1, &target.depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, target.depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.depthBuffer);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		fprintf(stderr, "ERROR: Offscreen framebuffer is incomplete (0x%x)\n", status);
+		return false;
+	}
+	glViewport(0, 0, width, height);
+	return true;
+}
+
+void deleteOffscreenTarget(OffscreenTarget & target) {
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteRenderbuffers(1, &target.colorBuffer);
+	glDeleteRenderbuffers(1, &target.depthBuffer);
+	glDeleteFramebuffers(1, &target.framebuffer);
+}
+
+bool writeFramePPM(const char * path, int width, int height) {
+	std::vector<unsigned char> pixels((size_t)width * height * 3);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+
+	FILE * file = fopen(path, "wb");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", path);
+		return false;
+	}
+	fprintf(file, "P6\n%d %d\n255\n", width, height);
+	// OpenGL rows start at the bottom, PPM rows at the top
+	for (int y = height - 1; y >= 0; y--)
+		fwrite(&pixels[(size_t)y * width * 3], 1, (size_t)width * 3, file);
+	fclose(file);
+	return true;
+}
+
+double FrameTimings::percentile(double p) const {
+	if (frameMs.empty())
+		return 0.0;
+	std::vector<double> sorted(frameMs);
+	std::sort(sorted.begin(), sorted.end());
+	size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+double FrameTimings::mean() const {
+	if (frameMs.empty())
+		return 0.0;
+	double sum = 0.0;
+	for (size_t i = 0; i < frameMs.size(); i++)
+		sum += frameMs[i];
+	return sum / frameMs.size();
+}
+
+void FrameTimings::print(const char * label) const {
+	printf("%s: %d frames, mean %.3f ms, p50 %.3f ms, p95 %.3f ms, max %.3f ms\n",
+		label, (int)frameMs.size(), mean(), percentile(50.0), percentile(95.0), percentile(100.0));
+}
+
+bool FrameTimings::writeCSV(const char * path) const {
+	FILE * file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", path);
+		return false;
+	}
+	fprintf(file, "frame,ms\n");
+	for (size_t i = 0; i < frameMs.size(); i++)
+		fprintf(file, "%d,%f\n", (int)i, frameMs[i]);
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,40 @@
+#ifndef HEADLESS_HPP
+#define HEADLESS_HPP
+
+#include <vector>
+
+#include <GL/glew.h>
+
+// Creates an OpenGL 3.3 core context without a window. Uses EGL (Mesa's llvmpipe works
+// without a display or GPU), or OSMesa when built with HEADLESS_OSMESA, and falls back to
+// a hidden GLFW window where neither is available. Returns 0 on success.
+int initHeadlessContext(int width, int height);
+void cleanupHeadlessContext(void);
+
+// Offscreen framebuffer with a color and a depth renderbuffer
+struct OffscreenTarget {
+	GLuint framebuffer;
+	GLuint colorBuffer;
+	GLuint depthBuffer;
+	int width;
+	int height;
+};
+
+bool createOffscreenTarget(OffscreenTarget & target, int width, int height);
+void deleteOffscreenTarget(OffscreenTarget & target);
+
+// Reads the currently bound framebuffer and writes it as a binary PPM (P6)
+bool writeFramePPM(const char * path, int width, int height);
+
+// Frame time statistics for the headless runs
+struct FrameTimings {
+	std::vector<double> frameMs;
+
+	void add(double ms) { frameMs.push_back(ms); }
+	double percentile(double p) const;
+	double mean() const;
+	void print(const char * label) const;
+	bool writeCSV(const char * path) const;
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "kinematics.hpp"
+
+glm::mat4 jointRotation(float angle, glm::vec3 axis) {
+	return glm::rotate(glm::mat4(1.0f), glm::degrees(angle), axis);
+}
+
+KinematicChain::KinematicChain()
+	: root(1.0f), firstDirty(0) {
+}
+
+int KinematicChain::addJoint(int parent, glm::vec3 offset) {
+	int index = (int)joints.size();
+	// Parents must be added first so update() can walk the array front to back
+	if (parent < -1 || parent >= index)
+		return -1;
+
+	ChainJoint joint;
+	joint.parent = parent;
+	joint.offset = offset;
+	joint.numAxes = 0;
+	for (int i = 0; i < 3; i++) {
+		joint.axes[i] = glm::vec3(0.0f);
+		joint.angles[i] = 0.0f;
+	}
+	joints.push_back(joint);
+	local.push_back(glm::mat4(1.0f));
+	world.push_back(glm::mat4(1.0f));
+	localDirty.push_back(1);
+	worldDirty.push_back(1);
+	markDirty(index);
+	return index;
+}
+
+void KinematicChain::addAxis(int joint, glm::vec3 axis) {
+	ChainJoint & j = joints[joint];
+	if (j.numAxes == 3)
+		return;
+	j.axes[j.numAxes] = axis;
+	j.angles[j.numAxes] = 0.0f;
+	j.numAxes++;
+	markDirty(joint);
+}
+
+void KinematicChain::setRoot(const glm::mat4 & rootMatrix) {
+	if (root == rootMatrix)
+		return;
+	root = rootMatrix;
+	// The root transform feeds every joint without a parent
+	for (int i = 0; i < size(); i++) {
+		if (joints[i].parent < 0)
+			markDirty(i);
+	}
+}
+
+void KinematicChain::setOffset(int joint, glm::vec3 offset) {
+	if (joints[joint].offset == offset)
+		return;
+	joints[joint].offset = offset;
+	markDirty(joint);
+}
+
+void KinematicChain::setAngle(int joint, int axis, float angle) {
+	if (joints[joint].angles[axis] == angle)
+		return;
+	joints[joint].angles[axis] = angle;
+	markDirty(joint);
+}
+
+void KinematicChain::markDirty(int joint) {
+	localDirty[joint] = 1;
+	if (joint < firstDirty)
+		firstDirty = joint;
+}
+
+int KinematicChain::update() {
+	const int count = size();
+	int recomputed = 0;
+
+	for (int i = firstDirty; i < count; i++) {
+		const ChainJoint & j = joints[i];
+		bool changed = localDirty[i] != 0;
+
+		if (localDirty[i]) {
+			glm::mat4 m = glm::translate(glm::mat4(1.0f), j.offset);
+			// Rotate in place rather than multiplying by jointRotation(); same result, fewer flops.
+			// Keep the degrees() in step with jointRotation().
+			for (int a = 0; a < j.numAxes; a++)
+				m = glm::rotate(m, glm::degrees(j.angles[a]), j.axes[a]);
+			local[i] = m;
+			localDirty[i] = 0;
+		}
+		if (j.parent >= 0 && worldDirty[j.parent])
+			changed = true;
+
+		worldDirty[i] = changed;
+		if (changed) {
+			world[i] = (j.parent >= 0 ? world[j.parent] : root) * local[i];
+			recomputed++;
+		}
+	}
+
+	// Clear the propagation flags so the next pass starts clean
+	for (int i = firstDirty; i < count; i++)
+		worldDirty[i] = 0;
+	firstDirty = count;
+
+	return recomputed;
+}
+
+void buildRobotArmChain(KinematicChain & chain) {
+	// Same offsets and rotation axes renderScene() used to apply by hand
+	int base = chain.addJoint(-1, glm::vec3(0.0f));
+	int top = chain.addJoint(base, TopOffset);
+	chain.addAxis(top, glm::vec3(0.0f, 1.0f, 0.0f));
+	int arm1 = chain.addJoint(top, Arm1Offset);
+	chain.addAxis(arm1, glm::vec3(1.0f, 0.0f, 0.0f));
+	int joint = chain.addJoint(arm1, JointOffset);
+	int arm2 = chain.addJoint(joint, glm::vec3(0.0f, 0.0f, 0.0f));
+	chain.addAxis(arm2, glm::vec3(1.0f, 0.0f, 0.0f));
+	int pen = chain.addJoint(arm2, PenOffset);
+	chain.addAxis(pen, glm::vec3(0.0f, 0.0f, 1.0f));	// longitude
+	chain.addAxis(pen, glm::vec3(1.0f, 0.0f, 0.0f));	// latitude
+	chain.addAxis(pen, glm::vec3(0.0f, 1.0f, 0.0f));	// twist
+	chain.addJoint(pen, ButtonOffset);
+}
+
+void setRobotArmJoints(KinematicChain & chain, const ArmJoints & joints) {
+	chain.setOffset(LINK_BASE, joints.baseTranslate);
+	chain.setAngle(LINK_TOP, 0, joints.topRotate);
+	chain.setAngle(LINK_ARM1, 0, joints.arm1Rotate);
+	chain.setAngle(LINK_ARM2, 0, joints.arm2Rotate);
+	chain.setAngle(LINK_PEN, 0, joints.penRotateLongitude);
+	chain.setAngle(LINK_PEN, 1, joints.penRotateLatitude);
+	chain.setAngle(LINK_PEN, 2, joints.penRotateAxis);
+}
+
+void computeRobotArmLinks(const ArmJoints & joints, glm::mat4 out_links[NUM_ARM_LINKS]) {
+	const glm::vec3 X(1.0f, 0.0f, 0.0f), Y(0.0f, 1.0f, 0.0f), Z(0.0f, 0.0f, 1.0f);
+	out_links[LINK_BASE] = glm::translate(glm::mat4(1.0f), joints.baseTranslate);
+	out_links[LINK_TOP] = glm::translate(out_links[LINK_BASE], TopOffset) * jointRotation(joints.topRotate, Y);
+	out_links[LINK_ARM1] = glm::translate(out_links[LINK_TOP], Arm1Offset) * jointRotation(joints.arm1Rotate, X);
+	out_links[LINK_JOINT] = glm::translate(out_links[LINK_ARM1], JointOffset);
+	out_links[LINK_ARM2] = out_links[LINK_JOINT] * jointRotation(joints.arm2Rotate, X);
+	out_links[LINK_PEN] = glm::translate(out_links[LINK_ARM2], PenOffset) *
+		jointRotation(joints.penRotateLongitude, Z) * jointRotation(joints.penRotateLatitude, X) *
+		jointRotation(joints.penRotateAxis, Y);
+	out_links[LINK_BUTTON] = glm::translate(out_links[LINK_PEN], ButtonOffset);
+}
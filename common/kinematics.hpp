@@ -0,0 +1,106 @@
+#ifndef KINEMATICS_HPP
+#define KINEMATICS_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// One link of a kinematic chain: a translation from the parent frame followed
+// by up to three rotations about local axes, applied in the order they were added.
+struct ChainJoint {
+	int parent;             // index of the parent joint, -1 for the root
+	glm::vec3 offset;       // translation from the parent frame
+	int numAxes;
+	glm::vec3 axes[3];
+	float angles[3];        // same units as the J1..J6 globals (see jointRotation)
+};
+
+// Flat, parent-indexed joint array with cached world matrices.
+// Parents always come before their children, so a single forward pass over the
+// array updates the chain, and the pass starts at the first joint that changed.
+class KinematicChain {
+public:
+	KinematicChain();
+
+	// Returns the new joint's index, or -1 if parent is not -1 or an earlier joint
+	int addJoint(int parent, glm::vec3 offset);
+	void addAxis(int joint, glm::vec3 axis);
+
+	void setRoot(const glm::mat4 & rootMatrix);
+	void setOffset(int joint, glm::vec3 offset);
+	void setAngle(int joint, int axis, float angle);
+
+	glm::vec3 getOffset(int joint) const { return joints[joint].offset; }
+	float getAngle(int joint, int axis) const { return joints[joint].angles[axis]; }
+	const ChainJoint & getJoint(int joint) const { return joints[joint]; }
+
+	// Recomputes the world matrices of every joint at or below a changed joint.
+	// Returns the number of world matrices that were recomputed.
+	int update();
+
+	// Cached world matrix; only valid after update()
+	const glm::mat4 & getWorldMatrix(int joint) const { return world[joint]; }
+	const glm::mat4 & getLocalMatrix(int joint) const { return local[joint]; }
+
+	int size() const { return (int)joints.size(); }
+
+private:
+	void markDirty(int joint);
+
+	std::vector<ChainJoint> joints;
+	std::vector<glm::mat4> local;
+	std::vector<glm::mat4> world;
+	std::vector<unsigned char> localDirty;
+	std::vector<unsigned char> worldDirty;
+	glm::mat4 root;
+	int firstDirty;         // lowest dirty index, size() when clean
+};
+
+// renderScene() passes degrees(angle) to glm::rotate, which the bundled GLM takes
+// as radians. computeRobotArmLinks() rotates through here; KinematicChain::update()
+// calls glm::rotate with degrees() itself. Change both together to keep motion unchanged.
+glm::mat4 jointRotation(float angle, glm::vec3 axis);
+
+// The robot arm drawn by renderScene(): base -> top -> arm1 -> joint -> arm2 -> pen -> button
+enum RobotArmLink {
+	LINK_BASE = 0,
+	LINK_TOP,
+	LINK_ARM1,
+	LINK_JOINT,
+	LINK_ARM2,
+	LINK_PEN,
+	LINK_BUTTON,
+	NUM_ARM_LINKS
+};
+
+// Where each link of the robot arm sits in its parent's frame, as the models were built
+const glm::vec3 TopOffset = glm::vec3(0.0f, 1.0f, 0.0f);
+const glm::vec3 Arm1Offset = glm::vec3(0.0f, 0.4f, 0.0f);	// arm1 pivot
+const glm::vec3 JointOffset = glm::vec3(0.0f, 1.25f, 0.0f);	// arm2 pivot, at the far end of arm1
+const glm::vec3 PenOffset = glm::vec3(0.0f, 1.0f, 0.0f);	// at the far end of arm2
+const glm::vec3 ButtonOffset = glm::vec3(0.0f, 0.25f, 0.1f);
+
+// Far end of pen.obj along its local +Y axis, in the pen frame
+const glm::vec3 PenTipOffset = glm::vec3(0.0f, 1.05f, 0.0f);
+
+// Joint state of one arm (J0..J6)
+struct ArmJoints {
+	glm::vec3 baseTranslate;    // J0
+	float topRotate;            // J1
+	float arm1Rotate;           // J2
+	float arm2Rotate;           // J3
+	float penRotateLongitude;   // J4
+	float penRotateLatitude;    // J5
+	float penRotateAxis;        // J6
+};
+
+// Appends the robot arm links to an empty chain, in RobotArmLink order
+void buildRobotArmChain(KinematicChain & chain);
+
+// Copies an arm state into a chain built by buildRobotArmChain()
+void setRobotArmJoints(KinematicChain & chain, const ArmJoints & joints);
+
+// World matrices of the robot arm links, as a chain built by buildRobotArmChain() would compute
+// them, without the chain's bookkeeping. For code that evaluates many unrelated arm states.
+void computeRobotArmLinks(const ArmJoints & joints, glm::mat4 out_links[NUM_ARM_LINKS]);
+
+#endif
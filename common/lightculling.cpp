@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "lightculling.hpp"
+
+LightClusterGrid::LightClusterGrid()
+	: width(0), height(0), tileSize(1), numSlices(1), nearPlane(0.1f), sliceScale(0.0f), sliceBias(0.0f),
+	tilesX(0), tilesY(0), maxPerCluster(0) {
+}
+
+void LightClusterGrid::resize(int newWidth, int newHeight, int newTileSize, int newNumSlices, float newNearPlane,
+	float farPlane) {
+	width = newWidth;
+	height = newHeight;
+	tileSize = newTileSize;
+	numSlices = newNumSlices;
+	nearPlane = newNearPlane;
+	sliceScale = numSlices / std::log(farPlane / nearPlane);
+	sliceBias = -std::log(nearPlane) * sliceScale;
+	tilesX = (width + tileSize - 1) / tileSize;
+	tilesY = (height + tileSize - 1) / tileSize;
+	clusterRanges.assign(tilesX * tilesY * numSlices * 2, 0);
+	lightIndices.clear();
+	maxPerCluster = 0;
+}
+
+int LightClusterGrid::slice(float depth) const {
+	int s = (int)std::floor(std::log(std::max(depth, nearPlane)) * sliceScale + sliceBias);
+	return std::min(std::max(s, 0), numSlices - 1);
+}
+
+void LightClusterGrid::cull(const std::vector<PointLight> & lights, const glm::mat4 & view, const glm::mat4 & projection) {
+	const int numLights = std::min((int)lights.size(), MaxLights);
+	lightBoxes.resize(numLights);
+	const ClusterBox allClusters = { 0, 0, tilesX, tilesY, 0, numSlices - 1 };
+	const ClusterBox noClusters = { 0, 0, 0, 0, 0, -1 };
+
+	// Screen rectangle of each light from the corners of its bounding box in camera space.
+	// Looser than the sphere's exact outline, but never misses a pixel it lights.
+	for (int i = 0; i < numLights; i++) {
+		const PointLight & light = lights[i];
+		if (light.radius <= 0.0f) {
+			lightBoxes[i] = allClusters;
+			continue;
+		}
+		const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+		const float r = light.radius;
+		if (center.z - r > -nearPlane) {
+			lightBoxes[i] = noClusters;     // entirely in front of the near plane
+			continue;
+		}
+		ClusterBox box = allClusters;
+		box.firstSlice = slice(-(center.z + r));
+		box.lastSlice = slice(-(center.z - r));
+		// Straddling the near plane, the projection would wrap: keep every tile
+		if (center.z + r <= -nearPlane) {
+			glm::vec2 lo(1e30f), hi(-1e30f);
+			for (int corner = 0; corner < 8; corner++) {
+				glm::vec3 p = center + glm::vec3((corner & 1) ? r : -r, (corner & 2) ? r : -r, (corner & 4) ? r : -r);
+				glm::vec4 clip = projection * glm::vec4(p, 1.0f);
+				glm::vec2 ndc = glm::vec2(clip) / clip.w;
+				lo = glm::min(lo, ndc);
+				hi = glm::max(hi, ndc);
+			}
+			// NDC -> pixels -> tiles, clamped to the screen
+			box.x0 = std::max((int)std::floor((lo.x * 0.5f + 0.5f) * width / tileSize), 0);
+			box.y0 = std::max((int)std::floor((lo.y * 0.5f + 0.5f) * height / tileSize), 0);
+			box.x1 = std::min((int)std::floor((hi.x * 0.5f + 0.5f) * width / tileSize) + 1, tilesX);
+			box.y1 = std::min((int)std::floor((hi.y * 0.5f + 0.5f) * height / tileSize) + 1, tilesY);
+		}
+		lightBoxes[i] = (box.x0 < box.x1 && box.y0 < box.y1) ? box : noClusters;
+	}
+
+	// Count per cluster, turn the counts into offsets, then fill the lists
+	const int numClusters = tilesX * tilesY * numSlices;
+	for (int c = 0; c < numClusters; c++)
+		clusterRanges[c * 2 + 1] = 0;
+	for (int i = 0; i < numLights; i++) {
+		const ClusterBox & box = lightBoxes[i];
+		for (int s = box.firstSlice; s <= box.lastSlice; s++)
+			for (int y = box.y0; y < box.y1; y++)
+				for (int x = box.x0; x < box.x1; x++)
+					clusterRanges[((s * tilesY + y) * tilesX + x) * 2 + 1]++;
+	}
+	unsigned int offset = 0;
+	maxPerCluster = 0;
+	for (int c = 0; c < numClusters; c++) {
+		clusterRanges[c * 2] = offset;
+		offset += clusterRanges[c * 2 + 1];
+		maxPerCluster = std::max(maxPerCluster, (int)clusterRanges[c * 2 + 1]);
+		clusterRanges[c * 2 + 1] = 0;
+	}
+	lightIndices.resize(offset);
+	for (int i = 0; i < numLights; i++) {
+		const ClusterBox & box = lightBoxes[i];
+		for (int s = box.firstSlice; s <= box.lastSlice; s++) {
+			for (int y = box.y0; y < box.y1; y++) {
+				for (int x = box.x0; x < box.x1; x++) {
+					unsigned int * range = &clusterRanges[((s * tilesY + y) * tilesX + x) * 2];
+					lightIndices[range[0] + range[1]] = (unsigned char)i;
+					range[1]++;
+				}
+			}
+		}
+	}
+}
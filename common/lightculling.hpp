@@ -0,0 +1,63 @@
+#ifndef LIGHTCULLING_HPP
+#define LIGHTCULLING_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// A point light with a finite reach: its contribution is faded to exactly 0 at radius
+struct PointLight {
+	glm::vec3 position;     // world space
+	float radius;           // <= 0: reaches everything, never culled
+	glm::vec3 color;
+	float power;
+};
+
+// Light indices are stored as bytes
+const int MaxLights = 256;
+
+// The view frustum split into clusters: square screen tiles, each cut into depth slices
+// that grow logarithmically from the near to the far plane. Every cluster gets the list of
+// lights whose bounding box overlaps it (clustered forward shading, culled on the CPU), so
+// a fragment only loops over the lights of its own cluster.
+class LightClusterGrid {
+public:
+	LightClusterGrid();
+
+	void resize(int width, int height, int tileSize, int numSlices, float nearPlane, float farPlane);
+
+	// Rebuilds every cluster's light list. Lights past MaxLights are ignored.
+	void cull(const std::vector<PointLight> & lights, const glm::mat4 & view, const glm::mat4 & projection);
+
+	int getTilesX(void) const { return tilesX; }
+	int getTilesY(void) const { return tilesY; }
+	int getTileSize(void) const { return tileSize; }
+	int getNumSlices(void) const { return numSlices; }
+	// Slice of a fragment at distance depth in front of the camera: log(depth) * scale + bias
+	float getSliceScale(void) const { return sliceScale; }
+	float getSliceBias(void) const { return sliceBias; }
+
+	// (first index, count) into getLightIndices() per cluster, at (slice * tilesY + y) * tilesX + x
+	// with tile rows counted from the bottom
+	const std::vector<unsigned int> & getClusterRanges(void) const { return clusterRanges; }
+	const std::vector<unsigned char> & getLightIndices(void) const { return lightIndices; }
+	int getMaxLightsPerCluster(void) const { return maxPerCluster; }
+
+private:
+	int slice(float depth) const;
+
+	int width, height, tileSize, numSlices;
+	float nearPlane;
+	float sliceScale, sliceBias;
+	int tilesX, tilesY;
+	int maxPerCluster;
+	std::vector<unsigned int> clusterRanges;
+	std::vector<unsigned char> lightIndices;
+	// Cluster box of each light: tiles [x0, x1) x [y0, y1), slices [first, last], empty when culled
+	struct ClusterBox {
+		int x0, y0, x1, y1;
+		int firstSlice, lastSlice;
+	};
+	std::vector<ClusterBox> lightBoxes;
+};
+
+#endif
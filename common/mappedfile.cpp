@@ -0,0 +1,100 @@
+#include <stdio.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mappedfile.hpp"
+
+MappedFile::MappedFile()
+	: bytes(NULL), length(0), opened(false)
+#ifdef _WIN32
+	, fileHandle(NULL), mappingHandle(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const char * path) {
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	length = (size_t)fileSize.QuadPart;
+	opened = true;
+	if (length == 0)
+		return true;
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		close();
+		return false;
+	}
+	mappingHandle = mapping;
+	bytes = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (bytes == NULL) {
+		close();
+		return false;
+	}
+#else
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		::close(fd);
+		return false;
+	}
+	length = (size_t)st.st_size;
+	opened = true;
+	if (length > 0) {
+		void * p = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			::close(fd);
+			length = 0;
+			opened = false;
+			return false;
+		}
+		// We read front to back exactly once
+		madvise(p, length, MADV_SEQUENTIAL);
+		bytes = (const char *)p;
+	}
+	// The mapping stays valid after the descriptor is closed
+	::close(fd);
+#endif
+	return true;
+}
+
+void MappedFile::close(void) {
+#ifdef _WIN32
+	if (bytes != NULL)
+		UnmapViewOfFile(bytes);
+	if (mappingHandle != NULL)
+		CloseHandle((HANDLE)mappingHandle);
+	if (fileHandle != NULL)
+		CloseHandle((HANDLE)fileHandle);
+	mappingHandle = NULL;
+	fileHandle = NULL;
+#else
+	if (bytes != NULL)
+		munmap((void *)bytes, length);
+#endif
+	bytes = NULL;
+	length = 0;
+	opened = false;
+}
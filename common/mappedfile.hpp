@@ -0,0 +1,32 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <stddef.h>
+
+// Read-only memory mapping of a whole file (mmap, or MapViewOfFile on Windows)
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool open(const char * path);
+	void close(void);
+
+	const char * data(void) const { return bytes; }
+	size_t size(void) const { return length; }
+	bool isOpen(void) const { return opened; }
+
+private:
+	MappedFile(const MappedFile &);
+	MappedFile & operator=(const MappedFile &);
+
+	const char * bytes;
+	size_t length;
+	bool opened;    // an empty file is open but has nothing mapped
+#ifdef _WIN32
+	void * fileHandle;
+	void * mappingHandle;
+#endif
+};
+
+#endif
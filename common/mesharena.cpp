@@ -0,0 +1,92 @@
+#include <stdio.h>
+
+#include <GL/glew.h>
+
+#include "mesharena.hpp"
+
+MeshArena::MeshArena()
+	: vertexBuffer(0), indexBuffer(0), vertexSize(0), vertexCount(0), vertexCapacity(0), indexCount(0), indexCapacity(0) {
+}
+
+void MeshArena::init(GLsizei newVertexSize, GLsizei initialVertices, GLsizei initialIndices) {
+	cleanup();
+	vertexSize = newVertexSize;
+	reserve(vertexBuffer, 0, vertexCapacity, initialVertices, vertexSize);
+	reserve(indexBuffer, 0, indexCapacity, initialIndices, sizeof(GLuint));
+}
+
+void MeshArena::cleanup(void) {
+	if (vertexBuffer != 0)
+		glDeleteBuffers(1, &vertexBuffer);
+	if (indexBuffer != 0)
+		glDeleteBuffers(1, &indexBuffer);
+	vertexBuffer = indexBuffer = 0;
+	vertexCount = vertexCapacity = 0;
+	indexCount = indexCapacity = 0;
+}
+
+// Grows buffer to hold at least needed elements, keeping its first usedBytes. The data moves
+// to a new buffer name, so VAOs must be set up again (setupPartVAO() in the demo). The copy
+// targets are used so no VAO's element array binding is touched in the meantime.
+bool MeshArena::reserve(GLuint & buffer, size_t usedBytes, size_t & capacity, size_t needed, size_t elementSize) {
+	if (buffer != 0 && needed <= capacity)
+		return false;
+	size_t newCapacity = capacity > 0 ? capacity : 1;
+	while (newCapacity < needed)
+		newCapacity *= 2;
+
+	GLuint newBuffer;
+	glGenBuffers(1, &newBuffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * elementSize, NULL, GL_STATIC_DRAW);
+	if (buffer != 0) {
+		if (usedBytes > 0) {
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &buffer);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	buffer = newBuffer;
+	capacity = newCapacity;
+	return true;
+}
+
+ArenaRange MeshArena::add(const void * vertices, GLsizei numVertices, const GLuint * indices, GLsizei numIndices,
+	bool & out_reallocated) {
+	out_reallocated = reserve(vertexBuffer, vertexCount * vertexSize, vertexCapacity, vertexCount + numVertices, vertexSize);
+	out_reallocated = reserve(indexBuffer, indexCount * sizeof(GLuint), indexCapacity, indexCount + numIndices, sizeof(GLuint))
+		|| out_reallocated;
+
+	ArenaRange range;
+	range.baseVertex = (GLint)vertexCount;
+	range.firstIndex = (GLuint)indexCount;
+	range.indexCount = numIndices;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, vertexCount * vertexSize, numVertices * vertexSize, vertices);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, indexCount * sizeof(GLuint), numIndices * sizeof(GLuint), indices);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	vertexCount += numVertices;
+	indexCount += numIndices;
+	return range;
+}
+
+ArenaRange MeshArena::addIndices(const ArenaRange & mesh, const GLuint * indices, GLsizei numIndices, bool & out_reallocated) {
+	out_reallocated = reserve(indexBuffer, indexCount * sizeof(GLuint), indexCapacity, indexCount + numIndices, sizeof(GLuint));
+
+	ArenaRange range;
+	range.baseVertex = mesh.baseVertex;
+	range.firstIndex = (GLuint)indexCount;
+	range.indexCount = numIndices;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, indexCount * sizeof(GLuint), numIndices * sizeof(GLuint), indices);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	indexCount += numIndices;
+	return range;
+}
@@ -0,0 +1,61 @@
+#ifndef MESHARENA_HPP
+#define MESHARENA_HPP
+
+#include <stddef.h>
+
+#include <GL/glew.h>
+
+// Where one mesh lives in a MeshArena
+struct ArenaRange {
+	GLint baseVertex;   // added to every index of the mesh
+	GLuint firstIndex;
+	GLsizei indexCount; // 0 = no mesh
+};
+
+// Layout of a glMultiDrawElementsIndirect / glDrawElementsIndirect command
+struct DrawElementsIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+// One vertex buffer and one 32-bit index buffer shared by many meshes, so they can all be
+// drawn from a single VAO with base vertex offsets, e.g. in one glMultiDrawElementsIndirect.
+// Indices are always 32-bit, even for meshes that the 16-bit indexVBO() overload or a mesh
+// cache with 2 byte indices would keep at 16 bits: one index type has to fit every mesh.
+class MeshArena {
+public:
+	MeshArena();
+
+	void init(GLsizei vertexSize, GLsizei initialVertices, GLsizei initialIndices);
+	void cleanup(void);
+
+	// Appends a mesh whose indices start at 0 for its own first vertex. When the buffers
+	// are full they are reallocated twice as large (copied on the GPU) under new buffer
+	// names and out_reallocated is set: VAOs that source the old buffers have to be set up
+	// again from getVertexBuffer() and getIndexBuffer().
+	ArenaRange add(const void * vertices, GLsizei vertexCount, const GLuint * indices, GLsizei indexCount,
+		bool & out_reallocated);
+	// Appends another index list over the vertices of a mesh already added, such as a coarser
+	// level of detail. The range shares the mesh's baseVertex.
+	ArenaRange addIndices(const ArenaRange & mesh, const GLuint * indices, GLsizei indexCount, bool & out_reallocated);
+
+	GLuint getVertexBuffer(void) const { return vertexBuffer; }
+	GLuint getIndexBuffer(void) const { return indexBuffer; }
+	// Allocated, not used, bytes of both buffers
+	size_t bytes(void) const { return vertexCapacity * vertexSize + indexCapacity * sizeof(GLuint); }
+
+private:
+	// Moves buffer to a new, larger buffer name when needed elements do not fit; returns true
+	// when it did, after which every VAO bound to the old name is stale
+	static bool reserve(GLuint & buffer, size_t usedBytes, size_t & capacity, size_t needed, size_t elementSize);
+
+	GLuint vertexBuffer, indexBuffer;
+	size_t vertexSize;
+	size_t vertexCount, vertexCapacity;
+	size_t indexCount, indexCapacity;
+};
+
+#endif
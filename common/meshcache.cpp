@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <functional>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include "mappedfile.hpp"
+#include "meshcache.hpp"
+
+static const char MeshCacheMagic[4] = { 'M', 'S', 'H', 'C' };
+
+static bool getSourceStamp(const char * path, unsigned long long & size, long long & mtime) {
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_stat64(path, &st) != 0)
+		return false;
+#else
+	struct stat st;
+	if (stat(path, &st) != 0)
+		return false;
+#endif
+	size = (unsigned long long)st.st_size;
+	mtime = (long long)st.st_mtime;
+	return true;
+}
+
+std::string meshCachePath(const char * sourcePath) {
+	return std::string(sourcePath) + ".meshcache";
+}
+
+// count indices of indexSize bytes each, widened to 32 bits. False if an index is past the
+// last vertex, which an edited or damaged cache file can hold
+static bool readIndices(const char * data, unsigned int indexSize, unsigned int count, unsigned int vertexCount,
+	std::vector<unsigned int> & out) {
+	if (indexSize == 2) {
+		const unsigned short * shortIndices = (const unsigned short *)data;
+		out.assign(shortIndices, shortIndices + count);
+	}
+	else {
+		const unsigned int * intIndices = (const unsigned int *)data;
+		out.assign(intIndices, intIndices + count);
+	}
+	for (unsigned int i = 0; i < count; i++) {
+		if (out[i] >= vertexCount)
+			return false;
+	}
+	return true;
+}
+
+static bool writeIndices(FILE * file, unsigned int indexSize, const std::vector<unsigned int> & indices) {
+	if (indices.empty())
+		return true;
+	if (indexSize == 2) {
+		std::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+		return fwrite(&shortIndices[0], sizeof(unsigned short), shortIndices.size(), file) == shortIndices.size();
+	}
+	return fwrite(&indices[0], sizeof(unsigned int), indices.size(), file) == indices.size();
+}
+
+// A name next to the cache that no other thread or process writes to at the same time
+static std::string temporaryCachePath(const char * sourcePath) {
+#ifdef _WIN32
+	const int pid = _getpid();
+#else
+	const int pid = (int)getpid();
+#endif
+	char suffix[64];
+	snprintf(suffix, sizeof(suffix), ".%d.%zx.tmp", pid, std::hash<std::thread::id>()(std::this_thread::get_id()));
+	return meshCachePath(sourcePath) + suffix;
+}
+
+bool loadMeshCache(
+	const char * sourcePath,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<unsigned int> & out_indices,
+	std::vector<MeshLod> & out_lods
+){
+	out_vertices.clear();
+	out_normals.clear();
+	out_indices.clear();
+	out_lods.clear();
+
+	unsigned long long sourceSize;
+	long long sourceMtime;
+	if (!getSourceStamp(sourcePath, sourceSize, sourceMtime))
+		return false;
+
+	MappedFile file;
+	if (!file.open(meshCachePath(sourcePath).c_str()) || file.size() < sizeof(MeshCacheHeader))
+		return false;
+
+	MeshCacheHeader header;
+	memcpy(&header, file.data(), sizeof(header));
+	if (memcmp(header.magic, MeshCacheMagic, 4) != 0 || header.version != MeshCacheVersion ||
+		header.sourceSize != sourceSize || header.sourceMtime != sourceMtime ||
+		(header.indexSize != 2 && header.indexSize != 4) || header.lodCount >= (unsigned int)MaxMeshLods)
+		return false;
+	const size_t vertexBytes = (size_t)header.vertexCount * 6 * sizeof(float);
+	const size_t indexBytes = (size_t)header.indexCount * header.indexSize;
+	const size_t lodTable = sizeof(header) + vertexBytes + indexBytes;
+	const size_t lodTableBytes = (size_t)header.lodCount * 2 * sizeof(unsigned int);
+	if (file.size() < lodTable + lodTableBytes)
+		return false;
+	float lodErrors[MaxMeshLods];
+	unsigned int lodIndexCounts[MaxMeshLods];
+	size_t lodIndexBytes = 0;
+	for (unsigned int lod = 0; lod < header.lodCount; lod++) {
+		// The table may sit on any 2-byte boundary after 16-bit indices
+		memcpy(&lodErrors[lod], file.data() + lodTable + lod * 8, sizeof(float));
+		memcpy(&lodIndexCounts[lod], file.data() + lodTable + lod * 8 + 4, sizeof(unsigned int));
+		lodIndexBytes += (size_t)lodIndexCounts[lod] * header.indexSize;
+	}
+	if (file.size() != lodTable + lodTableBytes + lodIndexBytes)
+		return false;
+
+	// The header is 40 bytes, so the vertex block is 4-byte aligned in the mapping
+	const float * vertex = (const float *)(file.data() + sizeof(header));
+	out_vertices.resize(header.vertexCount);
+	out_normals.resize(header.vertexCount);
+	for (unsigned int i = 0; i < header.vertexCount; i++, vertex += 6) {
+		out_vertices[i] = glm::vec3(vertex[0], vertex[1], vertex[2]);
+		out_normals[i] = glm::vec3(vertex[3], vertex[4], vertex[5]);
+	}
+
+	bool valid = readIndices(file.data() + sizeof(header) + vertexBytes, header.indexSize, header.indexCount,
+		header.vertexCount, out_indices);
+	const char * lodIndices = file.data() + lodTable + lodTableBytes;
+	out_lods.resize(header.lodCount);
+	for (unsigned int lod = 0; valid && lod < header.lodCount; lod++) {
+		out_lods[lod].error = lodErrors[lod];
+		valid = readIndices(lodIndices, header.indexSize, lodIndexCounts[lod], header.vertexCount, out_lods[lod].indices);
+		lodIndices += (size_t)lodIndexCounts[lod] * header.indexSize;
+	}
+	if (!valid) {
+		// Leave the outputs empty so the caller rebuilds the mesh and rewrites the cache
+		out_vertices.clear();
+		out_normals.clear();
+		out_indices.clear();
+		out_lods.clear();
+	}
+	return valid;
+}
+
+bool saveMeshCache(
+	const char * sourcePath,
+	const std::vector<glm::vec3> & vertices,
+	const std::vector<glm::vec3> & normals,
+	const std::vector<unsigned int> & indices,
+	const std::vector<MeshLod> & lods
+){
+	if (lods.size() >= (size_t)MaxMeshLods)
+		return false;
+	MeshCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MeshCacheMagic, 4);
+	header.version = MeshCacheVersion;
+	if (!getSourceStamp(sourcePath, header.sourceSize, header.sourceMtime))
+		return false;
+	header.vertexCount = (unsigned int)vertices.size();
+	header.indexCount = (unsigned int)indices.size();
+	header.indexSize = vertices.size() <= 65536 ? 2 : 4;
+	header.lodCount = (unsigned int)lods.size();
+
+	std::vector<float> interleaved(vertices.size() * 6);
+	for (size_t i = 0; i < vertices.size(); i++) {
+		memcpy(&interleaved[i * 6], &vertices[i].x, 3 * sizeof(float));
+		memcpy(&interleaved[i * 6 + 3], &normals[i].x, 3 * sizeof(float));
+	}
+
+	// Written under a name of its own and renamed into place, so two loaders writing the same
+	// cache can not interleave, and readers only ever see a whole file
+	const std::string path = temporaryCachePath(sourcePath);
+	FILE * file = fopen(path.c_str(), "wb");
+	if (file == NULL)
+		return false;
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (ok && !interleaved.empty())
+		ok = fwrite(&interleaved[0], sizeof(float), interleaved.size(), file) == interleaved.size();
+	ok = ok && writeIndices(file, header.indexSize, indices);
+	for (size_t lod = 0; ok && lod < lods.size(); lod++) {
+		const unsigned int lodIndexCount = (unsigned int)lods[lod].indices.size();
+		ok = fwrite(&lods[lod].error, sizeof(float), 1, file) == 1 &&
+			fwrite(&lodIndexCount, sizeof(unsigned int), 1, file) == 1;
+	}
+	for (size_t lod = 0; ok && lod < lods.size(); lod++)
+		ok = writeIndices(file, header.indexSize, lods[lod].indices);
+	ok = fclose(file) == 0 && ok;
+#ifdef _WIN32
+	// rename() does not replace an existing file here
+	if (ok)
+		remove(meshCachePath(sourcePath).c_str());
+#endif
+	ok = ok && rename(path.c_str(), meshCachePath(sourcePath).c_str()) == 0;
+	// Never leave a truncated cache behind
+	if (!ok)
+		remove(path.c_str());
+	return ok;
+}
@@ -0,0 +1,54 @@
+#ifndef MESHCACHE_HPP
+#define MESHCACHE_HPP
+
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "meshsimplify.hpp"
+
+// Binary cache of an indexed mesh and its levels of detail, written next to its source file
+// as <source>.meshcache:
+//   MeshCacheHeader
+//   vertexCount x { float position[3]; float normal[3]; }   (interleaved)
+//   indexCount  x uint16 or uint32                          (indexSize bytes each)
+//   lodCount    x { float error; uint32 indexCount; }
+//   then each level's indices, like the mesh's
+// Native byte order. The cache is stale once the source's size or modification time
+// no longer match the ones recorded in the header, or the version changes.
+
+const unsigned int MeshCacheVersion = 2;
+
+struct MeshCacheHeader {
+	char magic[4];              // "MSHC"
+	unsigned int version;
+	unsigned long long sourceSize;
+	long long sourceMtime;      // seconds since the epoch
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	unsigned int indexSize;     // 2 when every index fits 16 bits, else 4
+	unsigned int lodCount;      // levels of detail after the full mesh
+};
+
+std::string meshCachePath(const char * sourcePath);
+
+// Maps the cache of sourcePath and copies it out. Returns false when there is
+// no cache or it is stale or damaged; the outputs are then left empty.
+bool loadMeshCache(
+	const char * sourcePath,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<unsigned int> & out_indices,
+	std::vector<MeshLod> & out_lods
+);
+
+// Writes the output of indexVBO() for sourcePath, and the levels buildMeshLods() made of it
+bool saveMeshCache(
+	const char * sourcePath,
+	const std::vector<glm::vec3> & vertices,
+	const std::vector<glm::vec3> & normals,
+	const std::vector<unsigned int> & indices,
+	const std::vector<MeshLod> & lods
+);
+
+#endif
@@ -0,0 +1,326 @@
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "meshsimplify.hpp"
+
+// Sum of squared distances to a set of planes, as the symmetric 4x4 matrix of ax + by + cz + d
+struct Quadric {
+	double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+};
+
+static void addPlane(Quadric & q, const glm::vec3 & normal, float d) {
+	const double a = normal.x, b = normal.y, c = normal.z;
+	q.a2 += a * a; q.ab += a * b; q.ac += a * c; q.ad += a * d;
+	q.b2 += b * b; q.bc += b * c; q.bd += b * d;
+	q.c2 += c * c; q.cd += c * d;
+	q.d2 += (double)d * d;
+}
+
+static void addQuadric(Quadric & q, const Quadric & other) {
+	q.a2 += other.a2; q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+	q.b2 += other.b2; q.bc += other.bc; q.bd += other.bd;
+	q.c2 += other.c2; q.cd += other.cd;
+	q.d2 += other.d2;
+}
+
+static double quadricError(const Quadric & q, const glm::vec3 & p) {
+	const double x = p.x, y = p.y, z = p.z;
+	const double e = q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x +
+		q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y +
+		q.c2 * z * z + 2.0 * q.cd * z + q.d2;
+	return std::max(e, 0.0);
+}
+
+// Moving position `from` onto position `to`, queued by cost. Entries go stale when either end
+// changes after they were queued; they are recognised by the ends' version numbers.
+struct Collapse {
+	double cost;
+	unsigned int from, to;
+	unsigned int fromVersion, toVersion;
+	bool operator>(const Collapse & other) const { return cost > other.cost; }
+};
+
+static bool lessPosition(const std::pair<glm::vec3, unsigned int> & a, const std::pair<glm::vec3, unsigned int> & b) {
+	if (a.first.x != b.first.x) return a.first.x < b.first.x;
+	if (a.first.y != b.first.y) return a.first.y < b.first.y;
+	return a.first.z < b.first.z;
+}
+
+static glm::vec3 triangleNormal(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & c) {
+	return glm::cross(b - a, c - a);
+}
+
+float simplifyMesh(
+	const std::vector<glm::vec3> & vertices,
+	const std::vector<glm::vec3> & normals,
+	const std::vector<unsigned int> & indices,
+	size_t targetIndexCount,
+	float maxError,
+	std::vector<unsigned int> & out_indices
+){
+	// Weld: one position per group of vertices that only differ in their normals
+	const size_t numVertices = vertices.size();
+	std::vector<std::pair<glm::vec3, unsigned int> > sorted(numVertices);
+	for (size_t i = 0; i < numVertices; i++)
+		sorted[i] = std::make_pair(vertices[i], (unsigned int)i);
+	std::sort(sorted.begin(), sorted.end(), lessPosition);
+	std::vector<unsigned int> position(numVertices);
+	std::vector<glm::vec3> points;
+	std::vector<std::vector<unsigned int> > copies;  // vertices at each position
+	for (size_t i = 0; i < numVertices; i++) {
+		if (i == 0 || sorted[i].first != sorted[i - 1].first) {
+			points.push_back(sorted[i].first);
+			copies.push_back(std::vector<unsigned int>());
+		}
+		position[sorted[i].second] = (unsigned int)(points.size() - 1);
+		copies.back().push_back(sorted[i].second);
+	}
+	const size_t numPoints = points.size();
+
+	// Triangles that still have three positions, the planes around every position, and the
+	// triangles touching it
+	std::vector<unsigned int> corners;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		const unsigned int a = position[indices[i]], b = position[indices[i + 1]], c = position[indices[i + 2]];
+		if (a != b && b != c && a != c)
+			corners.insert(corners.end(), &indices[i], &indices[i] + 3);
+	}
+	const size_t numTriangles = corners.size() / 3;
+	Quadric zero = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	std::vector<Quadric> quadrics(numPoints, zero);
+	std::vector<std::vector<unsigned int> > pointTriangles(numPoints);
+	for (size_t t = 0; t < numTriangles; t++) {
+		const glm::vec3 & a = vertices[corners[t * 3]];
+		const glm::vec3 n = triangleNormal(a, vertices[corners[t * 3 + 1]], vertices[corners[t * 3 + 2]]);
+		const float length = glm::length(n);
+		for (int k = 0; k < 3; k++) {
+			const unsigned int p = position[corners[t * 3 + k]];
+			pointTriangles[p].push_back((unsigned int)t);
+			if (length > 0.0f)
+				addPlane(quadrics[p], n / length, -glm::dot(n / length, a));
+		}
+	}
+
+	// Positions on an open border (an edge with one triangle) or on a non-manifold edge stay put
+	std::vector<bool> locked(numPoints, false);
+	std::vector<std::pair<unsigned int, unsigned int> > edges;
+	for (size_t t = 0; t < numTriangles; t++) {
+		for (int k = 0; k < 3; k++) {
+			const unsigned int a = position[corners[t * 3 + k]], b = position[corners[t * 3 + (k + 1) % 3]];
+			edges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	for (size_t i = 0; i < edges.size(); ) {
+		size_t j = i;
+		while (j < edges.size() && edges[j] == edges[i])
+			j++;
+		if (j - i != 2)
+			locked[edges[i].first] = locked[edges[i].second] = true;
+		i = j;
+	}
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+	std::vector<unsigned int> version(numPoints, 0);
+	std::vector<bool> removed(numPoints, false);
+	std::vector<bool> deadTriangle(numTriangles, false);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse> > queue;
+	for (size_t i = 0; i < edges.size(); i++) {
+		for (int side = 0; side < 2; side++) {
+			const unsigned int from = side == 0 ? edges[i].first : edges[i].second;
+			const unsigned int to = side == 0 ? edges[i].second : edges[i].first;
+			if (locked[from])
+				continue;
+			Quadric q = quadrics[from];
+			addQuadric(q, quadrics[to]);
+			Collapse collapse = { quadricError(q, points[to]), from, to, 0, 0 };
+			queue.push(collapse);
+		}
+	}
+
+	const double maxCost = (double)maxError * maxError;
+	double worstCost = 0.0;
+	size_t liveTriangles = numTriangles;
+	std::vector<unsigned int> neighbours, otherNeighbours;
+	while (liveTriangles * 3 > targetIndexCount && !queue.empty()) {
+		const Collapse collapse = queue.top();
+		queue.pop();
+		const unsigned int from = collapse.from, to = collapse.to;
+		if (removed[from] || removed[to] || collapse.fromVersion != version[from] || collapse.toVersion != version[to])
+			continue;
+		if (collapse.cost > maxCost)
+			break;
+
+		// Link condition: the two ends may only share the neighbours across the edge's own two
+		// triangles, or the collapse would pinch the surface together
+		neighbours.clear();
+		otherNeighbours.clear();
+		bool flips = false;
+		for (size_t i = 0; i < pointTriangles[from].size(); i++) {
+			const unsigned int t = pointTriangles[from][i];
+			if (deadTriangle[t])
+				continue;
+			glm::vec3 before[3], after[3];
+			bool hasTo = false;
+			for (int k = 0; k < 3; k++) {
+				const unsigned int p = position[corners[t * 3 + k]];
+				hasTo = hasTo || p == to;
+				if (p != from)
+					neighbours.push_back(p);
+				before[k] = points[p];
+				after[k] = p == from ? points[to] : points[p];
+			}
+			// Triangles that keep their area must not turn over (or turn by more than ~75 degrees)
+			if (!hasTo) {
+				const glm::vec3 n0 = triangleNormal(before[0], before[1], before[2]);
+				const glm::vec3 n1 = triangleNormal(after[0], after[1], after[2]);
+				if (glm::dot(n0, n1) <= 0.25f * glm::length(n0) * glm::length(n1))
+					flips = true;
+			}
+		}
+		if (flips)
+			continue;
+		for (size_t i = 0; i < pointTriangles[to].size(); i++) {
+			const unsigned int t = pointTriangles[to][i];
+			if (deadTriangle[t])
+				continue;
+			for (int k = 0; k < 3; k++) {
+				const unsigned int p = position[corners[t * 3 + k]];
+				if (p != to)
+					otherNeighbours.push_back(p);
+			}
+		}
+		std::sort(neighbours.begin(), neighbours.end());
+		neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+		std::sort(otherNeighbours.begin(), otherNeighbours.end());
+		otherNeighbours.erase(std::unique(otherNeighbours.begin(), otherNeighbours.end()), otherNeighbours.end());
+		size_t shared = 0;
+		for (size_t i = 0, j = 0; i < neighbours.size() && j < otherNeighbours.size(); ) {
+			if (neighbours[i] < otherNeighbours[j])
+				i++;
+			else if (otherNeighbours[j] < neighbours[i])
+				j++;
+			else {
+				shared++;
+				i++;
+				j++;
+			}
+		}
+		if (shared > 2)
+			continue;
+
+		// Collapse: the edge's triangles go, the others move their corner onto the copy at `to`
+		// whose normal is closest
+		for (size_t i = 0; i < pointTriangles[from].size(); i++) {
+			const unsigned int t = pointTriangles[from][i];
+			if (deadTriangle[t])
+				continue;
+			bool hasTo = false;
+			for (int k = 0; k < 3; k++)
+				hasTo = hasTo || position[corners[t * 3 + k]] == to;
+			if (hasTo) {
+				deadTriangle[t] = true;
+				liveTriangles--;
+				continue;
+			}
+			for (int k = 0; k < 3; k++) {
+				unsigned int & corner = corners[t * 3 + k];
+				if (position[corner] != from)
+					continue;
+				const glm::vec3 normal = normals[corner];
+				unsigned int best = copies[to][0];
+				for (size_t c = 1; c < copies[to].size(); c++) {
+					if (glm::dot(normals[copies[to][c]], normal) > glm::dot(normals[best], normal))
+						best = copies[to][c];
+				}
+				corner = best;
+			}
+			pointTriangles[to].push_back(t);
+		}
+		removed[from] = true;
+		addQuadric(quadrics[to], quadrics[from]);
+		version[to]++;
+		worstCost = std::max(worstCost, collapse.cost);
+
+		// Requeue the edges around `to`, whose quadric has changed
+		std::vector<unsigned int> & around = pointTriangles[to];
+		size_t live = 0;
+		for (size_t i = 0; i < around.size(); i++) {
+			if (!deadTriangle[around[i]])
+				around[live++] = around[i];
+		}
+		around.resize(live);
+		neighbours.clear();
+		for (size_t i = 0; i < around.size(); i++) {
+			for (int k = 0; k < 3; k++) {
+				const unsigned int p = position[corners[around[i] * 3 + k]];
+				if (p != to)
+					neighbours.push_back(p);
+			}
+		}
+		std::sort(neighbours.begin(), neighbours.end());
+		neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+		for (size_t i = 0; i < neighbours.size(); i++) {
+			const unsigned int other = neighbours[i];
+			Quadric q = quadrics[to];
+			addQuadric(q, quadrics[other]);
+			if (!locked[to]) {
+				Collapse c = { quadricError(q, points[other]), to, other, version[to], version[other] };
+				queue.push(c);
+			}
+			if (!locked[other]) {
+				Collapse c = { quadricError(q, points[to]), other, to, version[other], version[to] };
+				queue.push(c);
+			}
+		}
+	}
+
+	out_indices.clear();
+	out_indices.reserve(liveTriangles * 3);
+	for (size_t t = 0; t < numTriangles; t++) {
+		if (!deadTriangle[t])
+			out_indices.insert(out_indices.end(), &corners[t * 3], &corners[t * 3] + 3);
+	}
+	return (float)sqrt(worstCost);
+}
+
+int selectMeshLod(const float * errors, int count, float pixelsPerUnit, int current, float errorPixels, float hysteresis) {
+	// Coarsest level allowed as if the mesh were hysteresis larger (strict) or smaller (lenient)
+	int strict = 0, lenient = 0;
+	for (int lod = 1; lod < count; lod++) {
+		if (errors[lod] * pixelsPerUnit * (1.0f + hysteresis) < errorPixels)
+			strict = lod;
+		if (errors[lod] * pixelsPerUnit * (1.0f - hysteresis) < errorPixels)
+			lenient = lod;
+	}
+	return std::min(std::max(current, strict), lenient);
+}
+
+void buildMeshLods(
+	const std::vector<glm::vec3> & vertices,
+	const std::vector<glm::vec3> & normals,
+	const std::vector<unsigned int> & indices,
+	float maxError,
+	std::vector<MeshLod> & out_lods
+){
+	out_lods.clear();
+	out_lods.reserve(MaxMeshLods - 1);
+	const std::vector<unsigned int> * previous = &indices;
+	float previousError = 0.0f;
+	for (int level = 1; level < MaxMeshLods; level++) {
+		// Errors add up from level to level; each gets what the ones before left of maxError
+		const size_t target = (previous->size() / 6) * 3;
+		MeshLod lod;
+		lod.error = previousError + simplifyMesh(vertices, normals, *previous, target, maxError - previousError, lod.indices);
+		if (lod.indices.empty() || lod.indices.size() * 4 > previous->size() * 3)
+			break;
+		out_lods.push_back(lod);
+		previous = &out_lods.back().indices;
+		previousError = lod.error;
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef MESHSIMPLIFY_HPP
+#define MESHSIMPLIFY_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Levels of detail a part can have, the full mesh included
+const int MaxMeshLods = 4;
+// How far the coarsest level may move the surface, relative to the mesh's box diagonal
+const float LodMaxError = 0.1f;
+
+// A coarser version of an indexed mesh, over the same vertices
+struct MeshLod {
+	std::vector<unsigned int> indices;
+	float error;        // how far the surface may have moved from the full mesh, model units
+};
+
+// Quadric error edge collapse (Garland & Heckbert): the cheapest edges are collapsed first, each
+// by moving one end onto the other, so the result only uses the input vertices. Vertices at the
+// same position (split by indexVBO() where the normals differ) move as one, and each corner
+// keeps the copy whose normal is closest to its own. Collapses are skipped when they would
+// flip a triangle, pinch the surface or move an open border. Stops once at most
+// targetIndexCount indices are left, or when the next collapse would move the surface further
+// than maxError. Returns the largest error of the collapses made.
+float simplifyMesh(
+	const std::vector<glm::vec3> & vertices,
+	const std::vector<glm::vec3> & normals,
+	const std::vector<unsigned int> & indices,
+	size_t targetIndexCount,
+	float maxError,
+	std::vector<unsigned int> & out_indices
+);
+
+// Up to MaxMeshLods - 1 levels, each simplified from the one before to about half its
+// triangles. Stops at the first level that would not save a quarter of them without moving
+// the surface further than maxError from the full mesh in all.
+void buildMeshLods(
+	const std::vector<glm::vec3> & vertices,
+	const std::vector<glm::vec3> & normals,
+	const std::vector<unsigned int> & indices,
+	float maxError,
+	std::vector<MeshLod> & out_lods
+);
+
+// Level to draw a mesh at: the coarsest of count levels whose error (errors[0] = 0 for the full
+// mesh, then growing) covers less than errorPixels on screen, where a model unit covers
+// pixelsPerUnit. current is the level it was drawn at before; it only changes once the mesh
+// has come hysteresis (a fraction of its size) closer or further than where the levels
+// switch, so a mesh sitting there does not flicker between the two.
+int selectMeshLod(const float * errors, int count, float pixelsPerUnit, int current, float errorPixels, float hysteresis);
+
+#endif
@@ -1,19 +1,19 @@
-#ifndef OBJLOADER_H
-#define OBJLOADER_H
-
-bool loadOBJ(
-	const char * path, 
-	std::vector<glm::vec3> & out_vertices, 
-	std::vector<glm::vec3> & out_normals
-);
-
-
-
-bool loadAssImp(
-	const char * path, 
-	std::vector<unsigned short> & indices,
-	std::vector<glm::vec3> & vertices,
-	std::vector<glm::vec3> & normals
-);
-
+#ifndef OBJLOADER_H
+#define OBJLOADER_H
+
+bool loadOBJ(
+	const char * path, 
+	std::vector<glm::vec3> & out_vertices, 
+	std::vector<glm::vec3> & out_normals
+);
+
+
+
+bool loadAssImp(
+	const char * path, 
+	std::vector<unsigned short> & indices,
+	std::vector<glm::vec3> & vertices,
+	std::vector<glm::vec3> & normals
+);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <cmath>
+#include <vector>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "mappedfile.hpp"
+#include "objparser.hpp"
+
+// Unlike loadOBJ(), nothing here goes through the C stream functions: the file is
+// mapped once and scanned front to back with the small lexer below.
+
+static inline bool isBlank(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+static inline void skipBlanks(const char * & p, const char * end) {
+	while (p < end && isBlank(*p))
+		p++;
+}
+
+static inline void skipLine(const char * & p, const char * end) {
+	while (p < end && *p != '\n')
+		p++;
+	if (p < end)
+		p++;
+}
+
+// Exact powers of ten representable as doubles
+static const double powersOf10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool parseFloat(const char * & p, const char * end, float & out) {
+	skipBlanks(p, end);
+	const char * start = p;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+
+	// Up to 19 significant digits fit in 64 bits; further digits only shift the exponent
+	unsigned long long mantissa = 0;
+	int digits = 0, exponent = 0;
+	while (p < end && isDigit(*p)) {
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (unsigned)(*p - '0');
+			if (mantissa != 0)
+				digits++;
+		}
+		else {
+			exponent++;
+		}
+		p++;
+	}
+	if (p < end && *p == '.') {
+		p++;
+		while (p < end && isDigit(*p)) {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (unsigned)(*p - '0');
+				if (mantissa != 0)
+					digits++;
+				exponent--;
+			}
+			p++;
+		}
+	}
+	if (p == start || (p == start + 1 && (*start == '-' || *start == '+' || *start == '.')))
+		return false;
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char * e = p + 1;
+		bool negativeExponent = false;
+		if (e < end && (*e == '-' || *e == '+')) {
+			negativeExponent = *e == '-';
+			e++;
+		}
+		if (e < end && isDigit(*e)) {
+			int value = 0;
+			while (e < end && isDigit(*e)) {
+				if (value < 10000)
+					value = value * 10 + (*e - '0');
+				e++;
+			}
+			exponent += negativeExponent ? -value : value;
+			p = e;
+		}
+	}
+
+	double result = (double)mantissa;
+	if (exponent < 0)
+		result = exponent >= -22 ? result / powersOf10[-exponent] : result * std::pow(10.0, exponent);
+	else if (exponent > 0)
+		result = exponent <= 22 ? result * powersOf10[exponent] : result * std::pow(10.0, exponent);
+	out = (float)(negative ? -result : result);
+	return true;
+}
+
+static inline bool parseInt(const char * & p, const char * end, int & out) {
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+	if (p >= end || !isDigit(*p))
+		return false;
+	int value = 0;
+	while (p < end && isDigit(*p)) {
+		value = value * 10 + (*p - '0');
+		p++;
+	}
+	out = negative ? -value : value;
+	return true;
+}
+
+// OBJ indices are 1-based; negative ones count back from the last element defined so far
+static inline int resolveIndex(int index, size_t count) {
+	if (index > 0)
+		return index - 1;
+	if (index < 0)
+		return (int)count + index;
+	return -1;
+}
+
+struct ObjCorner {
+	int position, uv, normal;	// resolved 0-based, -1 when absent
+};
+
+static void closeObject(std::vector<ObjObject> * objects, size_t triangles) {
+	if (objects == NULL || objects->empty())
+		return;
+	ObjObject & last = objects->back();
+	last.triangleCount = triangles - last.firstTriangle;
+}
+
+bool parseOBJFromMemory(
+	const char * text, size_t length,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec2> & out_uvs,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<ObjObject> * out_objects
+){
+	std::vector<glm::vec3> temp_vertices;
+	std::vector<glm::vec2> temp_uvs;
+	std::vector<glm::vec3> temp_normals;
+	// Rough guess from typical line lengths, saves most reallocations on big files
+	temp_vertices.reserve(length / 64);
+	temp_normals.reserve(length / 64);
+	out_vertices.reserve(out_vertices.size() + length / 16);
+	out_normals.reserve(out_normals.size() + length / 16);
+
+	std::vector<ObjCorner> corners;
+	bool anyUV = false;
+	size_t firstOutput = out_vertices.size();
+	size_t firstUV = out_uvs.size();
+	int lineNumber = 0;
+
+	const char * p = text;
+	const char * end = text + length;
+	while (p < end) {
+		lineNumber++;
+		skipBlanks(p, end);
+		if (p >= end)
+			break;
+
+		const char c = *p;
+		if (c == 'v' && p + 1 < end) {
+			const char kind = p[1];
+			if (isBlank(kind)) {
+				p += 1;
+				glm::vec3 v;
+				if (!parseFloat(p, end, v.x) || !parseFloat(p, end, v.y) || !parseFloat(p, end, v.z))
+					goto malformed;
+				temp_vertices.push_back(v);
+			}
+			else if (kind == 't' && p + 2 < end && isBlank(p[2])) {
+				p += 2;
+				glm::vec2 uv;
+				if (!parseFloat(p, end, uv.x))
+					goto malformed;
+				if (!parseFloat(p, end, uv.y))
+					uv.y = 0.0f;
+				temp_uvs.push_back(uv);
+			}
+			else if (kind == 'n' && p + 2 < end && isBlank(p[2])) {
+				p += 2;
+				glm::vec3 n;
+				if (!parseFloat(p, end, n.x) || !parseFloat(p, end, n.y) || !parseFloat(p, end, n.z))
+					goto malformed;
+				temp_normals.push_back(n);
+			}
+		}
+		else if (c == 'f' && p + 1 < end && isBlank(p[1])) {
+			p += 1;
+			corners.clear();
+			while (true) {
+				skipBlanks(p, end);
+				if (p >= end || *p == '\n' || *p == '#')
+					break;
+
+				int v = 0, vt = 0, vn = 0;
+				if (!parseInt(p, end, v))
+					goto malformed;
+				if (p < end && *p == '/') {
+					p++;
+					if (p < end && *p != '/') {
+						if (!parseInt(p, end, vt))
+							goto malformed;
+					}
+					if (p < end && *p == '/') {
+						p++;
+						if (!parseInt(p, end, vn))
+							goto malformed;
+					}
+				}
+
+				ObjCorner corner;
+				corner.position = resolveIndex(v, temp_vertices.size());
+				corner.uv = vt != 0 ? resolveIndex(vt, temp_uvs.size()) : -1;
+				corner.normal = vn != 0 ? resolveIndex(vn, temp_normals.size()) : -1;
+				if (corner.position < 0 || corner.position >= (int)temp_vertices.size() ||
+					corner.uv >= (int)temp_uvs.size() || (vt != 0 && corner.uv < 0) ||
+					corner.normal >= (int)temp_normals.size() || (vn != 0 && corner.normal < 0)) {
+					printf("OBJ index out of range on line %d\n", lineNumber);
+					return false;
+				}
+				anyUV = anyUV || corner.uv >= 0;
+				corners.push_back(corner);
+			}
+
+			// Fan triangulation; fine for the convex polygons CAD exporters write
+			for (size_t i = 1; i + 1 < corners.size(); i++) {
+				const ObjCorner tri[3] = { corners[0], corners[i], corners[i + 1] };
+				glm::vec3 a = temp_vertices[tri[0].position];
+				glm::vec3 b = temp_vertices[tri[1].position];
+				glm::vec3 d = temp_vertices[tri[2].position];
+				glm::vec3 faceNormal(0.0f);
+				if (tri[0].normal < 0 || tri[1].normal < 0 || tri[2].normal < 0) {
+					faceNormal = glm::cross(b - a, d - a);
+					float len = glm::length(faceNormal);
+					faceNormal = len > 0.0f ? faceNormal / len : glm::vec3(0.0f, 1.0f, 0.0f);
+				}
+				// UVs are only written once the file has any, padded for earlier triangles
+				if (anyUV)
+					out_uvs.resize(firstUV + (out_vertices.size() - firstOutput), glm::vec2(0.0f));
+				for (int k = 0; k < 3; k++) {
+					out_vertices.push_back(temp_vertices[tri[k].position]);
+					out_normals.push_back(tri[k].normal >= 0 ? temp_normals[tri[k].normal] : faceNormal);
+					if (anyUV)
+						out_uvs.push_back(tri[k].uv >= 0 ? temp_uvs[tri[k].uv] : glm::vec2(0.0f));
+				}
+			}
+		}
+		else if ((c == 'o' || c == 'g') && p + 1 < end && (isBlank(p[1]) || p[1] == '\n')) {
+			p += 1;
+			skipBlanks(p, end);
+			const char * nameStart = p;
+			while (p < end && *p != '\n' && *p != '\r')
+				p++;
+			if (out_objects != NULL) {
+				size_t triangles = (out_vertices.size() - firstOutput) / 3;
+				closeObject(out_objects, triangles);
+				// A section without faces (e.g. 'o' directly followed by 'g') is replaced
+				if (!out_objects->empty() && out_objects->back().triangleCount == 0)
+					out_objects->pop_back();
+				ObjObject object;
+				object.name.assign(nameStart, p);
+				object.firstTriangle = triangles;
+				object.triangleCount = 0;
+				out_objects->push_back(object);
+			}
+		}
+
+		// Comments, s, usemtl, mtllib, trailing values we ignore, ...
+		skipLine(p, end);
+		continue;
+
+	malformed:
+		printf("Malformed OBJ line %d\n", lineNumber);
+		return false;
+	}
+
+	closeObject(out_objects, (out_vertices.size() - firstOutput) / 3);
+	out_uvs.resize(anyUV ? firstUV + (out_vertices.size() - firstOutput) : firstUV, glm::vec2(0.0f));
+	return true;
+}
+
+bool parseOBJ(
+	const char * path,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec2> & out_uvs,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<ObjObject> * out_objects
+){
+	printf("Loading OBJ file %s...\n", path);
+
+	MappedFile file;
+	if (!file.open(path)) {
+		printf("Impossible to open the file ! Are you in the right path ? See Tutorial 1 for details\n");
+		return false;
+	}
+	return parseOBJFromMemory(file.data(), file.size(), out_vertices, out_uvs, out_normals, out_objects);
+}
@@ -0,0 +1,37 @@
+#ifndef OBJPARSER_HPP
+#define OBJPARSER_HPP
+
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+
+// A named 'o' or 'g' section of an OBJ file, as a range of output triangles
+struct ObjObject {
+	std::string name;
+	size_t firstTriangle;
+	size_t triangleCount;
+};
+
+// Single-pass OBJ parser over a memory-mapped file, with a hand-written number lexer.
+// Supports v, vt, vn, faces with any number of corners (fan-triangulated), every
+// v, v/vt, v//vn, v/vt/vn corner form, negative (relative) indices and o/g sections.
+// Outputs the same unindexed triangle lists as loadOBJ(), 3 entries per triangle.
+// Corners without a normal get the face normal; out_uvs stays empty when the file has no vt.
+bool parseOBJ(
+	const char * path,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec2> & out_uvs,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<ObjObject> * out_objects = NULL
+);
+
+// Same, from text already in memory
+bool parseOBJFromMemory(
+	const char * text, size_t length,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec2> & out_uvs,
+	std::vector<glm::vec3> & out_normals,
+	std::vector<ObjObject> * out_objects = NULL
+);
+
+#endif
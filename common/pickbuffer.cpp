@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "pickbuffer.hpp"
+
+AsyncPicker::AsyncPicker()
+	: region(0), framebuffer(0), colorBuffer(0), depthBuffer(0), head(0), numPending(0), savedFramebuffer(0) {
+}
+
+bool AsyncPicker::init(int regionSize, int ringSize) {
+	region = regionSize | 1;	// odd, so there is a center pixel
+
+	// Leave whatever framebuffer is bound (e.g. the headless target) bound afterwards
+	GLint previousFramebuffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glGenRenderbuffers(1, &colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, region, region);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+	glGenRenderbuffers(1, &depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, region, region);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+	bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+	if (!complete) {
+		fprintf(stderr, "ERROR: Picking framebuffer is incomplete\n");
+		return false;
+	}
+
+	pbos.resize(ringSize);
+	fences.assign(ringSize, (GLsync)0);
+	glGenBuffers(ringSize, &pbos[0]);
+	for (int i = 0; i < ringSize; i++) {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+		glBufferData(GL_PIXEL_PACK_BUFFER, region * region * 4, NULL, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	head = 0;
+	numPending = 0;
+	return true;
+}
+
+void AsyncPicker::cleanup(void) {
+	for (size_t i = 0; i < fences.size(); i++) {
+		if (fences[i])
+			glDeleteSync(fences[i]);
+	}
+	fences.clear();
+	if (!pbos.empty())
+		glDeleteBuffers((GLsizei)pbos.size(), &pbos[0]);
+	pbos.clear();
+	glDeleteRenderbuffers(1, &colorBuffer);
+	glDeleteRenderbuffers(1, &depthBuffer);
+	glDeleteFramebuffers(1, &framebuffer);
+	numPending = 0;
+}
+
+bool AsyncPicker::begin(double xpos, double ypos, int windowWidth, int windowHeight, glm::mat4 & out_pickMatrix) {
+	if (pbos.empty() || numPending == (int)pbos.size())
+		return false;
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &savedFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, savedViewport);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glViewport(0, 0, region, region);
+
+	// Like gluPickMatrix: scale and shift NDC so the region centered on the cursor maps to [-1, 1]
+	float cx = 2.0f * (float)(xpos + 0.5) / windowWidth - 1.0f;
+	float cy = 1.0f - 2.0f * (float)(ypos + 0.5) / windowHeight;
+	float sx = (float)windowWidth / region, sy = (float)windowHeight / region;
+	out_pickMatrix = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(-cx * sx, -cy * sy, 0.0f)), glm::vec3(sx, sy, 1.0f));
+	return true;
+}
+
+void AsyncPicker::end(void) {
+	// Start the copy into the PBO; glReadPixels returns immediately with a pack buffer bound
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[head]);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, region, region, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	fences[head] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	head = (head + 1) % (int)pbos.size();
+	numPending++;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, savedFramebuffer);
+	glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+}
+
+bool AsyncPicker::poll(int & out_id) {
+	if (numPending == 0)
+		return false;
+
+	int oldest = (head - numPending + (int)pbos.size()) % (int)pbos.size();
+	GLenum status = glClientWaitSync(fences[oldest], 0, 0);
+	if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		return false;
+	glDeleteSync(fences[oldest]);
+	fences[oldest] = 0;
+	numPending--;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[oldest]);
+	const unsigned char * pixels = (const unsigned char *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, region * region * 4, GL_MAP_READ_BIT);
+	out_id = 255;
+	if (pixels != NULL) {
+		// The center pixel wins; otherwise the closest non-background pixel in the region,
+		// which makes thin parts (the pen, the button) easier to click
+		int center = region / 2, bestDistance = region * region;
+		for (int y = 0; y < region; y++) {
+			for (int x = 0; x < region; x++) {
+				int id = pixels[(y * region + x) * 4];
+				int distance = (x - center) * (x - center) + (y - center) * (y - center);
+				if (id != 255 && distance < bestDistance) {
+					bestDistance = distance;
+					out_id = id;
+				}
+			}
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	return true;
+}
@@ -0,0 +1,43 @@
+#ifndef PICKBUFFER_HPP
+#define PICKBUFFER_HPP
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// GPU picking without stalling: IDs are rendered into a tiny framebuffer that only covers
+// the pixels around the cursor, read into a ring of pixel buffer objects, and fetched once
+// their fence has signaled, normally on the next frame.
+class AsyncPicker {
+public:
+	AsyncPicker();
+
+	// regionSize: odd width/height in pixels of the area around the cursor that gets rendered
+	bool init(int regionSize, int ringSize);
+	void cleanup(void);
+
+	// Binds the picking framebuffer and returns the matrix to apply on top of the projection
+	// so the region around (xpos, ypos) (window coordinates, (0,0) top left) fills it.
+	// Returns false when every ring slot is still in flight.
+	bool begin(double xpos, double ypos, int windowWidth, int windowHeight, glm::mat4 & out_pickMatrix);
+	// Queues the asynchronous readback and restores the previous framebuffer and viewport
+	void end(void);
+
+	// Returns true with the ID of the oldest finished request (255 = background).
+	// Never waits: unfinished requests stay queued.
+	bool poll(int & out_id);
+
+	int pending(void) const { return numPending; }
+
+private:
+	int region;
+	GLuint framebuffer, colorBuffer, depthBuffer;
+	std::vector<GLuint> pbos;
+	std::vector<GLsync> fences;
+	int head;           // next slot to fill
+	int numPending;
+	GLint savedFramebuffer;
+	GLint savedViewport[4];
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <chrono>
+
+// Not counted by glcallcount.hpp: the profiler's queries should not show up in the GL calls it reports
+#include <GL/glew.h>
+
+#include "profiler.hpp"
+
+Profiler::Profiler()
+	: epoch(std::chrono::steady_clock::now()), gpuTimers(false), gpuDepth(0), gpuQueryOpen(false), tracing(false) {
+}
+
+void Profiler::init(void) {
+	gpuTimers = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+	if (!gpuTimers)
+		fprintf(stderr, "Profiler: no timer queries, GPU passes are not timed\n");
+}
+
+void Profiler::cleanup(void) {
+	if (gpuQueryOpen)
+		glEndQuery(GL_TIME_ELAPSED);
+	gpuQueryOpen = false;
+	gpuDepth = 0;
+	for (size_t i = 0; i < pending.size(); i++)
+		freeQueries.push_back(pending[i].query);
+	pending.clear();
+	if (!freeQueries.empty())
+		glDeleteQueries((GLsizei)freeQueries.size(), &freeQueries[0]);
+	freeQueries.clear();
+}
+
+double Profiler::nowUs(void) const {
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+int Profiler::findStat(const char * name, bool gpu) const {
+	for (size_t i = 0; i < stats.size(); i++) {
+		if (stats[i].gpu == gpu && (stats[i].name == name || strcmp(stats[i].name, name) == 0))
+			return (int)i;
+	}
+	return -1;
+}
+
+int Profiler::statIndex(const char * name, bool gpu, int depth) {
+	int index = findStat(name, gpu);
+	if (index >= 0)
+		return index;
+	Stat stat;
+	stat.name = name;
+	stat.gpu = gpu;
+	stat.depth = depth;
+	stat.next = 0;
+	stat.samples.reserve(SampleWindow);
+	stats.push_back(stat);
+	return (int)stats.size() - 1;
+}
+
+void Profiler::addSample(int stat, double startUs, double durationUs) {
+	Stat & s = stats[stat];
+	const float ms = (float)(durationUs / 1000.0);
+	if (s.samples.size() < (size_t)SampleWindow)
+		s.samples.push_back(ms);
+	else
+		s.samples[s.next] = ms;
+	s.next = (s.next + 1) % SampleWindow;
+
+	if (tracing && trace.size() < MaxTraceEvents) {
+		TraceEvent event = { stat, startUs, durationUs };
+		trace.push_back(event);
+	}
+}
+
+void Profiler::beginFrame(void) {
+	beginCpu("frame");
+}
+
+void Profiler::endFrame(void) {
+	endCpu();
+	collectGpu();
+}
+
+void Profiler::beginCpu(const char * name) {
+	OpenScope scope = { statIndex(name, false, (int)cpuStack.size()), nowUs() };
+	cpuStack.push_back(scope);
+}
+
+void Profiler::endCpu(void) {
+	if (cpuStack.empty())
+		return;
+	const OpenScope scope = cpuStack.back();
+	cpuStack.pop_back();
+	addSample(scope.stat, scope.startUs, nowUs() - scope.startUs);
+}
+
+void Profiler::beginGpu(const char * name) {
+	if (gpuDepth++ > 0 || !gpuTimers)
+		return;
+	GLuint query;
+	if (freeQueries.empty()) {
+		glGenQueries(1, &query);
+	}
+	else {
+		query = freeQueries.back();
+		freeQueries.pop_back();
+	}
+	PendingQuery p = { query, statIndex(name, true, 0), nowUs() };
+	pending.push_back(p);
+	glBeginQuery(GL_TIME_ELAPSED, query);
+	gpuQueryOpen = true;
+}
+
+void Profiler::endGpu(void) {
+	if (gpuDepth == 0 || --gpuDepth > 0 || !gpuQueryOpen)
+		return;
+	glEndQuery(GL_TIME_ELAPSED);
+	gpuQueryOpen = false;
+}
+
+// Queries finish in the order they were issued: stop at the first one still in flight
+void Profiler::collectGpu(void) {
+	while (!pending.empty()) {
+		const PendingQuery p = pending.front();
+		if (gpuQueryOpen && pending.size() == 1)
+			break;      // the pass still being recorded
+		GLint available = 0;
+		glGetQueryObjectiv(p.query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+		GLuint64 elapsedNs = 0;
+		glGetQueryObjectui64v(p.query, GL_QUERY_RESULT, &elapsedNs);
+		addSample(p.stat, p.startUs, elapsedNs / 1000.0);
+		freeQueries.push_back(p.query);
+		pending.pop_front();
+	}
+}
+
+double Profiler::percentile(const char * name, bool gpu, double p) const {
+	const int index = findStat(name, gpu);
+	if (index < 0 || stats[index].samples.empty())
+		return 0.0;
+	std::vector<float> sorted(stats[index].samples);
+	size_t k = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+	k = std::min(k, sorted.size() - 1);
+	std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+	return sorted[k];
+}
+
+void Profiler::printSummary(void) const {
+	printf("%-28s %9s %9s %9s\n", "scope (ms)", "p50", "p95", "p99");
+	for (int gpu = 0; gpu < 2; gpu++) {
+		for (size_t i = 0; i < stats.size(); i++) {
+			const Stat & s = stats[i];
+			if (s.gpu != (gpu == 1))
+				continue;
+			char label[64];
+			snprintf(label, sizeof(label), "%s%*s%s", s.gpu ? "gpu " : "cpu ", 2 * s.depth, "", s.name);
+			printf("%-28s %9.3f %9.3f %9.3f\n", label, percentile(s.name, s.gpu, 50.0), percentile(s.name, s.gpu, 95.0),
+				percentile(s.name, s.gpu, 99.0));
+		}
+	}
+}
+
+void Profiler::startTrace(void) {
+	trace.clear();
+	tracing = true;
+}
+
+// Complete ("X") events on two rows, CPU and GPU. GPU passes are placed at the CPU time they
+// were issued, since GL_TIME_ELAPSED only gives their length.
+bool Profiler::writeTrace(const char * path) {
+	tracing = false;
+	FILE * file = fopen(path, "w");
+	if (file == NULL) {
+		fprintf(stderr, "Could not write %s\n", path);
+		return false;
+	}
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+	for (size_t i = 0; i < trace.size(); i++) {
+		const TraceEvent & event = trace[i];
+		const Stat & s = stats[event.stat];
+		fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+			s.name, s.gpu ? "gpu" : "cpu", s.gpu ? 2 : 1, event.startUs, event.durationUs);
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	printf("trace: %d events written to %s\n", (int)trace.size(), path);
+	trace.clear();
+	return true;
+}
@@ -0,0 +1,105 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <deque>
+#include <vector>
+#include <chrono>
+
+#include <GL/glew.h>
+
+// Frame profiler. CPU scopes are timed with steady_clock and may nest; GPU passes are timed
+// with GL_TIME_ELAPSED queries whose results are only read once GL_QUERY_RESULT_AVAILABLE
+// says they are there, a frame or more later, so nothing waits on the GPU. Every scope keeps
+// its last SampleWindow samples for rolling percentiles, and a capture can be written as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+class Profiler {
+public:
+	static const int SampleWindow = 300;
+	static const size_t MaxTraceEvents = 1 << 20;
+
+	Profiler();
+
+	// GPU passes are only timed with GL 3.3 / ARB_timer_query
+	void init(void);
+	void cleanup(void);
+
+	// Brackets a frame with the "frame" CPU scope; endFrame() collects the GPU results that arrived
+	void beginFrame(void);
+	void endFrame(void);
+
+	// Names are kept by pointer: pass string literals
+	void beginCpu(const char * name);
+	void endCpu(void);
+	// GL_TIME_ELAPSED queries cannot nest, a pass begun inside another one counts towards the outer one
+	void beginGpu(const char * name);
+	void endGpu(void);
+
+	// Percentile p (0-100) of the scope's recent samples in ms, 0 when it has none
+	double percentile(const char * name, bool gpu, double p) const;
+	// p50/p95/p99 of every scope, CPU scopes indented by nesting depth
+	void printSummary(void) const;
+
+	// Records every scope from now on, up to MaxTraceEvents, until writeTrace()
+	void startTrace(void);
+	bool writeTrace(const char * path);
+
+private:
+	struct Stat {
+		const char * name;
+		bool gpu;
+		int depth;
+		std::vector<float> samples;     // ring of the last SampleWindow samples, in ms
+		size_t next;
+	};
+	struct OpenScope {
+		int stat;
+		double startUs;
+	};
+	struct PendingQuery {
+		GLuint query;
+		int stat;
+		double startUs;                 // CPU time the pass was issued, where the trace shows it
+	};
+	struct TraceEvent {
+		int stat;
+		double startUs;
+		double durationUs;
+	};
+
+	double nowUs(void) const;
+	int findStat(const char * name, bool gpu) const;
+	int statIndex(const char * name, bool gpu, int depth);
+	void addSample(int stat, double startUs, double durationUs);
+	void collectGpu(void);
+
+	std::chrono::steady_clock::time_point epoch;
+	std::vector<Stat> stats;
+	std::vector<OpenScope> cpuStack;
+	bool gpuTimers;
+	int gpuDepth;                       // open GPU scopes, only the outermost one has a query
+	bool gpuQueryOpen;
+	std::deque<PendingQuery> pending;
+	std::vector<GLuint> freeQueries;
+	bool tracing;
+	std::vector<TraceEvent> trace;
+};
+
+// Times the enclosing block as a CPU scope
+class ProfileScope {
+public:
+	ProfileScope(Profiler & profiler, const char * name) : profiler(profiler) { profiler.beginCpu(name); }
+	~ProfileScope() { profiler.endCpu(); }
+private:
+	Profiler & profiler;
+};
+
+// Times the GL commands issued in the enclosing block as a GPU pass
+class GpuProfileScope {
+public:
+	GpuProfileScope(Profiler & profiler, const char * name) : profiler(profiler) { profiler.beginGpu(name); }
+	~GpuProfileScope() { profiler.endGpu(); }
+private:
+	Profiler & profiler;
+};
+
+#endif
@@ -1,11 +1,17 @@
-#ifndef QUATERNION_UTILS_H
-#define QUATERNION_UTILS_H
-
-quat RotationBetweenVectors(vec3 start, vec3 dest);
-
-quat LookAt(vec3 direction, vec3 desiredUp);
-
-quat RotateTowards(quat q1, quat q2, float maxAngle);
-
-
+#ifndef QUATERNION_UTILS_H
+#define QUATERNION_UTILS_H
+
+quat RotationBetweenVectors(vec3 start, vec3 dest);
+
+quat LookAt(vec3 direction, vec3 desiredUp);
+
+quat RotateTowards(quat q1, quat q2, float maxAngle);
+
+quat Slerp(quat q1, quat q2, float t);
+
+quat SquadControlPoint(quat previous, quat q, quat next);
+
+quat Squad(quat q1, quat q2, quat s1, quat s2, float t);
+
+
 #endif // QUATERNION_UTILS_H
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef SIMDLANES_HPP
+#define SIMDLANES_HPP
+
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+// A tiny vector interface (V) for kernels written once and instantiated for AVX2 (8 lanes),
+// SSE4.1 (4 lanes) and plain floats (1 lane). BestLanes is the widest this build supports.
+
+struct ScalarLanes {
+	typedef float T;
+	enum { Width = 1 };
+	static T load(const float * p) { return *p; }
+	static void store(float * p, T v) { *p = v; }
+	static T set(float f) { return f; }
+	static T add(T a, T b) { return a + b; }
+	static T sub(T a, T b) { return a - b; }
+	static T mul(T a, T b) { return a * b; }
+	static T madd(T a, T b, T c) { return a * b + c; }
+	static T round(T a) { return std::floor(a + 0.5f); }
+	static T floor(T a) { return std::floor(a); }
+	static T neg(T a) { return -a; }
+	static T abs(T a) { return std::fabs(a); }
+	// Masks are 0/1 floats in the scalar path
+	static T cmpeq(T a, T b) { return a == b ? 1.0f : 0.0f; }
+	static T cmpge(T a, T b) { return a >= b ? 1.0f : 0.0f; }
+	static T orMask(T a, T b) { return (a != 0.0f || b != 0.0f) ? 1.0f : 0.0f; }
+	static T select(T mask, T a, T b) { return mask != 0.0f ? a : b; }
+};
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+struct SseLanes {
+	typedef __m128 T;
+	enum { Width = 4 };
+	static T load(const float * p) { return _mm_loadu_ps(p); }
+	static void store(float * p, T v) { _mm_storeu_ps(p, v); }
+	static T set(float f) { return _mm_set1_ps(f); }
+	static T add(T a, T b) { return _mm_add_ps(a, b); }
+	static T sub(T a, T b) { return _mm_sub_ps(a, b); }
+	static T mul(T a, T b) { return _mm_mul_ps(a, b); }
+	static T madd(T a, T b, T c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static T round(T a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static T floor(T a) { return _mm_floor_ps(a); }
+	static T neg(T a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+	static T abs(T a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static T cmpeq(T a, T b) { return _mm_cmpeq_ps(a, b); }
+	static T cmpge(T a, T b) { return _mm_cmpge_ps(a, b); }
+	static T orMask(T a, T b) { return _mm_or_ps(a, b); }
+	static T select(T mask, T a, T b) { return _mm_blendv_ps(b, a, mask); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct AvxLanes {
+	typedef __m256 T;
+	enum { Width = 8 };
+	static T load(const float * p) { return _mm256_loadu_ps(p); }
+	static void store(float * p, T v) { _mm256_storeu_ps(p, v); }
+	static T set(float f) { return _mm256_set1_ps(f); }
+	static T add(T a, T b) { return _mm256_add_ps(a, b); }
+	static T sub(T a, T b) { return _mm256_sub_ps(a, b); }
+	static T mul(T a, T b) { return _mm256_mul_ps(a, b); }
+#if defined(__FMA__)
+	static T madd(T a, T b, T c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+	static T madd(T a, T b, T c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+	static T round(T a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static T floor(T a) { return _mm256_floor_ps(a); }
+	static T neg(T a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+	static T abs(T a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static T cmpeq(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+	static T cmpge(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static T orMask(T a, T b) { return _mm256_or_ps(a, b); }
+	static T select(T mask, T a, T b) { return _mm256_blendv_ps(b, a, mask); }
+};
+#endif
+
+#if defined(__AVX2__)
+typedef AvxLanes BestLanes;
+#elif defined(__SSE4_1__) || defined(__AVX__)
+typedef SseLanes BestLanes;
+#else
+typedef ScalarLanes BestLanes;
+#endif
+
+#endif
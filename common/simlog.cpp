@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "simlog.hpp"
+
+static const char SimLogMagic[4] = { 'A', 'R', 'M', 'L' };
+// Encoded ticks are written out once this many bytes have piled up
+static const size_t SimLogBlockBytes = 64 * 1024;
+
+static void jointValues(const ArmJoints & joints, float values[SimLogValues]) {
+	values[0] = joints.baseTranslate.x;
+	values[1] = joints.baseTranslate.y;
+	values[2] = joints.baseTranslate.z;
+	values[3] = joints.topRotate;
+	values[4] = joints.arm1Rotate;
+	values[5] = joints.arm2Rotate;
+	values[6] = joints.penRotateLongitude;
+	values[7] = joints.penRotateLatitude;
+	values[8] = joints.penRotateAxis;
+}
+
+static ArmJoints jointsFromValues(const float values[SimLogValues]) {
+	ArmJoints joints;
+	joints.baseTranslate = glm::vec3(values[0], values[1], values[2]);
+	joints.topRotate = values[3];
+	joints.arm1Rotate = values[4];
+	joints.arm2Rotate = values[5];
+	joints.penRotateLongitude = values[6];
+	joints.penRotateLatitude = values[7];
+	joints.penRotateAxis = values[8];
+	return joints;
+}
+
+static unsigned int floatBits(float f) {
+	unsigned int bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+static float bitsFloat(unsigned int bits) {
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+// 7 bits per byte, low first, high bit set on every byte but the last
+static void putVarint(std::vector<unsigned char> & out, unsigned int value) {
+	while (value >= 0x80) {
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+static bool getVarint(const unsigned char * data, size_t size, size_t & cursor, unsigned int & value) {
+	value = 0;
+	for (int shift = 0; shift < 35; shift += 7) {
+		if (cursor >= size)
+			return false;
+		const unsigned char byte = data[cursor++];
+		value |= (unsigned int)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+// Small differences either way become small unsigned numbers: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+static unsigned int zigzag(unsigned int delta) {
+	return (delta << 1) ^ (unsigned int)((int)delta >> 31);
+}
+
+static unsigned int unzigzag(unsigned int value) {
+	return (value >> 1) ^ (0u - (value & 1));
+}
+
+SimRecorder::SimRecorder() : file(NULL), failed(false), speedScale(1.0f), ticks(0), bytes(0) {
+	memset(previous, 0, sizeof(previous));
+	memset(step, 0, sizeof(step));
+}
+
+SimRecorder::~SimRecorder() {
+	close();
+}
+
+bool SimRecorder::open(const char * path, double tickSeconds, const SimState & initial) {
+	close();
+	file = fopen(path, "wb");
+	if (file == NULL)
+		return false;
+
+	SimLogHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SimLogMagic, 4);
+	header.version = SimLogVersion;
+	header.tickSeconds = tickSeconds;
+	jointValues(initial.joints, header.initial);
+	header.initial[SimLogValues] = initial.cameraAngles.x;
+	header.initial[SimLogValues + 1] = initial.cameraAngles.y;
+	header.initial[SimLogValues + 2] = initial.cellTime;
+	jointValues(initial.jointVelocities, header.initialVelocity);
+	header.initialVelocity[SimLogValues] = initial.cameraVelocity.x;
+	header.initialVelocity[SimLogValues + 1] = initial.cameraVelocity.y;
+	if (fwrite(&header, sizeof(header), 1, file) != 1) {
+		fclose(file);
+		file = NULL;
+		return false;
+	}
+
+	for (int i = 0; i < SimLogValues; i++)
+		previous[i] = floatBits(header.initial[i]);
+	memset(step, 0, sizeof(step));
+	speedScale = 1.0f;
+	failed = false;
+	ticks = 0;
+	bytes = sizeof(header);
+	buffer.clear();
+	buffer.reserve(SimLogBlockBytes + 64);
+	return true;
+}
+
+bool SimRecorder::flush(void) {
+	if (file != NULL && !failed && !buffer.empty()) {
+		if (fwrite(&buffer[0], 1, buffer.size(), file) == buffer.size())
+			bytes += buffer.size();
+		else
+			failed = true;
+	}
+	buffer.clear();
+	return !failed;
+}
+
+bool SimRecorder::close(void) {
+	if (file == NULL)
+		return true;
+	bool ok = flush();
+	ok = fclose(file) == 0 && ok;
+	file = NULL;
+	return ok;
+}
+
+bool SimRecorder::record(const SimInput & input, const SimState & state) {
+	if (file == NULL || failed)
+		return false;
+	float values[SimLogValues];
+	jointValues(state.joints, values);
+	unsigned int residual[SimLogValues];
+	unsigned int missed = 0;
+	for (int i = 0; i < SimLogValues; i++) {
+		const unsigned int bits = floatBits(values[i]);
+		residual[i] = bits - (previous[i] + step[i]);
+		if (residual[i] != 0)
+			missed |= 1u << i;
+		step[i] = bits - previous[i];
+		previous[i] = bits;
+	}
+
+	const bool speedChanged = input.speedScale != speedScale;
+	const unsigned int keys = (input.keys.left ? 1 : 0) | (input.keys.right ? 2 : 0) | (input.keys.up ? 4 : 0) |
+		(input.keys.down ? 8 : 0);
+	putVarint(buffer, (unsigned int)input.target | keys << 3 | (input.shift ? 1u : 0u) << 7 | (speedChanged ? 1u : 0u) << 8 |
+		missed << 9);
+	if (speedChanged) {
+		const unsigned int bits = floatBits(input.speedScale);
+		for (int i = 0; i < 4; i++)
+			buffer.push_back((unsigned char)(bits >> (8 * i)));
+		speedScale = input.speedScale;
+	}
+	for (int i = 0; i < SimLogValues; i++) {
+		if (missed & (1u << i))
+			putVarint(buffer, zigzag(residual[i]));
+	}
+	ticks++;
+	if (buffer.size() >= SimLogBlockBytes)
+		return flush();
+	return true;
+}
+
+SimReplay::SimReplay() : cursor(0), speedScale(1.0f), ticks(0) {
+	memset(&header, 0, sizeof(header));
+	memset(previous, 0, sizeof(previous));
+	memset(step, 0, sizeof(step));
+}
+
+bool SimReplay::open(const char * path) {
+	close();
+	if (!log.open(path) || log.size() < sizeof(header)) {
+		log.close();
+		return false;
+	}
+	memcpy(&header, log.data(), sizeof(header));
+	if (memcmp(header.magic, SimLogMagic, 4) != 0 || header.version != SimLogVersion || !(header.tickSeconds > 0.0)) {
+		log.close();
+		return false;
+	}
+	for (int i = 0; i < SimLogValues; i++)
+		previous[i] = floatBits(header.initial[i]);
+	memset(step, 0, sizeof(step));
+	cursor = sizeof(header);
+	speedScale = 1.0f;
+	ticks = 0;
+	return true;
+}
+
+void SimReplay::close(void) {
+	log.close();
+	cursor = 0;
+	ticks = 0;
+}
+
+SimState SimReplay::getInitial(void) const {
+	SimState state;
+	state.joints = jointsFromValues(header.initial);
+	state.cameraAngles = glm::vec2(header.initial[SimLogValues], header.initial[SimLogValues + 1]);
+	state.cellTime = header.initial[SimLogValues + 2];
+	state.jointVelocities = jointsFromValues(header.initialVelocity);
+	state.cameraVelocity = glm::vec2(header.initialVelocity[SimLogValues], header.initialVelocity[SimLogValues + 1]);
+	return state;
+}
+
+bool SimReplay::next(SimInput & input, ArmJoints & recorded) {
+	if (!log.isOpen())
+		return false;
+	const unsigned char * data = (const unsigned char *)log.data();
+	const size_t size = log.size();
+	size_t at = cursor;
+	unsigned int flags;
+	if (!getVarint(data, size, at, flags) || (flags & 7) > CONTROL_PEN)
+		return false;
+	if (flags & 0x100) {
+		if (at + 4 > size)
+			return false;
+		speedScale = bitsFloat((unsigned int)data[at] | (unsigned int)data[at + 1] << 8 |
+			(unsigned int)data[at + 2] << 16 | (unsigned int)data[at + 3] << 24);
+		at += 4;
+	}
+
+	unsigned int bits[SimLogValues];
+	for (int i = 0; i < SimLogValues; i++) {
+		unsigned int residual = 0;
+		if ((flags & (0x200u << i)) && !getVarint(data, size, at, residual))
+			return false;
+		bits[i] = previous[i] + step[i] + unzigzag(residual);
+	}
+
+	float values[SimLogValues];
+	for (int i = 0; i < SimLogValues; i++) {
+		step[i] = bits[i] - previous[i];
+		previous[i] = bits[i];
+		values[i] = bitsFloat(bits[i]);
+	}
+	cursor = at;
+	ticks++;
+
+	input.target = (ControlTarget)(flags & 7);
+	input.keys.left = (flags & 0x08) != 0;
+	input.keys.right = (flags & 0x10) != 0;
+	input.keys.up = (flags & 0x20) != 0;
+	input.keys.down = (flags & 0x40) != 0;
+	input.shift = (flags & 0x80) != 0;
+	input.speedScale = speedScale;
+	recorded = jointsFromValues(values);
+	return true;
+}
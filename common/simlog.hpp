@@ -0,0 +1,97 @@
+#ifndef SIMLOG_HPP
+#define SIMLOG_HPP
+
+#include <stdio.h>
+#include <vector>
+
+#include "simulation.hpp"
+#include "mappedfile.hpp"
+
+// Binary log of a session, one record per simulation tick:
+//   SimLogHeader
+//   per tick: varint  target | keys << 3 | shift << 7 | speed changed << 8 | missed << 9
+//             float   speedScale                            (only when it changed)
+//             varint  zigzag(bits - predicted bits)         per joint value set in missed
+// Joint values (J0 x, y, z, J1..J6) are predicted from their float bit patterns over the two
+// ticks before, as if they kept moving by the same step. A joint at rest or at a steady speed
+// usually lands on its prediction and costs nothing past its bit in missed, and the log is
+// lossless. Native byte order, like the mesh cache.
+// The header holds the whole state the session started from, velocities included, so a
+// replay can start from it whatever state the arm is in.
+
+const unsigned int SimLogVersion = 2;
+const int SimLogValues = 9;
+
+struct SimLogHeader {
+	char magic[4];              // "ARML"
+	unsigned int version;
+	double tickSeconds;
+	float initial[SimLogValues + 3];    // joints, camera angles, cell time
+	float initialVelocity[SimLogValues + 2];    // joints, camera angles
+};
+
+// Appends ticks to a log file. Records are encoded into a buffer that is written out in
+// large blocks, so a tick costs a few dozen nanoseconds. Used from one thread at a time.
+class SimRecorder {
+public:
+	SimRecorder();
+	~SimRecorder();
+
+	bool open(const char * path, double tickSeconds, const SimState & initial);
+	// Writes what is buffered and closes the file. False when some of the log could not be
+	// written (a full disk), so the file ends early.
+	bool close(void);
+	bool isOpen(void) const { return file != NULL; }
+
+	// One tick: the input it was stepped with and the state it reached. False once a block
+	// could not be written; later ticks are dropped rather than leave a gap in the log.
+	bool record(const SimInput & input, const SimState & state);
+
+	unsigned long long getTicks(void) const { return ticks; }
+	unsigned long long getBytes(void) const { return bytes + buffer.size(); }
+
+private:
+	SimRecorder(const SimRecorder &);
+	SimRecorder & operator=(const SimRecorder &);
+
+	bool flush(void);
+
+	FILE * file;
+	bool failed;                // a write fell short
+	std::vector<unsigned char> buffer;
+	unsigned int previous[SimLogValues];
+	unsigned int step[SimLogValues];
+	float speedScale;
+	unsigned long long ticks;
+	unsigned long long bytes;   // already written to the file
+};
+
+// Reads a log back tick by tick, from a mapping of the file
+class SimReplay {
+public:
+	SimReplay();
+
+	bool open(const char * path);
+	void close(void);
+	bool isOpen(void) const { return log.isOpen(); }
+
+	double getTickSeconds(void) const { return header.tickSeconds; }
+	SimState getInitial(void) const;
+
+	// The next tick's input, and the joints the recording reached with it. False at the end
+	// of the log (or at a damaged record).
+	bool next(SimInput & input, ArmJoints & recorded);
+
+	unsigned long long getTicks(void) const { return ticks; }
+
+private:
+	MappedFile log;
+	SimLogHeader header;
+	size_t cursor;
+	unsigned int previous[SimLogValues];
+	unsigned int step[SimLogValues];
+	float speedScale;
+	unsigned long long ticks;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include <glm/glm.hpp>
+
+#include "simulation.hpp"
+#include "simlog.hpp"
+
+void stepSimulation(const SimInput & input, SimState & state, float dt) {
+	const ControlInput none;
+	const ControlConfig & config = getControlConfig();
+	const float scale = input.speedScale;
+	const ControlInput & camera = input.target == CONTROL_CAMERA ? input.keys : none;
+	const ControlInput & base = input.target == CONTROL_BASE ? input.keys : none;
+	const ControlInput & top = input.target == CONTROL_TOP ? input.keys : none;
+	const ControlInput & arm1 = input.target == CONTROL_ARM1 ? input.keys : none;
+	const ControlInput & arm2 = input.target == CONTROL_ARM2 ? input.keys : none;
+	const ControlInput & penLongLat = input.target == CONTROL_PEN && !input.shift ? input.keys : none;
+	const ControlInput & penAxis = input.target == CONTROL_PEN && input.shift ? input.keys : none;
+
+	stepCameraAngles(state.cameraAngles, state.cameraVelocity, camera, scale, dt);
+	// Same keys per joint as the Update* functions of controls.cpp
+	ArmJoints & joints = state.joints;
+	ArmJoints & velocities = state.jointVelocities;
+	joints.baseTranslate.x = stepControlAxis(joints.baseTranslate.x, velocities.baseTranslate.x,
+		controlDirection(base.left, base.right), config.baseTranslate, scale, dt);
+	joints.baseTranslate.z = stepControlAxis(joints.baseTranslate.z, velocities.baseTranslate.z,
+		controlDirection(base.up, base.down), config.baseTranslate, scale, dt);
+	joints.topRotate = stepControlAxis(joints.topRotate, velocities.topRotate,
+		controlDirection(top.left, top.right), config.topRotate, scale, dt);
+	joints.arm1Rotate = stepControlAxis(joints.arm1Rotate, velocities.arm1Rotate,
+		controlDirection(arm1.left, arm1.right), config.armRotate, scale, dt);
+	joints.arm2Rotate = stepControlAxis(joints.arm2Rotate, velocities.arm2Rotate,
+		controlDirection(arm2.left, arm2.right), config.armRotate, scale, dt);
+	joints.penRotateLongitude = stepControlAxis(joints.penRotateLongitude, velocities.penRotateLongitude,
+		controlDirection(penLongLat.right, penLongLat.left), config.penRotate, scale, dt);
+	joints.penRotateLatitude = stepControlAxis(joints.penRotateLatitude, velocities.penRotateLatitude,
+		controlDirection(penLongLat.up, penLongLat.down), config.penRotate, scale, dt);
+	joints.penRotateAxis = stepControlAxis(joints.penRotateAxis, velocities.penRotateAxis,
+		controlDirection(penAxis.left, penAxis.right), config.penRotate, scale, dt);
+	state.cellTime += dt;
+}
+
+SimState interpolateSimState(const SimSnapshot & snapshot, double tickSeconds, double t) {
+	const float a = (float)std::min(std::max((t - (snapshot.time - tickSeconds)) / tickSeconds, 0.0), 1.0);
+	const SimState & p = snapshot.previous;
+	const SimState & c = snapshot.current;
+	SimState s;
+	s.joints.baseTranslate = glm::mix(p.joints.baseTranslate, c.joints.baseTranslate, a);
+	s.joints.topRotate = glm::mix(p.joints.topRotate, c.joints.topRotate, a);
+	s.joints.arm1Rotate = glm::mix(p.joints.arm1Rotate, c.joints.arm1Rotate, a);
+	s.joints.arm2Rotate = glm::mix(p.joints.arm2Rotate, c.joints.arm2Rotate, a);
+	s.joints.penRotateLongitude = glm::mix(p.joints.penRotateLongitude, c.joints.penRotateLongitude, a);
+	s.joints.penRotateLatitude = glm::mix(p.joints.penRotateLatitude, c.joints.penRotateLatitude, a);
+	s.joints.penRotateAxis = glm::mix(p.joints.penRotateAxis, c.joints.penRotateAxis, a);
+	s.cameraAngles = glm::mix(p.cameraAngles, c.cameraAngles, a);
+	s.cellTime = glm::mix(p.cellTime, c.cellTime, a);
+	// Only drawn, never stepped: the velocities are the latest tick's
+	s.jointVelocities = c.jointVelocities;
+	s.cameraVelocity = c.cameraVelocity;
+	return s;
+}
+
+ArmSimulation::ArmSimulation()
+	: running(false), ticks(0), epoch(std::chrono::steady_clock::now()), tickSeconds(0.001), haveSnapshot(false) {
+}
+
+ArmSimulation::~ArmSimulation() {
+	stop();
+}
+
+void ArmSimulation::start(double rateHz, const SimState & initial, SimRecorder * recorder) {
+	stop();
+	tickSeconds = 1.0 / rateHz;
+	ticks.store(0);
+	haveSnapshot = false;
+	epoch = std::chrono::steady_clock::now();
+	running.store(true);
+	thread = std::thread(&ArmSimulation::run, this, initial, recorder);
+}
+
+void ArmSimulation::stop(void) {
+	running.store(false);
+	if (thread.joinable())
+		thread.join();
+}
+
+double ArmSimulation::now(void) const {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+bool ArmSimulation::latest(SimSnapshot & out) {
+	haveSnapshot = snapshots.update() || haveSnapshot;
+	if (haveSnapshot)
+		out = snapshots.readBuffer();
+	return haveSnapshot;
+}
+
+void ArmSimulation::run(SimState state, SimRecorder * recorder) {
+	const std::chrono::duration<double> tick(tickSeconds);
+	std::chrono::steady_clock::time_point next = epoch;
+	SimInput input;
+	while (running.load(std::memory_order_relaxed)) {
+		if (inputs.update())
+			input = inputs.readBuffer();
+
+		SimSnapshot & snapshot = snapshots.writeBuffer();
+		snapshot.previous = state;
+		stepSimulation(input, state, (float)tickSeconds);
+		if (recorder != NULL)
+			recorder->record(input, state);
+		snapshot.current = state;
+		// Stamped with the time the tick was due, so the reader knows how far along it is
+		snapshot.time = std::chrono::duration<double>(next - epoch).count();
+		snapshots.publish();
+		ticks.fetch_add(1, std::memory_order_relaxed);
+
+		next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(tick);
+		// More than a quarter of a second behind (the process was suspended): skip ahead
+		// instead of running the missed ticks back to back
+		const std::chrono::steady_clock::time_point current = std::chrono::steady_clock::now();
+		if (current - next > std::chrono::milliseconds(250))
+			next = current;
+		std::this_thread::sleep_until(next);
+	}
+}
@@ -0,0 +1,100 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <glm/glm.hpp>
+
+#include "controls.hpp"
+#include "kinematics.hpp"
+#include "triplebuffer.hpp"
+
+class SimRecorder;
+
+// What the arrow keys drive
+enum ControlTarget {
+	CONTROL_NONE = 0,
+	CONTROL_CAMERA,
+	CONTROL_BASE,
+	CONTROL_TOP,
+	CONTROL_ARM1,
+	CONTROL_ARM2,
+	CONTROL_PEN
+};
+
+// Everything the simulation reads from the render thread
+struct SimInput {
+	ControlInput keys;
+	ControlTarget target;
+	bool shift;             // the pen twists around its axis instead of turning
+	float speedScale;       // ControlConfig::speedScale
+
+	SimInput() : target(CONTROL_NONE), shift(false), speedScale(1.0f) {}
+};
+
+// Simulated state of the interactive arm, the camera and the work cell. The velocities are
+// the ones the controls ramp, per joint value, so a state carries everything a tick needs.
+struct SimState {
+	ArmJoints joints;
+	ArmJoints jointVelocities;  // units per second of each joint value
+	glm::vec2 cameraAngles;     // orbit angles (theta, phi), radians
+	glm::vec2 cameraVelocity;   // radians per second
+	float cellTime;             // clock of the work cell's canned motion, seconds
+};
+
+// The last two ticks, so the reader can interpolate between them
+struct SimSnapshot {
+	SimState previous;
+	SimState current;
+	double time;                // simulation clock at current, previous is one tick earlier
+};
+
+// Advances the state by one tick of dt: the target gets the keys, everything else is ticked
+// without, so a joint let go while moving eases to a stop. Only reads the limits of
+// getControlConfig(); the joints and velocities come from state alone.
+void stepSimulation(const SimInput & input, SimState & state, float dt);
+
+// Lerp between the two ticks of a snapshot, at time t on the simulation clock
+SimState interpolateSimState(const SimSnapshot & snapshot, double tickSeconds, double t);
+
+// Runs stepSimulation() at a fixed rate on its own thread. Input goes in and snapshots come
+// out through triple buffers, so neither thread ever waits on the other, and a slow frame
+// (a long glfwSwapBuffers) does not hold up the arm.
+class ArmSimulation {
+public:
+	ArmSimulation();
+	~ArmSimulation();
+
+	// recorder, when given, gets every tick from the simulation thread until stop()
+	void start(double rateHz, const SimState & initial, SimRecorder * recorder = NULL);
+	void stop(void);
+	bool isRunning(void) const { return thread.joinable(); }
+
+	// Render thread
+	void setInput(const SimInput & input) { inputs.write(input); }
+	// Latest snapshot; false until the first tick
+	bool latest(SimSnapshot & out);
+	// Seconds on the simulation clock
+	double now(void) const;
+	double getTickSeconds(void) const { return tickSeconds; }
+	unsigned long long getTicks(void) const { return ticks.load(std::memory_order_relaxed); }
+
+private:
+	ArmSimulation(const ArmSimulation &);
+	ArmSimulation & operator=(const ArmSimulation &);
+
+	void run(SimState state, SimRecorder * recorder);
+
+	std::thread thread;
+	std::atomic<bool> running;
+	std::atomic<unsigned long long> ticks;
+	std::chrono::steady_clock::time_point epoch;
+	double tickSeconds;
+	TripleBuffer<SimInput> inputs;
+	TripleBuffer<SimSnapshot> snapshots;
+	bool haveSnapshot;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "threadpool.hpp"
+
+ThreadPool::ThreadPool() : running(0), stopping(false) {
+}
+
+ThreadPool::~ThreadPool() {
+	stop();
+}
+
+void ThreadPool::start(int numThreads) {
+	stop();
+	if (numThreads <= 0)
+		numThreads = (int)std::thread::hardware_concurrency();
+	if (numThreads <= 0)
+		numThreads = 1;
+	stopping = false;
+	for (int i = 0; i < numThreads; i++)
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+void ThreadPool::stop(void) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	taskReady.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+}
+
+void ThreadPool::submit(const std::function<void()> & task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(task);
+	}
+	taskReady.notify_one();
+}
+
+void ThreadPool::wait(void) {
+	if (workers.empty())
+		return;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!tasks.empty() || running > 0)
+		allDone.wait(lock);
+}
+
+// Pool task of parallelForChunks(): takes chunks off nextChunk until there are none left
+static void runChunks(const std::function<void(size_t)> * chunk, size_t numChunks, std::atomic<size_t> * nextChunk) {
+	for (size_t c = nextChunk->fetch_add(1); c < numChunks; c = nextChunk->fetch_add(1))
+		(*chunk)(c);
+}
+
+void ThreadPool::parallelForChunks(size_t numChunks, const std::function<void(size_t)> & chunk) {
+	std::atomic<size_t> nextChunk(0);
+	if (size() <= 1 || numChunks <= 1) {
+		runChunks(&chunk, numChunks, &nextChunk);
+		return;
+	}
+	const int numTasks = (int)std::min(numChunks, (size_t)size());
+	for (int t = 0; t < numTasks; t++)
+		submit(std::bind(runChunks, &chunk, numChunks, &nextChunk));
+	wait();
+}
+
+void ThreadPool::workerLoop(void) {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		while (tasks.empty() && !stopping)
+			taskReady.wait(lock);
+		if (tasks.empty())
+			return;     // stopping, and nothing left to run
+
+		std::function<void()> task = tasks.front();
+		tasks.pop_front();
+		running++;
+		lock.unlock();
+		task();
+		lock.lock();
+		running--;
+		if (tasks.empty() && running == 0)
+			allDone.notify_all();
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of worker threads running tasks in submission order
+class ThreadPool {
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	// numThreads <= 0 uses one thread per hardware thread
+	void start(int numThreads);
+	// Runs the tasks already queued, then joins the workers
+	void stop(void);
+
+	void submit(const std::function<void()> & task);
+	// Blocks until the queue is empty and no task is running. Returns at once when the pool
+	// has not been started, since nothing would ever run the queued tasks.
+	void wait(void);
+
+	// Calls chunk(c) for every c in [0, numChunks) and returns when all are done. Each worker
+	// takes the next chunk as soon as it finishes one, so a slow chunk does not hold the others
+	// up. With fewer than two workers the chunks run in order on the calling thread.
+	void parallelForChunks(size_t numChunks, const std::function<void(size_t)> & chunk);
+
+	int size(void) const { return (int)workers.size(); }
+
+private:
+	ThreadPool(const ThreadPool &);
+	ThreadPool & operator=(const ThreadPool &);
+
+	void workerLoop(void);
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()> > tasks;
+	std::mutex mutex;
+	std::condition_variable taskReady;
+	std::condition_variable allDone;
+	int running;        // tasks taken off the queue but not finished
+	bool stopping;
+};
+
+#endif
@@ -0,0 +1,264 @@
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+using namespace glm;
+
+#include "quaternion_utils.hpp"
+#include "simdlanes.hpp"
+#include "trajectory.hpp"
+
+const float Pi = 3.14159265358979f;
+
+// The chain turns each joint by degrees(angle) radians (see jointRotation)
+static float toRadians(float jointAngle) {
+	return glm::degrees(jointAngle);
+}
+
+static float toJointAngle(float radians) {
+	return glm::radians(radians);
+}
+
+// Frame the wrist hangs from: top about Y, then arm1 and arm2 about X
+static glm::quat armFrame(float topRotate, float armRotate) {
+	return glm::angleAxis(toRadians(topRotate), glm::vec3(0.0f, 1.0f, 0.0f)) *
+		glm::angleAxis(toRadians(armRotate), glm::vec3(1.0f, 0.0f, 0.0f));
+}
+
+// Longitude about Z, latitude about X, axis twist about Y, radians
+static glm::quat wristRotation(const float angles[3]) {
+	return glm::angleAxis(angles[0], glm::vec3(0.0f, 0.0f, 1.0f)) * glm::angleAxis(angles[1], glm::vec3(1.0f, 0.0f, 0.0f)) *
+		glm::angleAxis(angles[2], glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+// a plus the whole turn that brings it closest to near
+static float nearestTurn(float a, float near) {
+	return a + 2.0f * Pi * floorf((near - a) / (2.0f * Pi) + 0.5f);
+}
+
+// J4-J6 of a wrist rotation, radians. Every rotation has two sets of angles (and whole turns
+// of each); this takes the one closest to near.
+static void wristAngles(const glm::quat & wrist, const float near[3], float angles[3]) {
+	// R = Rz(a) Rx(b) Ry(c) takes Y to (-sin a cos b, cos a cos b, sin b). Once a is known,
+	// Rx(b) Ry(c) = Rz(-a) R takes X to (cos c, ...) and Z to (sin c, ...).
+	const glm::mat3 m = glm::mat3_cast(wrist);
+	const float cosB = sqrtf(m[1].x * m[1].x + m[1].y * m[1].y);
+	const float b = atan2f(m[1].z, cosB);
+	float a, sinA, cosA;
+	if (cosB > 1e-6f) {
+		a = atan2f(-m[1].x, m[1].y);
+		sinA = -m[1].x / cosB;
+		cosA = m[1].y / cosB;
+	}
+	else {
+		// Gimbal lock (latitude +-90 degrees): longitude and twist turn about the same axis,
+		// keep the longitude
+		a = near[0];
+		sinA = sinf(a);
+		cosA = cosf(a);
+	}
+	const float c = atan2f(cosA * m[2].x + sinA * m[2].y, cosA * m[0].x + sinA * m[0].y);
+
+	const float first[3] = { nearestTurn(a, near[0]), nearestTurn(b, near[1]), nearestTurn(c, near[2]) };
+	const float second[3] = { nearestTurn(a + Pi, near[0]), nearestTurn(Pi - b, near[1]), nearestTurn(c + Pi, near[2]) };
+	float firstCost = 0.0f, secondCost = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		firstCost += (first[i] - near[i]) * (first[i] - near[i]);
+		secondCost += (second[i] - near[i]) * (second[i] - near[i]);
+	}
+	for (int i = 0; i < 3; i++)
+		angles[i] = firstCost <= secondCost ? first[i] : second[i];
+}
+
+static void channelValues(const ArmJoints & joints, float values[TrajectoryChannels]) {
+	values[0] = joints.baseTranslate.x;
+	values[1] = joints.baseTranslate.y;
+	values[2] = joints.baseTranslate.z;
+	values[3] = joints.topRotate;
+	values[4] = joints.arm1Rotate;
+	values[5] = joints.arm2Rotate;
+	values[6] = 0.0f;
+	values[7] = 0.0f;
+}
+
+// Horner's rule over the channels of one segment, V::Width channels at a time
+template <class V>
+inline void evaluateChannels(const float coefficients[6][TrajectoryChannels], float u, float values[TrajectoryChannels]) {
+	const typename V::T x = V::set(u);
+	for (int c = 0; c < TrajectoryChannels; c += V::Width) {
+		typename V::T v = V::load(&coefficients[5][c]);
+		for (int k = 4; k >= 0; k--)
+			v = V::madd(v, x, V::load(&coefficients[k][c]));
+		V::store(&values[c], v);
+	}
+}
+
+ArmTrajectory::ArmTrajectory() : endTime(0.0f) {
+}
+
+void ArmTrajectory::clear(void) {
+	segments.clear();
+	endTime = 0.0f;
+}
+
+bool ArmTrajectory::build(const TrajectoryKey * keys, size_t count, TrajectorySpline spline) {
+	clear();
+	if (count < 2)
+		return false;
+	for (size_t i = 1; i < count; i++) {
+		if (!(keys[i].time > keys[i - 1].time))
+			return false;
+	}
+
+	std::vector<float> values(count * TrajectoryChannels);
+	for (size_t i = 0; i < count; i++)
+		channelValues(keys[i].joints, &values[i * TrajectoryChannels]);
+
+	// Velocities: the slopes on either side of a key, each weighted by the other side's
+	// duration. Accelerations: how much the slope changes across the key. Zero at both ends.
+	std::vector<float> velocity(count * TrajectoryChannels, 0.0f), acceleration(count * TrajectoryChannels, 0.0f);
+	for (size_t i = 1; i + 1 < count; i++) {
+		const float before = keys[i].time - keys[i - 1].time, after = keys[i + 1].time - keys[i].time;
+		for (int c = 0; c < TrajectoryChannels; c++) {
+			const float slopeBefore = (values[i * TrajectoryChannels + c] - values[(i - 1) * TrajectoryChannels + c]) / before;
+			const float slopeAfter = (values[(i + 1) * TrajectoryChannels + c] - values[i * TrajectoryChannels + c]) / after;
+			velocity[i * TrajectoryChannels + c] = (after * slopeBefore + before * slopeAfter) / (before + after);
+			if (spline == SPLINE_QUINTIC)
+				acceleration[i * TrajectoryChannels + c] = 2.0f * (slopeAfter - slopeBefore) / (before + after);
+		}
+	}
+
+	// Pen world orientations, each on the same side of the sphere as the one before, so
+	// SQUAD takes the short way between keys
+	std::vector<glm::quat> orientation(count), control(count);
+	std::vector<float> wrist(count * 3);
+	for (size_t i = 0; i < count; i++) {
+		const ArmJoints & joints = keys[i].joints;
+		float * angles = &wrist[i * 3];
+		angles[0] = toRadians(joints.penRotateLongitude);
+		angles[1] = toRadians(joints.penRotateLatitude);
+		angles[2] = toRadians(joints.penRotateAxis);
+		orientation[i] = glm::normalize(armFrame(joints.topRotate, joints.arm1Rotate + joints.arm2Rotate) * wristRotation(angles));
+		if (i > 0 && dot(orientation[i], orientation[i - 1]) < 0.0f)
+			orientation[i] = orientation[i] * -1.0f;
+	}
+	for (size_t i = 0; i < count; i++) {
+		control[i] = (i == 0 || i + 1 == count) ? orientation[i] :
+			SquadControlPoint(orientation[i - 1], orientation[i], orientation[i + 1]);
+	}
+
+	segments.resize(count - 1);
+	for (size_t i = 0; i + 1 < count; i++) {
+		Segment & segment = segments[i];
+		const float duration = keys[i + 1].time - keys[i].time;
+		segment.start = keys[i].time;
+		segment.invDuration = 1.0f / duration;
+		// Hermite form in u: derivatives scale by the duration per order
+		for (int c = 0; c < TrajectoryChannels; c++) {
+			const float p0 = values[i * TrajectoryChannels + c], p1 = values[(i + 1) * TrajectoryChannels + c];
+			const float v0 = velocity[i * TrajectoryChannels + c] * duration;
+			const float v1 = velocity[(i + 1) * TrajectoryChannels + c] * duration;
+			const float a0 = acceleration[i * TrajectoryChannels + c] * duration * duration;
+			const float a1 = acceleration[(i + 1) * TrajectoryChannels + c] * duration * duration;
+			const float d = p1 - p0;
+			segment.coefficients[0][c] = p0;
+			segment.coefficients[1][c] = v0;
+			if (spline == SPLINE_QUINTIC) {
+				segment.coefficients[2][c] = 0.5f * a0;
+				segment.coefficients[3][c] = 10.0f * d - 6.0f * v0 - 4.0f * v1 - 0.5f * (3.0f * a0 - a1);
+				segment.coefficients[4][c] = -15.0f * d + 8.0f * v0 + 7.0f * v1 + 0.5f * (3.0f * a0 - 2.0f * a1);
+				segment.coefficients[5][c] = 6.0f * d - 3.0f * v0 - 3.0f * v1 - 0.5f * (a0 - a1);
+			}
+			else {
+				segment.coefficients[2][c] = 3.0f * d - 2.0f * v0 - v1;
+				segment.coefficients[3][c] = -2.0f * d + v0 + v1;
+				segment.coefficients[4][c] = 0.0f;
+				segment.coefficients[5][c] = 0.0f;
+			}
+		}
+		segment.q1 = orientation[i];
+		segment.q2 = orientation[i + 1];
+		segment.s1 = control[i];
+		segment.s2 = control[i + 1];
+		for (int k = 0; k < 3; k++) {
+			segment.wrist1[k] = wrist[i * 3 + k];
+			segment.wrist2[k] = wrist[(i + 1) * 3 + k];
+		}
+	}
+	endTime = keys[count - 1].time;
+	return true;
+}
+
+// The segment time falls in, searched from hint: a short walk when time moved on from the
+// hint's segment by a few segments, a binary search otherwise
+size_t ArmTrajectory::findSegment(float time, size_t hint) const {
+	const size_t last = segments.size() - 1;
+	for (int walk = 0; walk < 4; walk++) {
+		if (hint < last && time >= segments[hint + 1].start)
+			hint++;
+		else if (hint > 0 && time < segments[hint].start)
+			hint--;
+		else
+			return hint;
+	}
+	size_t lo = 0, hi = last;
+	while (lo < hi) {
+		const size_t mid = (lo + hi + 1) / 2;
+		if (time >= segments[mid].start)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return lo;
+}
+
+ArmJoints ArmTrajectory::evaluate(const Segment & segment, float time, const ArmJoints * previous) const {
+	const float u = std::min(std::max((time - segment.start) * segment.invDuration, 0.0f), 1.0f);
+	float values[TrajectoryChannels];
+	evaluateChannels<BestLanes>(segment.coefficients, u, values);
+
+	ArmJoints joints;
+	joints.baseTranslate = glm::vec3(values[0], values[1], values[2]);
+	joints.topRotate = values[3];
+	joints.arm1Rotate = values[4];
+	joints.arm2Rotate = values[5];
+
+	// The wrist turns the arm's frame into the sampled world orientation; of its Euler angles,
+	// take those nearest the previous sample's, or else the keys' own blended along the segment
+	const glm::quat world = Squad(segment.q1, segment.q2, segment.s1, segment.s2, u);
+	const glm::quat wrist = glm::conjugate(armFrame(joints.topRotate, joints.arm1Rotate + joints.arm2Rotate)) * world;
+	float near[3], angles[3];
+	if (previous != NULL) {
+		near[0] = toRadians(previous->penRotateLongitude);
+		near[1] = toRadians(previous->penRotateLatitude);
+		near[2] = toRadians(previous->penRotateAxis);
+	}
+	else {
+		for (int k = 0; k < 3; k++)
+			near[k] = segment.wrist1[k] + (segment.wrist2[k] - segment.wrist1[k]) * u;
+	}
+	wristAngles(wrist, near, angles);
+	joints.penRotateLongitude = toJointAngle(angles[0]);
+	joints.penRotateLatitude = toJointAngle(angles[1]);
+	joints.penRotateAxis = toJointAngle(angles[2]);
+	return joints;
+}
+
+ArmJoints ArmTrajectory::sample(float time) const {
+	if (segments.empty())
+		return ArmJoints();
+	return evaluate(segments[findSegment(time, 0)], time, NULL);
+}
+
+void ArmTrajectory::sample(float start, float step, size_t count, ArmJoints * out) const {
+	if (segments.empty())
+		return;
+	size_t segment = findSegment(start, 0);
+	for (size_t i = 0; i < count; i++) {
+		const float time = start + step * (float)i;
+		segment = findSegment(time, segment);
+		out[i] = evaluate(segments[segment], time, i > 0 ? &out[i - 1] : NULL);
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "kinematics.hpp"
+
+// Arm state a trajectory passes through, time in seconds
+struct TrajectoryKey {
+	float time;
+	ArmJoints joints;
+};
+
+enum TrajectorySpline {
+	SPLINE_CUBIC,       // joint positions and velocities are continuous at the keys
+	SPLINE_QUINTIC      // accelerations too
+};
+
+// Joint values sampled together per spline segment: J0 x, y, z, J1, J2, J3, padded to a full AVX vector
+const int TrajectoryChannels = 8;
+
+// Smooth motion of the arm through a list of keys.
+// J0-J3 follow a spline per joint through the keys, with velocities (and accelerations) taken
+// from the neighbouring keys; the arm starts and stops at rest. The pen's world orientation
+// follows a SQUAD curve through the orientations the keys' J4-J6 give it, and J4-J6 are
+// worked back out of it at every sample. The pen thus turns along a smooth arc whatever
+// path the three Euler angles would take, also through gimbal lock (latitude +-90 degrees),
+// where J4 and J6 have to swing round quickly to follow it.
+class ArmTrajectory {
+public:
+	ArmTrajectory();
+
+	// keys in increasing time order, at least two. Returns false (and is left empty) otherwise.
+	bool build(const TrajectoryKey * keys, size_t count, TrajectorySpline spline = SPLINE_CUBIC);
+	void clear(void);
+
+	bool empty() const { return segments.empty(); }
+	float getStartTime() const { return segments.empty() ? 0.0f : segments.front().start; }
+	float getEndTime() const { return endTime; }
+
+	// Arm state at time, clamped to the keys' range. J4-J6 are the Euler angles of the pen's
+	// orientation nearest the keys' on either side.
+	ArmJoints sample(float time) const;
+	// count arm states at start, start + step, start + 2 * step, ... into out, which must hold
+	// count entries. Each sample's spline channels are evaluated as one SIMD vector, and the
+	// segment search carries over from sample to sample. J4-J6 are taken nearest the sample
+	// before, so they never jump by a whole turn; they can end up whole turns away from the
+	// keys' (and from sample(time)) for the same pen orientation.
+	void sample(float start, float step, size_t count, ArmJoints * out) const;
+
+private:
+	struct Segment {
+		float start;
+		float invDuration;
+		// Channel polynomials in u = (time - start) * invDuration, lowest power first
+		float coefficients[6][TrajectoryChannels];
+		// Pen world orientation at both ends, and their SQUAD control points
+		glm::quat q1, q2, s1, s2;
+		// J4-J6 of both keys in radians, to pick among the Euler angles of a sampled orientation
+		float wrist1[3], wrist2[3];
+	};
+
+	size_t findSegment(float time, size_t hint) const;
+	ArmJoints evaluate(const Segment & segment, float time, const ArmJoints * previous) const;
+
+	std::vector<Segment> segments;
+	float endTime;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+
+// Hands the latest value from one writer thread to one reader thread without locks.
+// The writer fills its back slot and swaps it with the middle slot; the reader swaps the
+// middle slot into its front slot only when something newer was published. Neither side
+// ever waits, and the reader always sees a complete value, possibly skipping older ones.
+template <typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() : middle(1), back(2), front(0) {}
+
+	// Writer: the slot to fill, then publish()
+	T & writeBuffer(void) { return slots[back]; }
+	void publish(void) {
+		back = middle.exchange(back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+	}
+	void write(const T & value) {
+		writeBuffer() = value;
+		publish();
+	}
+
+	// Reader: moves to the latest published value, false when there is nothing newer
+	bool update(void) {
+		if ((middle.load(std::memory_order_acquire) & FreshBit) == 0)
+			return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+		return true;
+	}
+	const T & readBuffer(void) const { return slots[front]; }
+
+private:
+	TripleBuffer(const TripleBuffer &);
+	TripleBuffer & operator=(const TripleBuffer &);
+
+	static const int IndexMask = 3;
+	static const int FreshBit = 4;
+
+	T slots[3];
+	std::atomic<int> middle;    // slot index, | FreshBit when the reader has not taken it yet
+	int back;                   // writer only
+	int front;                  // reader only
+};
+
+#endif
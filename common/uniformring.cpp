@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "glcallcount.hpp"
+#include <GL/glew.h>
+
+#include "uniformring.hpp"
+
+UniformRing::UniformRing()
+	: buffer(0), mapped(NULL), regionSize(0), alignment(1), used(0), current(0), overflows(0) {
+}
+
+void UniformRing::init(size_t bytesPerFrame, int framesInFlight) {
+	cleanup();
+	GLint offsetAlignment = 1;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	alignment = offsetAlignment > 0 ? (size_t)offsetAlignment : 1;
+	// Every region starts on an aligned offset too
+	regionSize = (bytesPerFrame + alignment - 1) / alignment * alignment;
+	fences.assign(framesInFlight, (GLsync)0);
+	current = framesInFlight - 1;
+	used = 0;
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_UNIFORM_BUFFER, bytes(), NULL, flags);
+		mapped = (char *)glMapBufferRange(GL_UNIFORM_BUFFER, 0, bytes(), flags);
+		if (mapped == NULL) {
+			// Immutable storage without GL_DYNAMIC_STORAGE_BIT rejects glBufferSubData, so the
+			// fallback needs a buffer of its own
+			fprintf(stderr, "UniformRing: persistent mapping failed, using glBufferSubData\n");
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			glDeleteBuffers(1, &buffer);
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		}
+	}
+	if (mapped == NULL)
+		glBufferData(GL_UNIFORM_BUFFER, bytes(), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformRing::cleanup(void) {
+	for (size_t i = 0; i < fences.size(); i++) {
+		if (fences[i] != 0)
+			glDeleteSync(fences[i]);
+	}
+	fences.clear();
+	for (size_t i = 0; i < overflowBuffers.size(); i++) {
+		if (overflowBuffers[i] != 0)
+			glDeleteBuffers(1, &overflowBuffers[i]);
+	}
+	overflowBuffers.clear();
+	if (buffer != 0) {
+		if (mapped != NULL) {
+			glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+			glUnmapBuffer(GL_UNIFORM_BUFFER);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &buffer);
+	}
+	buffer = 0;
+	mapped = NULL;
+}
+
+void UniformRing::beginFrame(void) {
+	current = (current + 1) % (int)fences.size();
+	used = 0;
+	overflows = 0;
+	GLsync & fence = fences[current];
+	if (fence == 0)
+		return;
+	// Normally signaled long ago; only a GPU several frames behind makes this wait
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	while (result == GL_TIMEOUT_EXPIRED)
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	glDeleteSync(fence);
+	fence = 0;
+}
+
+void UniformRing::endFrame(void) {
+	fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool UniformRing::write(const void * data, size_t size, GLintptr & out_offset) {
+	const size_t start = (used + alignment - 1) / alignment * alignment;
+	if (start + size > regionSize)
+		return false;
+	out_offset = (GLintptr)(current * regionSize + start);
+	if (mapped != NULL) {
+		memcpy(mapped + out_offset, data, size);
+	}
+	else {
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, out_offset, size, data);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+	used = start + size;
+	return true;
+}
+
+void UniformRing::upload(GLuint bindingPoint, const void * data, size_t size) {
+	GLintptr offset;
+	if (write(data, size, offset)) {
+		glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, buffer, offset, size);
+		return;
+	}
+
+	overflows++;
+	if (bindingPoint >= overflowBuffers.size())
+		overflowBuffers.resize(bindingPoint + 1, 0);
+	GLuint & overflow = overflowBuffers[bindingPoint];
+	if (overflow == 0) {
+		fprintf(stderr, "UniformRing: frame region of %u bytes is full, binding %u uses glBufferData\n",
+			(unsigned int)regionSize, bindingPoint);
+		glGenBuffers(1, &overflow);
+	}
+	// glBufferData orphans the old storage, so draws already queued keep reading the block
+	// they were issued with and this one does not wait for them
+	glBindBuffer(GL_UNIFORM_BUFFER, overflow);
+	glBufferData(GL_UNIFORM_BUFFER, size, data, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, overflow, 0, size);
+}
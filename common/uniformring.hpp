@@ -0,0 +1,50 @@
+#ifndef UNIFORMRING_HPP
+#define UNIFORMRING_HPP
+
+#include <stddef.h>
+#include <vector>
+
+#include <GL/glew.h>
+
+// Uniform block data written straight into one persistently mapped buffer, split into a
+// region per frame in flight. A region is only reused once the GPU has passed the fence of
+// the frame that last wrote it, so writes never wait on or race with draws still queued.
+// Without GL 4.4 / ARB_buffer_storage, writes fall back to glBufferSubData.
+class UniformRing {
+public:
+	UniformRing();
+
+	void init(size_t bytesPerFrame, int framesInFlight);
+	void cleanup(void);
+
+	// Moves to the next region, waiting for the GPU only if it still reads from it
+	void beginFrame(void);
+	// Fences the region written since beginFrame()
+	void endFrame(void);
+
+	// Copies size bytes to the current region and binds them to a uniform block binding point.
+	// When the region is full the block gets fresh storage in a buffer of that binding point's
+	// own (glBufferData), so draws never read a block left over from an earlier write.
+	void upload(GLuint bindingPoint, const void * data, size_t size);
+
+	bool isPersistent(void) const { return mapped != NULL; }
+	size_t bytes(void) const { return regionSize * fences.size(); }
+	// Blocks upload() could not fit in the ring since beginFrame()
+	unsigned int getOverflows(void) const { return overflows; }
+
+private:
+	// Copies to the next offset a uniform block may start at; false when the region is full
+	bool write(const void * data, size_t size, GLintptr & out_offset);
+
+	GLuint buffer;
+	char * mapped;          // whole buffer, NULL when not persistently mapped
+	size_t regionSize;
+	size_t alignment;
+	size_t used;            // bytes written to the current region
+	int current;
+	std::vector<GLsync> fences;
+	std::vector<GLuint> overflowBuffers;	// per binding point, created on the first overflow
+	unsigned int overflows;
+};
+
+#endif
@@ -1,98 +1,111 @@
-#include <vector>
-#include <map>
-
-#include <glm/glm.hpp>
-
-#include "vboindexer.hpp"
-
-#include <string.h> // for memcmp
-
-
-// Returns true iif v1 can be considered equal to v2
-bool is_near(float v1, float v2){
-	return fabs( v1-v2 ) < 0.01f;
-}
-
-// Searches through all already-exported vertices
-// for a similar one.
-// Similar = same position + same UVs + same normal
-bool getSimilarVertexIndex( 
-	glm::vec3 & in_vertex, 
-	glm::vec3 & in_normal, 
-	std::vector<glm::vec3> & out_vertices,
-	std::vector<glm::vec3> & out_normals,
-	unsigned short & result
-){
-	// Lame linear search
-	for ( unsigned int i=0; i<out_vertices.size(); i++ ){
-		if (
-			is_near( in_vertex.x , out_vertices[i].x ) &&
-			is_near( in_vertex.y , out_vertices[i].y ) &&
-			is_near( in_vertex.z , out_vertices[i].z ) &&
-			is_near( in_normal.x , out_normals [i].x ) &&
-			is_near( in_normal.y , out_normals [i].y ) &&
-			is_near( in_normal.z , out_normals [i].z )
-		){
-			result = i;
-			return true;
-		}
-	}
-	// No other vertex could be used instead.
-	// Looks like we'll have to add it to the VBO.
-	return false;
-}
-
-struct PackedVertex{
-	glm::vec3 position;
-	glm::vec3 normal;
-	bool operator<(const PackedVertex that) const{
-		return memcmp((void*)this, (void*)&that, sizeof(PackedVertex))>0;
-	};
-};
-
-bool getSimilarVertexIndex_fast( 
-	PackedVertex & packed, 
-	std::map<PackedVertex,unsigned short> & VertexToOutIndex,
-	unsigned short & result
-){
-	std::map<PackedVertex,unsigned short>::iterator it = VertexToOutIndex.find(packed);
-	if ( it == VertexToOutIndex.end() ){
-		return false;
-	}else{
-		result = it->second;
-		return true;
-	}
-}
-
-void indexVBO(
-	std::vector<glm::vec3> & in_vertices,
-	std::vector<glm::vec3> & in_normals,
-
-	std::vector<unsigned short> & out_indices,
-	std::vector<glm::vec3> & out_vertices,
-
-	std::vector<glm::vec3> & out_normals
-){
-	std::map<PackedVertex,unsigned short> VertexToOutIndex;
-
-	// For each input vertex
-	for ( unsigned int i=0; i<in_vertices.size(); i++ ){
-
-		PackedVertex packed = {in_vertices[i], in_normals[i]};
-		
-
-		// Try to find a similar vertex in out_XXXX
-		unsigned short index;
-		bool found = getSimilarVertexIndex_fast( packed, VertexToOutIndex, index);
-
-		if ( found ){ // A similar vertex is already in the VBO, use it instead !
-			out_indices.push_back( index );
-		}else{ // If not, it needs to be added in the output data.
-			out_vertices.push_back( in_vertices[i]);
-			out_normals .push_back( in_normals[i]);
-			unsigned short newindex = (unsigned short)out_vertices.size() - 1;
-			out_indices .push_back( newindex );
-			VertexToOutIndex[ packed ] = newindex;
-		}
-	}
-}
+#include <stdio.h>
+#include <string.h> // for memcpy
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "vboindexer.hpp"
+
+// Position + normal, as raw float bits (exact) or grid cells (epsilon > 0)
+struct VertexKey{
+	unsigned int values[6];
+	bool operator==(const VertexKey & that) const{
+		return memcmp(values, that.values, sizeof(values)) == 0;
+	}
+};
+
+static inline unsigned int floatBits(float f){
+	f += 0.0f; // -0 and +0 are the same vertex
+	unsigned int bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+static inline VertexKey makeKey(const glm::vec3 & position, const glm::vec3 & normal, float invEpsilon){
+	const float in[6] = { position.x, position.y, position.z, normal.x, normal.y, normal.z };
+	VertexKey key;
+	for (int i = 0; i < 6; i++){
+		if (invEpsilon > 0.0f)
+			key.values[i] = (unsigned int)(int)std::floor(in[i] * invEpsilon + 0.5f);
+		else
+			key.values[i] = floatBits(in[i]);
+	}
+	return key;
+}
+
+static inline unsigned int hashKey(const VertexKey & key){
+	// FNV-1a over the six words, then a final avalanche so low bits are usable
+	unsigned int h = 2166136261u;
+	for (int i = 0; i < 6; i++)
+		h = (h ^ key.values[i]) * 16777619u;
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	return h;
+}
+
+void indexVBO(
+	std::vector<glm::vec3> & in_vertices,
+	std::vector<glm::vec3> & in_normals,
+
+	std::vector<unsigned int> & out_indices,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	float epsilon
+){
+	const float invEpsilon = epsilon > 0.0f ? 1.0f / epsilon : 0.0f;
+
+	// Power of two, at most half full; slots hold output index + 1, 0 = empty
+	size_t capacity = 16;
+	while (capacity < in_vertices.size() * 2)
+		capacity *= 2;
+	const size_t mask = capacity - 1;
+	std::vector<unsigned int> slots(capacity, 0);
+	std::vector<VertexKey> keys;
+	keys.reserve(in_vertices.size() / 2);
+
+	const unsigned int first = (unsigned int)out_vertices.size();
+	out_indices.reserve(out_indices.size() + in_vertices.size());
+
+	// For each input vertex
+	for ( unsigned int i=0; i<in_vertices.size(); i++ ){
+		const VertexKey key = makeKey(in_vertices[i], in_normals[i], invEpsilon);
+
+		size_t slot = hashKey(key) & mask;
+		while (slots[slot] != 0 && !(keys[slots[slot] - 1] == key))
+			slot = (slot + 1) & mask;
+
+		if ( slots[slot] != 0 ){ // A similar vertex is already in the VBO, use it instead !
+			out_indices.push_back( first + slots[slot] - 1 );
+		}else{ // If not, it needs to be added in the output data.
+			keys.push_back(key);
+			slots[slot] = (unsigned int)keys.size();
+			out_vertices.push_back( in_vertices[i]);
+			out_normals .push_back( in_normals[i]);
+			out_indices .push_back( (unsigned int)out_vertices.size() - 1 );
+		}
+	}
+}
+
+bool indexVBO(
+	std::vector<glm::vec3> & in_vertices,
+	std::vector<glm::vec3> & in_normals,
+
+	std::vector<unsigned short> & out_indices,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	float epsilon
+){
+	const size_t vertexCount = out_vertices.size(), normalCount = out_normals.size();
+	std::vector<unsigned int> indices;
+	indexVBO(in_vertices, in_normals, indices, out_vertices, out_normals, epsilon);
+	if (out_vertices.size() > 65536){
+		printf("indexVBO: %d unique vertices do not fit 16-bit indices\n", (int)out_vertices.size());
+		out_vertices.resize(vertexCount);
+		out_normals.resize(normalCount);
+		return false;
+	}
+	out_indices.insert(out_indices.end(), indices.begin(), indices.end());
+	return true;
+}
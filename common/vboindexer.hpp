@@ -1,14 +1,30 @@
-#ifndef VBOINDEXER_HPP
-#define VBOINDEXER_HPP
-
-void indexVBO(
-	std::vector<glm::vec3> & in_vertices,
-	std::vector<glm::vec3> & in_normals,
-
-	std::vector<unsigned short> & out_indices,
-	std::vector<glm::vec3> & out_vertices,
-	std::vector<glm::vec3> & out_normals
-);
-
-
-#endif
\ No newline at end of file
+#ifndef VBOINDEXER_HPP
+#define VBOINDEXER_HPP
+
+// Merges identical position/normal pairs through an open-addressing hash table.
+// With epsilon > 0, vertices are quantized to a grid of that size first, so
+// near-equal ones that land in the same cell are merged too.
+void indexVBO(
+	std::vector<glm::vec3> & in_vertices,
+	std::vector<glm::vec3> & in_normals,
+
+	std::vector<unsigned int> & out_indices,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	float epsilon = 0.0f
+);
+
+// 16-bit version. Returns false, leaving all three outputs as they were, when there are
+// more unique vertices than an unsigned short can address.
+bool indexVBO(
+	std::vector<glm::vec3> & in_vertices,
+	std::vector<glm::vec3> & in_normals,
+
+	std::vector<unsigned short> & out_indices,
+	std::vector<glm::vec3> & out_vertices,
+	std::vector<glm::vec3> & out_normals,
+	float epsilon = 0.0f
+);
+
+
+#endif
@@ -0,0 +1,29 @@
+#include <glm/glm.hpp>
+
+#include "vertexpacking.hpp"
+
+static inline unsigned int packSnorm10(float value) {
+	value = glm::clamp(value, -1.0f, 1.0f) * 511.0f;
+	int quantized = (int)(value >= 0.0f ? value + 0.5f : value - 0.5f);
+	return (unsigned int)quantized & 0x3FFu;
+}
+
+static inline float unpackSnorm10(unsigned int bits) {
+	int value = (int)(bits & 0x3FFu);
+	if (value & 0x200)
+		value -= 0x400;	// sign extend
+	return glm::max((float)value / 511.0f, -1.0f);
+}
+
+unsigned int packNormal2_10_10_10(const glm::vec3 & normal) {
+	return packSnorm10(normal.x) | (packSnorm10(normal.y) << 10) | (packSnorm10(normal.z) << 20);
+}
+
+glm::vec3 unpackNormal2_10_10_10(unsigned int packed) {
+	return glm::vec3(unpackSnorm10(packed), unpackSnorm10(packed >> 10), unpackSnorm10(packed >> 20));
+}
+
+void packColorRGBA8(const float * color, unsigned char out_rgba[4]) {
+	for (int i = 0; i < 4; i++)
+		out_rgba[i] = (unsigned char)(glm::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+}
@@ -0,0 +1,16 @@
+#ifndef VERTEXPACKING_HPP
+#define VERTEXPACKING_HPP
+
+#include <glm/glm.hpp>
+
+// Quantization for compact vertex attributes. The GL unpacks both formats in the
+// vertex fetch (normalized attributes), so shaders still see plain vec3/vec4 inputs.
+
+// Unit vector as signed normalized GL_INT_2_10_10_10_REV: x in bits 0-9, y in 10-19, z in 20-29, w = 0
+unsigned int packNormal2_10_10_10(const glm::vec3 & normal);
+glm::vec3 unpackNormal2_10_10_10(unsigned int packed);
+
+// [0, 1] RGBA color as 4 unsigned normalized bytes
+void packColorRGBA8(const float * color, unsigned char out_rgba[4]);
+
+#endif
@@ -1,767 +1,1627 @@
-// Include standard headers
-#include <stdio.h>
-#include <stdlib.h>
-#include <vector>
-#include <array>
-#include <iostream>
-#include <stack>   
-#include <sstream>
-// Include GLEW
-#include <GL/glew.h>
-// Include GLFW
-#include <GLFW/glfw3.h>
-// Include GLM
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/quaternion.hpp>
-#include <glm/gtx/quaternion.hpp>
-using namespace glm;
-// Include AntTweakBar
-#include <AntTweakBar.h>
-
-#include <common/shader.hpp>
-#include <common/controls.hpp>
-#include <common/objloader.hpp>
-#include <common/vboindexer.hpp>
-
-const int window_width = 1024, window_height = 768;
-
-typedef struct Vertex {
-	float Position[4];
-	float Color[4];
-	float Normal[3];
-	void SetPosition(float *coords) {
-		Position[0] = coords[0];
-		Position[1] = coords[1];
-		Position[2] = coords[2];
-		Position[3] = 1.0;
-	}
-	void SetColor(float *color) {
-		Color[0] = color[0];
-		Color[1] = color[1];
-		Color[2] = color[2];
-		Color[3] = color[3];
-	}
-	void SetNormal(float *coords) {
-		Normal[0] = coords[0];
-		Normal[1] = coords[1];
-		Normal[2] = coords[2];
-	}
-};
-
-// function prototypes
-int initWindow(void);
-void initOpenGL(void);
-void createVAOs(Vertex[], GLushort[], int);
-void loadObject(char*, glm::vec4, Vertex* &, GLushort* &, int);
-void createObjects(void);
-void pickObject(void);
-void renderScene(void);
-void cleanup(void);
-static void keyCallback(GLFWwindow*, int, int, int, int);
-static void mouseCallback(GLFWwindow*, int, int, int);
-
-// GLOBAL VARIABLES
-GLFWwindow* window;
-
-glm::mat4 gProjectionMatrix;
-glm::mat4 gViewMatrix;
-
-GLuint gPickedIndex = -1;
-std::string gMessage;
-
-GLuint programID;
-GLuint pickingProgramID;
-
-const GLuint NumObjects = 16;	// ATTN: THIS NEEDS TO CHANGE AS YOU ADD NEW OBJECTS
-// Grid
-const int axisIndex = 0;
-const int gridIndex = 1;
-// Normal colored objects
-const int baseIndexStandardColor = 2;
-const int topIndexStandardColor = 3;
-const int arm1IndexStandardColor = 4;
-const int jointIndexStandardColor = 5;
-const int arm2IndexStandardColor = 6;
-const int penIndexStandardColor = 7;
-const int buttonIndexStandardColor = 8;
-// Lighter colored objects
-const int baseIndexHighlightedColor = 9;
-const int topIndexHighlightedColor = 10;
-const int arm1IndexHighlightedColor = 11;
-const int arm2IndexHighlightedColor = 12;
-const int penIndexHighlightedColor = 13;
-// Lights
-//const int lightCube1Index = 14;
-//const int lightCube2Index = 15;
-GLuint VertexArrayId[NumObjects];
-GLuint VertexBufferId[NumObjects];
-GLuint IndexBufferId[NumObjects];
-
-// TL
-size_t VertexBufferSize[NumObjects];
-size_t IndexBufferSize[NumObjects];
-size_t NumIdcs[NumObjects];
-size_t NumVerts[NumObjects];
-
-GLuint MatrixID;
-GLuint ModelMatrixID;
-GLuint ViewMatrixID;
-GLuint ProjMatrixID;
-GLuint PickingMatrixID;
-GLuint pickingColorID;
-GLuint LightID;
-
-// Declare global objects
-// TL
-const size_t CoordVertsCount = 6;
-Vertex CoordVerts[CoordVertsCount];
-// Colors 
-float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
-float green[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
-float blue[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
-float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-// General vertices
-float origin[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-float xMax[4] = { 5.0f, 0.0f, 0.0f, 1.0f };
-float yMax[4] = { 0.0f, 5.0f, 0.0f, 1.0f };
-float zMax[4] = { 0.0f, 0.0f, 5.0f, 1.0f };
-// Grid vertices
-const size_t GridVertsIndexCount = 44;
-Vertex GridVerts[GridVertsIndexCount];
-GLushort GridVertsIndices[GridVertsIndexCount];
-// Obj vertices stored in a 2D array
-#define MAXVERTS 320
-#define MAXPARTS 7
-Vertex RobotArmVerts[MAXPARTS][MAXVERTS];
-GLushort RobotArmIndices[MAXVERTS];
-// Booleans
-bool CameraSelected = false;
-bool BaseSelected = false;
-bool TopSelected = false;
-bool Arm1Selected = false;
-bool Arm2Selected = false;
-bool PenSelected = false;
-bool ShiftPressed = false;
-bool MousePressed = false;
-bool IsObjectActive[8];
-// Transformations
-glm::vec3 J0_BaseTranslate;
-float J1_TopRotate = 0.0f; // J1
-float J2_Arm1Rotate = 0.0f; // J2
-float J3_Arm2Rotate = 0.0f; // J3
-float J4_PenRotateLongitude = 0.0f; // J4
-float J5_PenRotateLatitude = 0.0f; // J5
-float J6_PenRotateAxis = 0.0f; // J6
-
-int initWindow(void) {
-	// Initialise GLFW
-	if (!glfwInit()) {
-		fprintf(stderr, "Failed to initialize GLFW\n");
-		return -1;
-	}
-
-	glfwWindowHint(GLFW_SAMPLES, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-	//glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);	// FOR MAC
-
-	// Open a window and create its OpenGL context
-	window = glfwCreateWindow(window_width, window_height, "Ajoy,Nicole(30795334)", NULL, NULL);
-	if (window == NULL) {
-		fprintf(stderr, "Failed to open GLFW window. If you have an Intel GPU, they are not 3.3 compatible. Try the 2.1 version of the tutorials.\n");
-		glfwTerminate();
-		return -1;
-	}
-	glfwMakeContextCurrent(window);
-
-	// Initialize GLEW
-	glewExperimental = true; // Needed for core profile
-	if (glewInit() != GLEW_OK) {
-		fprintf(stderr, "Failed to initialize GLEW\n");
-		return -1;
-	}
-
-	// Initialize the GUI
-	TwInit(TW_OPENGL_CORE, NULL);
-	TwWindowSize(window_width, window_height);
-	TwBar * GUI = TwNewBar("Picking");
-	TwSetParam(GUI, NULL, "refresh", TW_PARAM_CSTRING, 1, "0.1");
-	TwAddVarRW(GUI, "Last picked object", TW_TYPE_STDSTRING, &gMessage, NULL);
-
-	// Set up inputs
-	glfwSetCursorPos(window, window_width / 2, window_height / 2);
-	glfwSetKeyCallback(window, keyCallback);
-	glfwSetMouseButtonCallback(window, mouseCallback);
-
-	return 0;
-}
-
-void initOpenGL(void) {
-	// Enable depth test
-	glEnable(GL_DEPTH_TEST);
-	// Accept fragment if it closer to the camera than the former one
-	glDepthFunc(GL_LESS);
-	// Cull triangles which normal is not towards the camera
-	glEnable(GL_CULL_FACE);
-
-	// Projection matrix : 45 Field of View, 4:3 ratio, display range : 0.1 unit <-> 100 units
-	gProjectionMatrix = glm::perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
-	// Or, for an ortho camera :
-	//gProjectionMatrix = glm::ortho(-4.0f, 4.0f, -3.0f, 3.0f, 0.0f, 100.0f); // In world coordinates
-
-	// Camera matrix
-	gViewMatrix = glm::lookAt(glm::vec3(10.0, 10.0, 10.0f),	// eye
-		glm::vec3(0.0, 0.0, 0.0),	// center
-		glm::vec3(0.0, 1.0, 0.0));	// up
-
-	// Create and compile our GLSL program from the shaders
-	programID = LoadShaders("StandardShading.vertexshader", "StandardShading.fragmentshader");
-	pickingProgramID = LoadShaders("Picking.vertexshader", "Picking.fragmentshader");
-
-	// Get a handle for our "MVP" uniform
-	MatrixID = glGetUniformLocation(programID, "MVP");
-	ModelMatrixID = glGetUniformLocation(programID, "M");
-	ViewMatrixID = glGetUniformLocation(programID, "V");
-	ProjMatrixID = glGetUniformLocation(programID, "P");
-
-	PickingMatrixID = glGetUniformLocation(pickingProgramID, "MVP");
-	// Get a handle for our "pickingColorID" uniform
-	pickingColorID = glGetUniformLocation(pickingProgramID, "PickingColor");
-	// Get a handle for our "LightPosition" uniform
-	LightID = glGetUniformLocation(programID, "LightPosition_worldspace");
-
-	// TL
-	// Define objects
-	createObjects();
-
-	// ATTN: create VAOs for each of the newly created objects here:
-	VertexBufferSize[0] = sizeof(CoordVerts);
-	NumVerts[0] = CoordVertsCount;
-	createVAOs(CoordVerts, NULL, 0);
-
-	VertexBufferSize[1] = sizeof(GridVerts);
-	NumVerts[1] = GridVertsIndexCount;
-	createVAOs(GridVerts, NULL, 1);
-}
-
-void createVAOs(Vertex Vertices[], unsigned short Indices[], int ObjectId) {
-	GLenum ErrorCheckValue = glGetError();
-	const size_t VertexSize = sizeof(Vertices[0]);
-	const size_t RgbOffset = sizeof(Vertices[0].Position);
-	const size_t Normaloffset = sizeof(Vertices[0].Color) + RgbOffset;
-
-	// Create Vertex Array Object
-	glGenVertexArrays(1, &VertexArrayId[ObjectId]);
-	glBindVertexArray(VertexArrayId[ObjectId]);
-
-	// Create Buffer for vertex data
-	glGenBuffers(1, &VertexBufferId[ObjectId]);
-	glBindBuffer(GL_ARRAY_BUFFER, VertexBufferId[ObjectId]);
-	glBufferData(GL_ARRAY_BUFFER, VertexBufferSize[ObjectId], Vertices, GL_STATIC_DRAW);
-
-	// Create Buffer for indices
-	if (Indices != NULL) {
-		glGenBuffers(1, &IndexBufferId[ObjectId]);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBufferId[ObjectId]);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexBufferSize[ObjectId], Indices, GL_STATIC_DRAW);
-	}
-
-	// Assign vertex attributes
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, VertexSize, 0);
-	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, VertexSize, (GLvoid*)RgbOffset);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, VertexSize, (GLvoid*)Normaloffset);	// TL
-
-	glEnableVertexAttribArray(0);	// position
-	glEnableVertexAttribArray(1);	// color
-	glEnableVertexAttribArray(2);	// normal
-
-	// Disable our Vertex Buffer Object 
-	glBindVertexArray(0);
-
-	ErrorCheckValue = glGetError();
-	if (ErrorCheckValue != GL_NO_ERROR)
-	{
-		fprintf(
-			stderr,
-			"ERROR: Could not create a VBO: %s \n",
-			gluErrorString(ErrorCheckValue)
-		);
-	}
-}
-
-// Ensure your .obj files are in the correct format and properly loaded by looking at the following function
-void loadObject(char* file, glm::vec4 color, Vertex* &out_Vertices, GLushort* &out_Indices, int ObjectId) {
-	// Read our .obj file
-	std::vector<glm::vec3> vertices;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::vec3> normals;
-	bool res = loadOBJ(file, vertices, normals);
-
-	std::vector<GLushort> indices;
-	std::vector<glm::vec3> indexed_vertices;
-	std::vector<glm::vec2> indexed_uvs;
-	std::vector<glm::vec3> indexed_normals;
-	indexVBO(vertices, normals, indices, indexed_vertices, indexed_normals);
-
-	const size_t vertCount = indexed_vertices.size();
-	const size_t idxCount = indices.size();
-	//std::cout << "objectId: " << ObjectId << " | vertCount: " << vertCount << " | idxCount: " << idxCount << std::endl;
-
-	// populate output arrays
-	out_Vertices = new Vertex[vertCount];
-	for (int i = 0; i < vertCount; i++) {
-		out_Vertices[i].SetPosition(&indexed_vertices[i].x);
-		out_Vertices[i].SetNormal(&indexed_normals[i].x);
-		out_Vertices[i].SetColor(&color[0]);
-		//RobotArmVerts[ObjectId - 2][i].SetPosition(&indexed_vertices[i].x);
-		//RobotArmVerts[ObjectId - 2][i].SetNormal(&indexed_normals[i].x);
-		//RobotArmVerts[ObjectId - 2][i].SetColor(&color[0]);
-	}
-	out_Indices = new GLushort[idxCount];
-	for (int i = 0; i < idxCount; i++) {
-		out_Indices[i] = indices[i];
-		//RobotArmIndices[i] = i;
-	}
-
-	// set global variables!!
-	NumIdcs[ObjectId] = idxCount;
-	VertexBufferSize[ObjectId] = sizeof(out_Vertices[0]) * vertCount;
-	IndexBufferSize[ObjectId] = sizeof(GLushort) * idxCount;
-}
-
-void createObjects(void) {
-	//-- COORDINATE AXES --//
-	CoordVerts[0] = { { 0.0, 0.0, 0.0, 1.0 }, { 1.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 1.0 } };
-	CoordVerts[1] = { { 5.0, 0.0, 0.0, 1.0 }, { 1.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 1.0 } };
-	CoordVerts[2] = { { 0.0, 0.0, 0.0, 1.0 }, { 0.0, 1.0, 0.0, 1.0 }, { 0.0, 0.0, 1.0 } };
-	CoordVerts[3] = { { 0.0, 5.0, 0.0, 1.0 }, { 0.0, 1.0, 0.0, 1.0 }, { 0.0, 0.0, 1.0 } };
-	CoordVerts[4] = { { 0.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 1.0, 1.0 }, { 0.0, 0.0, 1.0 } };
-	CoordVerts[5] = { { 0.0, 0.0, 5.0, 1.0 }, { 0.0, 0.0, 1.0, 1.0 }, { 0.0, 0.0, 1.0 } };
-	
-	//-- GRID --//
-	
-	// ATTN: Create your grid vertices here!
-	int gridVertCounter = 0;
-	for (int x = -5; x <= 5; x++) {
-		float v1[4] = { x, 0, -5, 1.0f };
-		GridVerts[gridVertCounter].SetPosition(v1);
-		GridVerts[gridVertCounter].SetColor(white);
-		float v2[4] = { x, 0, 5, 1.0f };
-		GridVerts[gridVertCounter + 1].SetPosition(v2);
-		GridVerts[gridVertCounter + 1].SetColor(white);
-		gridVertCounter += 2;
-	}
-	for (int z = -5; z <= 5; z++) {
-		float v1[4] = { -5, 0, z, 1.0f };
-		GridVerts[gridVertCounter].SetPosition(v1);
-		GridVerts[gridVertCounter].SetColor(white);
-		float v2[4] = { 5, 0, z, 1.0f };
-		GridVerts[gridVertCounter + 1].SetPosition(v2);
-		GridVerts[gridVertCounter + 1].SetColor(white);
-		gridVertCounter += 2;
-	}
-	
-	//-- .OBJs --//
-
-	// ATTN: Load your models here through .obj files -- example of how to do so is as shown
-	Vertex* Verts;
-	GLushort* Idcs;
-	
-	// Load the original colors first
-	loadObject("models/base.obj", glm::vec4(1.0, 0.0, 0.0, 1.0), Verts, Idcs, baseIndexStandardColor);
-	createVAOs(Verts, Idcs, baseIndexStandardColor);
-	loadObject("models/top.obj", glm::vec4(0.0, 1.0, 0.0, 1.0), Verts, Idcs, topIndexStandardColor);
-	createVAOs(Verts, Idcs, topIndexStandardColor);
-	loadObject("models/arm1.obj", glm::vec4(0.0, 0.0, 1.0, 1.0), Verts, Idcs, arm1IndexStandardColor);
-	createVAOs(Verts, Idcs, arm1IndexStandardColor);
-	loadObject("models/joint.obj", glm::vec4(1.0, 0.0, 1.0, 1.0), Verts, Idcs, jointIndexStandardColor);
-	createVAOs(Verts, Idcs, jointIndexStandardColor);
-	loadObject("models/arm2.obj", glm::vec4(0.0, 1.0, 1.0, 1.0), Verts, Idcs, arm2IndexStandardColor);
-	createVAOs(Verts, Idcs, arm2IndexStandardColor);
-	loadObject("models/pen.obj", glm::vec4(1.0, 1.0, 0.0, 1.0), Verts, Idcs, penIndexStandardColor);
-	createVAOs(Verts, Idcs, penIndexStandardColor);
-	loadObject("models/button.obj", glm::vec4(1.0, 0.0, 0.0, 1.0), Verts, Idcs, buttonIndexStandardColor);
-	createVAOs(Verts, Idcs, buttonIndexStandardColor);
-
-	// Load with the lighter colors (this is messy, sorry, but it seems to work)
-	loadObject("models/base.obj", glm::vec4(1.0, 0.75, 0.75, 1.0), Verts, Idcs, baseIndexHighlightedColor);
-	createVAOs(Verts, Idcs, baseIndexHighlightedColor);
-	loadObject("models/top.obj", glm::vec4(0.75, 1.0, 0.75, 1.0), Verts, Idcs, topIndexHighlightedColor);
-	createVAOs(Verts, Idcs, topIndexHighlightedColor);
-	loadObject("models/arm1.obj", glm::vec4(0.75, 0.75, 1.0, 1.0), Verts, Idcs, arm1IndexHighlightedColor);
-	createVAOs(Verts, Idcs, arm1IndexHighlightedColor);
-	loadObject("models/arm2.obj", glm::vec4(0.75, 1.0, 1.0, 1.0), Verts, Idcs, arm2IndexHighlightedColor);
-	createVAOs(Verts, Idcs, arm2IndexHighlightedColor);
-	loadObject("models/pen.obj", glm::vec4(1.0, 1.0, 0.75, 1.0), Verts, Idcs, penIndexHighlightedColor);
-	createVAOs(Verts, Idcs, penIndexHighlightedColor);
-
-	// Load light cubes with emmision material
-	//loadObject("models/lightcube1.obj", glm::vec4(1.0, 0.0, 1.0, 1.0), Verts, Idcs, lightCube1Index);
-	//createVAOs(Verts, Idcs, lightCube1Index);
-	//loadObject("models/lightcube2.obj", glm::vec4(0.0, 1.0, 1.0, 1.0), Verts, Idcs, lightCube2Index);
-	//createVAOs(Verts, Idcs, lightCube2Index);
-}
-
-void pickObject(void) {
-	// Clear the screen in white
-	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	glUseProgram(pickingProgramID);
-	{
-		glm::mat4 ModelMatrix = glm::mat4(1.0); // TranslationMatrix * RotationMatrix;
-		glm::mat4 MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-
-		// Send our transformation to the currently bound shader, in the "MVP" uniform
-		glUniformMatrix4fv(PickingMatrixID, 1, GL_FALSE, &MVP[0][0]);
-
-		// ATTN: DRAW YOUR PICKING SCENE HERE. REMEMBER TO SEND IN A DIFFERENT PICKING COLOR FOR EACH OBJECT BEFOREHAND
-		glBindVertexArray(0);
-	}
-	glUseProgram(0);
-	// Wait until all the pending drawing commands are really done.
-	// Ultra-mega-over slow ! 
-	// There are usually a long time between glDrawElements() and
-	// all the fragments completely rasterized.
-	glFlush();
-	glFinish();
-
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-	// Read the pixel at the center of the screen.
-	// You can also use glfwGetMousePos().
-	// Ultra-mega-over slow too, even for 1 pixel, 
-	// because the framebuffer is on the GPU.
-	double xpos, ypos;
-	glfwGetCursorPos(window, &xpos, &ypos);
-	unsigned char data[4];
-	glReadPixels(xpos, window_height - ypos, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, data); // OpenGL renders with (0,0) on bottom, mouse reports with (0,0) on top
-
-	// Convert the color back to an integer ID
-	gPickedIndex = int(data[0]);
-	
-	if (gPickedIndex == 255) { // Full white, must be the background !
-		gMessage = "background";
-	}
-	else {
-		std::ostringstream oss;
-		oss << "point " << gPickedIndex;
-		gMessage = oss.str();
-	}
-
-	// Uncomment these lines to see the picking shader in effect
-	//glfwSwapBuffers(window);
-	//continue; // skips the normal rendering
-}
-
-void renderScene(void) {
-	//ATTN: DRAW YOUR SCENE HERE. MODIFY/ADAPT WHERE NECESSARY!
-
-	// Dark blue background
-	glClearColor(0.0f, 0.0f, 0.2f, 0.0f);
-	// Re-clear the screen for real rendering
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-	glUseProgram(programID);
-	{
-		glm::mat4x4 ModelMatrix = glm::mat4(1.0);
-		//if (CameraSelected) {
-		if (IsObjectActive[0]) {
-			computeMatricesFromInputs();
-			//gProjectionMatrix = getProjectionMatrix();
-			gViewMatrix = getViewMatrix();
-		}
-		glm::mat4 MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		glUniformMatrix4fv(ProjMatrixID, 1, GL_FALSE, &gProjectionMatrix[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-
-		glm::vec3 lightPos1 = getCameraPosition();
-		glUniform3f(LightID, lightPos1.x + 5, lightPos1.y, lightPos1.z);
-
-		glm::vec3 lightPos2 = getCameraPosition();
-		glUniform3f(LightID, lightPos2.x - 5, lightPos2.y, lightPos2.z);
-
-		glBindVertexArray(VertexArrayId[0]);	// Draw CoordAxes
-		glDrawArrays(GL_LINES, 0, NumVerts[0]);
-
-		glBindVertexArray(VertexArrayId[1]);	// Draw Grid
-		glDrawArrays(GL_LINES, 0, NumVerts[1]);
-		
-		// Draw base
-		//if (BaseSelected) {
-		if (IsObjectActive[baseIndexStandardColor]) {
-			J0_BaseTranslate = UpdateBaseTranslate();
-		}
-		ModelMatrix = glm::translate(ModelMatrix, J0_BaseTranslate);
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		if (!IsObjectActive[baseIndexStandardColor]) {
-			glBindVertexArray(VertexArrayId[baseIndexStandardColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[baseIndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-		else {
-			glBindVertexArray(VertexArrayId[baseIndexHighlightedColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[baseIndexHighlightedColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-		
-		// Draw top
-		//if (TopSelected) {
-		if (IsObjectActive[topIndexStandardColor]) {
-			J1_TopRotate = UpdateTopRotate();
-		}
-		ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 1.0f, 0.0f));
-		ModelMatrix = glm::rotate(ModelMatrix, degrees(J1_TopRotate), glm::vec3(0.0, 1.0, 0.0));
-		MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		if (!IsObjectActive[topIndexStandardColor]) {
-			glBindVertexArray(VertexArrayId[topIndexStandardColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[topIndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-		else {
-			glBindVertexArray(VertexArrayId[topIndexHighlightedColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[topIndexHighlightedColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-
-		// Draw arm1
-		//if (Arm1Selected) {
-		if (IsObjectActive[arm1IndexStandardColor]) {
-			J2_Arm1Rotate = UpdateArm1Rotate();
-		}
-		ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 0.4f, 0.0f));
-		ModelMatrix = glm::rotate(ModelMatrix, degrees(J2_Arm1Rotate), glm::vec3(1.0f, 0.0f, 0.0f));
-		MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		if (!IsObjectActive[arm1IndexStandardColor]) {
-			glBindVertexArray(VertexArrayId[arm1IndexStandardColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[arm1IndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-		else {
-			glBindVertexArray(VertexArrayId[arm1IndexHighlightedColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[arm1IndexHighlightedColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-
-		// Draw joint
-		ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 1.25f, 0.0f));
-		MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		glBindVertexArray(VertexArrayId[jointIndexStandardColor]);
-		glDrawElements(GL_TRIANGLES, NumIdcs[jointIndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-
-		// Draw arm2
-		//if (Arm2Selected) {
-		if (IsObjectActive[arm2IndexStandardColor]) {
-			J3_Arm2Rotate = UpdateArm2Rotate();
-		}
-		ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 0.0f, 0.0f));
-		ModelMatrix = glm::rotate(ModelMatrix, degrees(J3_Arm2Rotate), glm::vec3(1.0f, 0.0f, 0.0f));
-		MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		if (!IsObjectActive[arm2IndexStandardColor]) {
-			glBindVertexArray(VertexArrayId[arm2IndexStandardColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[arm2IndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-		else {
-			glBindVertexArray(VertexArrayId[arm2IndexHighlightedColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[arm2IndexHighlightedColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-
-		// Draw pen
-		//if (PenSelected) {
-		if (IsObjectActive[penIndexStandardColor]) {
-			if (!ShiftPressed) {
-				J4_PenRotateLongitude = UpdatePenLongitudeRotate();
-				J5_PenRotateLatitude = UpdatePenLatitudeRotate();
-			}
-			else {
-				J6_PenRotateAxis = UpdatePenAxisRotate();
-			}
-		}
-		ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 1.0f, 0.0f));
-		ModelMatrix = glm::rotate(ModelMatrix, degrees(J4_PenRotateLongitude), glm::vec3(0.0f, 0.0f, 1.0f));
-		ModelMatrix = glm::rotate(ModelMatrix, degrees(J5_PenRotateLatitude), glm::vec3(1.0f, 0.0f, 0.0f));
-		ModelMatrix = glm::rotate(ModelMatrix, degrees(J6_PenRotateAxis), glm::vec3(0.0f, 1.0f, 0.0f));
-		MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		if (!IsObjectActive[penIndexStandardColor]) {
-			glBindVertexArray(VertexArrayId[penIndexStandardColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[penIndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-		else {
-			glBindVertexArray(VertexArrayId[penIndexHighlightedColor]);
-			glDrawElements(GL_TRIANGLES, NumIdcs[penIndexHighlightedColor], GL_UNSIGNED_SHORT, (void*)0);
-		}
-
-		// Draw button
-		ModelMatrix = glm::translate(ModelMatrix, glm::vec3(0.0f, 0.25f, 0.1f));
-		MVP = gProjectionMatrix * gViewMatrix * ModelMatrix;
-		glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
-		glUniformMatrix4fv(ModelMatrixID, 1, GL_FALSE, &ModelMatrix[0][0]);
-		glUniformMatrix4fv(ViewMatrixID, 1, GL_FALSE, &gViewMatrix[0][0]);
-		glBindVertexArray(VertexArrayId[buttonIndexStandardColor]);
-		glDrawElements(GL_TRIANGLES, NumIdcs[buttonIndexStandardColor], GL_UNSIGNED_SHORT, (void*)0);
-			
-		glBindVertexArray(0);
-	}
-	glUseProgram(0);
-	// Draw GUI
-	TwDraw();
-
-	// Swap buffers
-	glfwSwapBuffers(window);
-	glfwPollEvents();
-}
-
-void cleanup(void) {
-	// Cleanup VBO and shader
-	for (int i = 0; i < NumObjects; i++) {
-		glDeleteBuffers(1, &VertexBufferId[i]);
-		glDeleteBuffers(1, &IndexBufferId[i]);
-		glDeleteVertexArrays(1, &VertexArrayId[i]);
-	}
-	glDeleteProgram(programID);
-	glDeleteProgram(pickingProgramID);
-
-	// Close OpenGL window and terminate GLFW
-	glfwTerminate();
-}
-
-void setActive(int activeIndex) {
-	if (IsObjectActive[activeIndex]) {
-		IsObjectActive[activeIndex] = false;
-	}
-	else {
-		for (int i = 0; i < 9; i++) {
-			IsObjectActive[i] = (i == activeIndex ? true : false);
-		}
-	}
-}
-
-// Alternative way of triggering functions on keyboard events
-static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-	// ATTN: MODIFY AS APPROPRIATE
-	if (action == GLFW_PRESS) {
-		switch (key) {
-			case GLFW_KEY_A:
-				break;
-			case GLFW_KEY_D:
-				break;
-			case GLFW_KEY_W:
-				break;
-			case GLFW_KEY_S:
-				break;
-			case GLFW_KEY_SPACE:
-				break;
-			// Task 2: Camera rotations
-			case GLFW_KEY_C: {
-				//CameraSelected = !CameraSelected;
-				//std::cout << "CameraSelected bool: " << CameraSelected << std::endl;
-				setActive(0);
-				break;
-			}
-			// Task 4: transformations
-			case GLFW_KEY_B: {
-				//BaseSelected = !BaseSelected;
-				//std::cout << "BaseSelected bool: " << BaseSelected << std::endl;
-				setActive(baseIndexStandardColor);
-				break;
-			}
-			case GLFW_KEY_T: {
-				//TopSelected = !TopSelected;
-				//std::cout << "TopSelected bool: " << TopSelected << std::endl;
-				setActive(topIndexStandardColor);
-				break;
-			}
-			case GLFW_KEY_1: {
-				//Arm1Selected = !Arm1Selected;
-				//std::cout << "Arm1Selected bool: " << Arm1Selected << std::endl;
-				setActive(arm1IndexStandardColor);
-				break;
-			}
-			case GLFW_KEY_2: {
-				//Arm2Selected = !Arm2Selected;
-				//std::cout << "Arm2Selected bool: " << Arm2Selected << std::endl;
-				setActive(arm2IndexStandardColor);
-				break;
-			}
-			case GLFW_KEY_P: {
-				//PenSelected = !PenSelected;
-				//std::cout << "PenSelected bool: " << PenSelected << std::endl;
-				setActive(penIndexStandardColor);
-				break;
-			}
-			case GLFW_KEY_LEFT_SHIFT: {
-				ShiftPressed = !ShiftPressed;
-				//std::cout << "ShiftPressed bool: " << ShiftPressed << std::endl;
-			}
-			default:
-				break;
-		}
-	}
-}
-
-// Alternative way of triggering functions on mouse click events
-static void mouseCallback(GLFWwindow* window, int button, int action, int mods) {
-	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-		MousePressed = true;
-		pickObject();
-	}
-	else {
-		MousePressed = false;
-	}
-}
-
-int main(void) {
-	// TL
-	// ATTN: Refer to https://learnopengl.com/Getting-started/Transformations, https://learnopengl.com/Getting-started/Coordinate-Systems,
-	// and https://learnopengl.com/Getting-started/Camera to familiarize yourself with implementing the camera movement
-
-	// ATTN (Project 3 only): Refer to https://learnopengl.com/Getting-started/Textures to familiarize yourself with mapping a texture
-	// to a given mesh
-
-	// Initialize window
-	int errorCode = initWindow();
-	if (errorCode != 0)
-		return errorCode;
-
-	// Initialize OpenGL pipeline
-	initOpenGL();
-
-	// For speed computation
-	double lastTime = glfwGetTime();
-	int nbFrames = 0;
-	do {
-		// Measure speed
-		double currentTime = glfwGetTime();
-		nbFrames++;
-		if (currentTime - lastTime >= 1.0){ // If last prinf() was more than 1sec ago
-			printf("%f ms/frame\n", 1000.0 / double(nbFrames));
-			nbFrames = 0;
-			lastTime += 1.0;
-		}
-
-
-		// DRAWING POINTS
-		renderScene();
-
-	} // Check if the ESC key was pressed or the window was closed
-	while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS &&
-	glfwWindowShouldClose(window) == 0);
-
-	cleanup();
-
-	return 0;
+// Include standard headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <vector>
+#include <array>
+#include <iostream>
+#include <stack>   
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+// Include GLEW, counting the GL calls made from this file
+#include <common/glcallcount.hpp>
+#include <GL/glew.h>
+// Include GLFW
+#include <GLFW/glfw3.h>
+// Include GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+using namespace glm;
+// Include AntTweakBar
+#include <AntTweakBar.h>
+
+#include <common/shader.hpp>
+#include <common/controls.hpp>
+#include <common/objloader.hpp>
+#include <common/assetloader.hpp>
+#include <common/vertexpacking.hpp>
+#include <common/vboindexer.hpp>
+#include <common/kinematics.hpp>
+#include <common/arm_batch.hpp>
+#include <common/headless.hpp>
+#include <common/bvh.hpp>
+#include <common/pickbuffer.hpp>
+#include <common/mesharena.hpp>
+#include <common/uniformring.hpp>
+#include <common/lightculling.hpp>
+#include <common/profiler.hpp>
+#include <common/simulation.hpp>
+#include <common/collision.hpp>
+#include <common/simlog.hpp>
+#include <common/frustum.hpp>
+#include <common/meshsimplify.hpp>
+
+const int window_width = 1024, window_height = 768;
+
+// 20 bytes: w = 1 is supplied by the vertex fetch, normal and color are normalized integers
+typedef struct Vertex {
+	float Position[3];
+	GLuint Normal;		// GL_INT_2_10_10_10_REV
+	GLubyte Color[4];	// RGBA8
+	void SetPosition(float *coords) {
+		Position[0] = coords[0];
+		Position[1] = coords[1];
+		Position[2] = coords[2];
+	}
+	void SetColor(float *color) {
+		packColorRGBA8(color, Color);
+	}
+	void SetNormal(float *coords) {
+		Normal = packNormal2_10_10_10(glm::vec3(coords[0], coords[1], coords[2]));
+	}
+};
+
+// function prototypes
+int initWindow(void);
+int runHeadless(int, const char*, int, const char*, const char*, const char*);
+void initOpenGL(void);
+void createVAOs(Vertex[], const GLvoid*, int);
+void loadObject(LoadedMesh&);
+void setVertexAttributes(void);
+void setDrawDataAttributes(size_t);
+void setupPartVAO(void);
+void updateCellArms(void);
+int controlTicksDue(double);
+float jointDeviation(const ArmJoints&, const ArmJoints&);
+bool startSession(const char*);
+void selectControlTarget(ControlTarget);
+void replayTicks(void);
+SimInput currentSimInput(void);
+void applySimState(const SimState&);
+void advanceSimulation(void);
+void checkArmCollision(void);
+void createWorkLights(void);
+void uploadLights(void);
+void drawArmParts(void);
+void uploadLoadedObjects(bool);
+void createObjects(void);
+void pickObject(void);
+void pickObjectCPU(void);
+void pickObjectAsync(void);
+void pollAsyncPick(void);
+void setActive(int);
+void renderScene(void);
+void cleanup(void);
+static void keyCallback(GLFWwindow*, int, int, int, int);
+static void mouseCallback(GLFWwindow*, int, int, int);
+
+// GLOBAL VARIABLES
+GLFWwindow* window;
+// Headless mode renders into an offscreen framebuffer, without GLFW input or AntTweakBar
+bool gHeadless = false;
+OffscreenTarget gOffscreen;
+
+glm::mat4 gProjectionMatrix;
+glm::mat4 gViewMatrix;
+
+GLuint gPickedIndex = -1;
+std::string gMessage;
+// CPU: ray cast against per-part BVHs. GPU async: ID pass read back through PBOs one frame later.
+// GPU sync: ID pass + glFinish + glReadPixels.
+enum PickingMode { PICK_CPU = 0, PICK_GPU_ASYNC, PICK_GPU_SYNC };
+PickingMode gPickingMode = PICK_CPU;
+AsyncPicker gAsyncPicker;
+bool gPickRequested = false;
+double gPickCursorX, gPickCursorY;
+// Parses the models on worker threads, parts are uploaded as they finish
+AssetLoader gAssetLoader;
+
+GLuint programID;
+GLuint pickingProgramID;
+
+const GLuint NumObjects = 9;	// ATTN: THIS NEEDS TO CHANGE AS YOU ADD NEW OBJECTS
+// Grid
+const int axisIndex = 0;
+const int gridIndex = 1;
+// Normal colored objects
+const int baseIndexStandardColor = 2;
+const int topIndexStandardColor = 3;
+const int arm1IndexStandardColor = 4;
+const int jointIndexStandardColor = 5;
+const int arm2IndexStandardColor = 6;
+const int penIndexStandardColor = 7;
+const int buttonIndexStandardColor = 8;
+// Lights
+//const int lightCube1Index = 9;
+//const int lightCube2Index = 10;
+GLuint VertexArrayId[NumObjects];
+MeshBVH PartBVH[NumObjects];	// model space, built by the asset loader
+MeshBounds PartBounds[NumObjects];	// model space, for view frustum culling
+GLuint VertexBufferId[NumObjects];
+GLuint IndexBufferId[NumObjects];
+
+// TL
+size_t VertexBufferSize[NumObjects];
+size_t IndexBufferSize[NumObjects];
+size_t NumIdcs[NumObjects];
+size_t NumVerts[NumObjects];
+// Bytes of vertex and index buffers currently allocated, shown in the GUI
+unsigned int gGPUBufferBytes = 0;
+
+// The arm parts share one vertex/index arena and one VAO, and are drawn with a single
+// glMultiDrawElementsIndirect. Each draw's model matrix and color are instanced vertex
+// attributes (locations 3-7), one instance per arm, stored part by part: the instances
+// of a part start at the command's baseInstance. Without GL 4.3 each part is one
+// glDrawElementsInstancedBaseVertex with the attributes pointed at that part's instances.
+// A part is one draw per level of detail its instances use.
+struct DrawData {
+	glm::mat4 Model;
+	glm::vec4 Color;
+};
+const int MaxPartDraws = NUM_ARM_LINKS * MaxMeshLods;
+MeshArena gPartArena;
+ArenaRange PartRange[NumObjects];	// indexCount is 0 until the part is loaded
+// Levels of detail: [0] is PartRange, the coarser ones are index lists over its vertices.
+// Each part instance uses the coarsest level whose error, seen at the distance of its
+// bounding sphere, stays under LodErrorPixels (see selectMeshLod).
+ArenaRange PartLodRange[NumObjects][MaxMeshLods];
+float PartLodError[NumObjects][MaxMeshLods];	// model units
+int PartLodCount[NumObjects];
+const float LodErrorPixels = 0.5f;
+const float LodHysteresis = 0.2f;
+std::vector<unsigned char> gPartLod;	// level of every part instance, [link * gArmCount + arm]
+// A part's instances in view, before they are sorted by level
+struct VisibleDraw {
+	glm::mat4 Model;
+	glm::vec4 Color;
+	int Arm;
+};
+std::vector<VisibleDraw> gVisibleDraws;
+unsigned int gTrianglesDrawn = 0;	// arm parts only, shown in the GUI
+GLuint PartVertexArrayId;
+GLuint DrawDataBufferId;
+size_t DrawDataCapacity = 0;	// in DrawData entries
+GLuint IndirectBufferId;
+bool gMultiDrawIndirect = false;
+std::vector<DrawData> gDrawData;
+// Objects (axes, grid, arm part instances) whose bounds are wholly outside the view frustum
+// are not drawn. Counted per frame, both shown in the GUI.
+Frustum gViewFrustum;
+std::vector<unsigned char> gArmVisible;
+unsigned int gObjectsDrawn = 0;
+unsigned int gObjectsCulled = 0;
+
+// Work cell (--arms N): arm 0 is the one the keys move, the other arms stand on a grid
+// around it and run a canned motion. Their links are computed as one ArmBatch per frame.
+int gArmCount = 1;
+ArmBatch gCellArms;	// arm 0 is unused, its links come from gArmChain
+float gCellTime = 0.0f;
+
+// Lights: 0 follows the camera and reaches everything, the rest (--lights N) are work lights
+// hung over the cell. Every frame each cluster (screen tile x depth slice) gets the list of
+// lights that reach it, read by the fragment shader from two texture buffers.
+int gWorkLightCount = 0;
+std::vector<PointLight> gLights;
+const int LightTileSize = 32;
+const int LightDepthSlices = 16;
+LightClusterGrid gLightClusters;
+GLuint LightClustersBufferId, LightClustersTextureId;
+GLuint LightIndicesBufferId, LightIndicesTextureId;
+unsigned int gLightCount = 0;
+unsigned int gMaxLightsPerCluster = 0;	// both shown in the GUI
+const float NearPlane = 0.1f, FarPlane = 100.0f;
+// Framebuffer pixels the scene is drawn to; the light grid is sized to match
+int gViewportWidth = window_width, gViewportHeight = window_height;
+
+// Uniforms go through std140 blocks written to a persistently mapped ring: one FrameData
+// and one LightData per frame for the StandardShading shaders, one PickObjectData per part
+// for the Picking ones.
+struct FrameData {
+	glm::mat4 V;
+	glm::mat4 P;
+};
+struct LightData {
+	GLuint LightGrid[4];	// tiles per row, tile size, tile rows, depth slices
+	float LightSlices[4];	// slice = log(depth) * [0] + [1]
+	glm::vec4 LightPositionRadius[MaxLights];	// camera space
+	glm::vec4 LightColorPower[MaxLights];
+};
+struct PickObjectData {
+	glm::mat4 MVP;
+	glm::vec4 PickingColor;	// red channel = RobotArmLink index
+};
+const GLuint FrameDataBinding = 0;
+const GLuint ObjectDataBinding = 1;
+const GLuint LightDataBinding = 2;
+UniformRing gUniformRing;
+// GL calls renderScene() made last frame (see glcallcount.hpp), shown in the GUI
+unsigned int gGLCallsPerFrame = 0;
+
+// CPU scopes and GPU passes of every frame (--trace <file.json> writes a Chrome trace).
+// The GUI shows the frame time percentiles and the GPU time of the scene pass.
+Profiler gProfiler;
+float gFrameMsP50 = 0.0f, gFrameMsP95 = 0.0f, gFrameMsP99 = 0.0f;
+float gSceneGpuMs = 0.0f;
+
+// Declare global objects
+// TL
+const size_t CoordVertsCount = 6;
+Vertex CoordVerts[CoordVertsCount];
+// Colors 
+float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+float green[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+float blue[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+// General vertices
+float origin[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+float xMax[4] = { 5.0f, 0.0f, 0.0f, 1.0f };
+float yMax[4] = { 0.0f, 5.0f, 0.0f, 1.0f };
+float zMax[4] = { 0.0f, 0.0f, 5.0f, 1.0f };
+// Grid vertices
+const size_t GridVertsIndexCount = 44;
+Vertex GridVerts[GridVertsIndexCount];
+GLushort GridVertsIndices[GridVertsIndexCount];
+// Obj vertices stored in a 2D array
+#define MAXVERTS 320
+#define MAXPARTS 7
+Vertex RobotArmVerts[MAXPARTS][MAXVERTS];
+GLushort RobotArmIndices[MAXVERTS];
+// Booleans
+bool CameraSelected = false;
+bool BaseSelected = false;
+bool TopSelected = false;
+bool Arm1Selected = false;
+bool Arm2Selected = false;
+bool PenSelected = false;
+bool ShiftPressed = false;
+bool MousePressed = false;
+bool IsObjectActive[NumObjects];
+// Transformations
+glm::vec3 J0_BaseTranslate;
+float J1_TopRotate = 0.0f; // J1
+float J2_Arm1Rotate = 0.0f; // J2
+float J3_Arm2Rotate = 0.0f; // J3
+float J4_PenRotateLongitude = 0.0f; // J4
+float J5_PenRotateLatitude = 0.0f; // J5
+float J6_PenRotateAxis = 0.0f; // J6
+// The camera, the joints and the work cell are simulated in fixed ticks. Windowed, an
+// ArmSimulation thread runs them at --sim-rate <hz> (default 1000) and each frame draws the
+// state interpolated between its two latest ticks. With --sim-rate 0 the frame runs as many
+// ticks of ControlTickSeconds as fit in the real time that passed; headless it runs a fixed
+// count (--sim-ticks <n>, default 1/60 s worth = 2), so a headless run simulates as fast as it renders.
+ArmSimulation gSimulation;
+double gSimRate = 1000.0;
+SimState gSimState;		// without the thread
+glm::vec2 gCameraAngles;	// of the state drawn this frame
+float gControlSpeed = 1.0f;	// ControlConfig::speedScale, set from the GUI
+float gSimHz = 0.0f;		// ticks the thread ran last second, shown in the GUI
+double gControlAccumulator = 0.0;
+double gLastControlTime = -1.0;
+int gHeadlessTicksPerFrame = -1;	// -1: 1/60 s of ticks
+// --record <file> logs every tick, its input and the joints it reached, from the start of
+// the session. --replay <file> steps the simulation with a log's input instead of the keys,
+// in ticks of the log's length, and checks every tick against the joints it recorded.
+SimRecorder gRecorder;
+SimReplay gReplay;
+bool gReplayDone = false;
+unsigned long long gReplayDiverged = 0;	// ticks whose joints came out different from the log
+float gReplayMaxDeviation = 0.0f;
+// Kinematic chain of the arm, with cached world matrices per link
+KinematicChain gArmChain;
+// Self and ground collision of the arm, with the part meshes as they load. The state drawn
+// each frame is checked and the colliding links are shown in the GUI.
+ArmCollider gArmCollider;
+std::string gCollisionMessage = "none";
+// VAO drawn for each RobotArmLink, its material color and whether selecting it highlights it
+const int linkObjectIndex[NUM_ARM_LINKS] = { baseIndexStandardColor, topIndexStandardColor, arm1IndexStandardColor,
+	jointIndexStandardColor, arm2IndexStandardColor, penIndexStandardColor, buttonIndexStandardColor };
+const glm::vec4 linkColor[NUM_ARM_LINKS] = { glm::vec4(1.0, 0.0, 0.0, 1.0), glm::vec4(0.0, 1.0, 0.0, 1.0),
+	glm::vec4(0.0, 0.0, 1.0, 1.0), glm::vec4(1.0, 0.0, 1.0, 1.0), glm::vec4(0.0, 1.0, 1.0, 1.0),
+	glm::vec4(1.0, 1.0, 0.0, 1.0), glm::vec4(1.0, 0.0, 0.0, 1.0) };
+const bool linkHighlightable[NUM_ARM_LINKS] = { true, true, true, false, true, true, false };
+const char* linkNames[NUM_ARM_LINKS] = { "base", "top", "arm1", "joint", "arm2", "pen", "button" };
+
+ArmJoints getArmJoints(void) {
+	ArmJoints joints;
+	joints.baseTranslate = J0_BaseTranslate;
+	joints.topRotate = J1_TopRotate;
+	joints.arm1Rotate = J2_Arm1Rotate;
+	joints.arm2Rotate = J3_Arm2Rotate;
+	joints.penRotateLongitude = J4_PenRotateLongitude;
+	joints.penRotateLatitude = J5_PenRotateLatitude;
+	joints.penRotateAxis = J6_PenRotateAxis;
+	return joints;
+}
+
+int initWindow(void) {
+	// Initialise GLFW
+	if (!glfwInit()) {
+		fprintf(stderr, "Failed to initialize GLFW\n");
+		return -1;
+	}
+
+	glfwWindowHint(GLFW_SAMPLES, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	//glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);	// FOR MAC
+
+	// Open a window and create its OpenGL context
+	window = glfwCreateWindow(window_width, window_height, "Ajoy,Nicole(30795334)", NULL, NULL);
+	if (window == NULL) {
+		fprintf(stderr, "Failed to open GLFW window. If you have an Intel GPU, they are not 3.3 compatible. Try the 2.1 version of the tutorials.\n");
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// Initialize GLEW
+	glewExperimental = true; // Needed for core profile
+	if (glewInit() != GLEW_OK) {
+		fprintf(stderr, "Failed to initialize GLEW\n");
+		return -1;
+	}
+
+	// Initialize the GUI
+	TwInit(TW_OPENGL_CORE, NULL);
+	TwWindowSize(window_width, window_height);
+	TwBar * GUI = TwNewBar("Picking");
+	TwSetParam(GUI, NULL, "refresh", TW_PARAM_CSTRING, 1, "0.1");
+	TwAddVarRW(GUI, "Last picked object", TW_TYPE_STDSTRING, &gMessage, NULL);
+	TwType PickingModeType = TwDefineEnumFromString("PickingMode", "CPU ray cast,GPU async,GPU sync");
+	TwAddVarRW(GUI, "Picking mode", PickingModeType, &gPickingMode, NULL);
+	TwAddVarRO(GUI, "GPU buffer bytes", TW_TYPE_UINT32, &gGPUBufferBytes, NULL);
+	TwAddVarRO(GUI, "GL calls/frame", TW_TYPE_UINT32, &gGLCallsPerFrame, NULL);
+	TwAddVarRO(GUI, "Lights", TW_TYPE_UINT32, &gLightCount, NULL);
+	TwAddVarRO(GUI, "Max lights/cluster", TW_TYPE_UINT32, &gMaxLightsPerCluster, NULL);
+	TwAddVarRO(GUI, "Objects drawn", TW_TYPE_UINT32, &gObjectsDrawn, NULL);
+	TwAddVarRO(GUI, "Objects culled", TW_TYPE_UINT32, &gObjectsCulled, NULL);
+	TwAddVarRO(GUI, "Triangles/frame", TW_TYPE_UINT32, &gTrianglesDrawn, NULL);
+	TwAddVarRO(GUI, "Frame ms p50", TW_TYPE_FLOAT, &gFrameMsP50, "precision=2");
+	TwAddVarRO(GUI, "Frame ms p95", TW_TYPE_FLOAT, &gFrameMsP95, "precision=2");
+	TwAddVarRO(GUI, "Frame ms p99", TW_TYPE_FLOAT, &gFrameMsP99, "precision=2");
+	TwAddVarRO(GUI, "Scene GPU ms", TW_TYPE_FLOAT, &gSceneGpuMs, "precision=2");
+	TwAddVarRW(GUI, "Control speed", TW_TYPE_FLOAT, &gControlSpeed, "min=0.1 max=10 step=0.1");
+	TwAddVarRO(GUI, "Simulation Hz", TW_TYPE_FLOAT, &gSimHz, "precision=0");
+	TwAddVarRO(GUI, "Collision", TW_TYPE_STDSTRING, &gCollisionMessage, NULL);
+
+	// Set up inputs
+	glfwSetCursorPos(window, window_width / 2, window_height / 2);
+	glfwSetKeyCallback(window, keyCallback);
+	glfwSetMouseButtonCallback(window, mouseCallback);
+
+	return 0;
+}
+
+void initOpenGL(void) {
+	// Enable depth test
+	glEnable(GL_DEPTH_TEST);
+	// Accept fragment if it closer to the camera than the former one
+	glDepthFunc(GL_LESS);
+	// Cull triangles which normal is not towards the camera
+	glEnable(GL_CULL_FACE);
+
+	// Projection matrix : 45 Field of View, 4:3 ratio, display range : 0.1 unit <-> 100 units
+	gProjectionMatrix = glm::perspective(45.0f, 4.0f / 3.0f, NearPlane, FarPlane);
+	// Or, for an ortho camera :
+	//gProjectionMatrix = glm::ortho(-4.0f, 4.0f, -3.0f, 3.0f, 0.0f, 100.0f); // In world coordinates
+
+	// Camera matrix
+	gViewMatrix = glm::lookAt(glm::vec3(10.0, 10.0, 10.0f),	// eye
+		glm::vec3(0.0, 0.0, 0.0),	// center
+		glm::vec3(0.0, 1.0, 0.0));	// up
+
+	// Create and compile our GLSL program from the shaders
+	programID = LoadShaders("StandardShading.vertexshader", "StandardShading.fragmentshader");
+	pickingProgramID = LoadShaders("Picking.vertexshader", "Picking.fragmentshader");
+
+	// GLSL 330 has no binding qualifier for uniform blocks, so the binding points are set here
+	glUniformBlockBinding(programID, glGetUniformBlockIndex(programID, "FrameData"), FrameDataBinding);
+	glUniformBlockBinding(pickingProgramID, glGetUniformBlockIndex(pickingProgramID, "ObjectData"), ObjectDataBinding);
+	glUniformBlockBinding(programID, glGetUniformBlockIndex(programID, "LightData"), LightDataBinding);
+	// Room for a FrameData, a LightData and a picking pass per frame, three frames in flight
+	gUniformRing.init(16384, 3);
+	gGPUBufferBytes += gUniformRing.bytes();
+	gProfiler.init();
+
+	// Per-cluster light lists, refilled every frame, on texture units 1 and 2
+	gLightClusters.resize(gViewportWidth, gViewportHeight, LightTileSize, LightDepthSlices, NearPlane, FarPlane);
+	glGenBuffers(1, &LightClustersBufferId);
+	glGenBuffers(1, &LightIndicesBufferId);
+	glGenTextures(1, &LightClustersTextureId);
+	glGenTextures(1, &LightIndicesTextureId);
+	glBindBuffer(GL_TEXTURE_BUFFER, LightClustersBufferId);
+	glBufferData(GL_TEXTURE_BUFFER, gLightClusters.getClusterRanges().size() * sizeof(GLuint), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, LightIndicesBufferId);
+	glBufferData(GL_TEXTURE_BUFFER, MaxLights, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_BUFFER, LightClustersTextureId);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, LightClustersBufferId);
+	glBindTexture(GL_TEXTURE_BUFFER, LightIndicesTextureId);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_R8UI, LightIndicesBufferId);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glUseProgram(programID);
+	glUniform1i(glGetUniformLocation(programID, "LightClusters"), 1);
+	glUniform1i(glGetUniformLocation(programID, "LightIndices"), 2);
+	glUseProgram(0);
+
+	// One indirect draw for the whole arm where the GL has it
+	gMultiDrawIndirect = GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+	gPartArena.init(sizeof(Vertex), 1024, 4096);
+	glGenVertexArrays(1, &PartVertexArrayId);
+	glGenBuffers(1, &DrawDataBufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, DrawDataBufferId);
+	DrawDataCapacity = NUM_ARM_LINKS * gArmCount;
+	glBufferData(GL_ARRAY_BUFFER, DrawDataCapacity * sizeof(DrawData), NULL, GL_STREAM_DRAW);
+	glGenBuffers(1, &IndirectBufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, IndirectBufferId);
+	glBufferData(GL_ARRAY_BUFFER, MaxPartDraws * sizeof(DrawElementsIndirectCommand), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	gGPUBufferBytes += gPartArena.bytes() + DrawDataCapacity * sizeof(DrawData) + MaxPartDraws * sizeof(DrawElementsIndirectCommand);
+	setupPartVAO();
+	gCellArms.resize(gArmCount);
+
+	// TL
+	// Define objects
+	gAssetLoader.start(0);
+	createObjects();
+	createWorkLights();
+	buildRobotArmChain(gArmChain);
+	// The simulation starts at rest from the joints and camera angles controls.cpp holds
+	gSimState.joints = getArmJoints();
+	gSimState.jointVelocities = ArmJoints();
+	gSimState.cameraAngles = getCameraAngles();
+	gSimState.cameraVelocity = glm::vec2(0.0f);
+	gSimState.cellTime = 0.0f;
+	gCameraAngles = gSimState.cameraAngles;
+	gAsyncPicker.init(5, 3);
+
+	// ATTN: create VAOs for each of the newly created objects here:
+	VertexBufferSize[0] = sizeof(CoordVerts);
+	NumVerts[0] = CoordVertsCount;
+	createVAOs(CoordVerts, NULL, 0);
+
+	VertexBufferSize[1] = sizeof(GridVerts);
+	NumVerts[1] = GridVertsIndexCount;
+	createVAOs(GridVerts, NULL, 1);
+}
+
+void createVAOs(Vertex Vertices[], const GLvoid* Indices, int ObjectId) {
+	GLenum ErrorCheckValue = glGetError();
+
+	// Create Vertex Array Object
+	glGenVertexArrays(1, &VertexArrayId[ObjectId]);
+	glBindVertexArray(VertexArrayId[ObjectId]);
+
+	// Create Buffer for vertex data
+	glGenBuffers(1, &VertexBufferId[ObjectId]);
+	glBindBuffer(GL_ARRAY_BUFFER, VertexBufferId[ObjectId]);
+	glBufferData(GL_ARRAY_BUFFER, VertexBufferSize[ObjectId], Vertices, GL_STATIC_DRAW);
+
+	// Create Buffer for indices
+	if (Indices != NULL) {
+		glGenBuffers(1, &IndexBufferId[ObjectId]);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBufferId[ObjectId]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexBufferSize[ObjectId], Indices, GL_STATIC_DRAW);
+		gGPUBufferBytes += IndexBufferSize[ObjectId];
+	}
+	gGPUBufferBytes += VertexBufferSize[ObjectId];
+
+	// Assign vertex attributes
+	setVertexAttributes();
+
+	// Disable our Vertex Buffer Object 
+	glBindVertexArray(0);
+
+	ErrorCheckValue = glGetError();
+	if (ErrorCheckValue != GL_NO_ERROR)
+	{
+		fprintf(
+			stderr,
+			"ERROR: Could not create a VBO: %s \n",
+			gluErrorString(ErrorCheckValue)
+		);
+	}
+}
+
+// Vertex layout shared by createVAOs() and the part VAO, for the currently bound vertex buffer
+void setVertexAttributes(void) {
+	const size_t VertexSize = sizeof(Vertex);
+	const size_t Normaloffset = sizeof(((Vertex*)0)->Position);
+	const size_t RgbOffset = sizeof(((Vertex*)0)->Normal) + Normaloffset;
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VertexSize, 0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, VertexSize, (GLvoid*)RgbOffset);
+	glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, VertexSize, (GLvoid*)Normaloffset);	// TL
+
+	glEnableVertexAttribArray(0);	// position
+	glEnableVertexAttribArray(1);	// color
+	glEnableVertexAttribArray(2);	// normal
+}
+
+// (Re)binds the part arena's buffers to the part VAO, again after the arena grows
+void setupPartVAO(void) {
+	glBindVertexArray(PartVertexArrayId);
+	glBindBuffer(GL_ARRAY_BUFFER, gPartArena.getVertexBuffer());
+	setVertexAttributes();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gPartArena.getIndexBuffer());
+
+	// Model matrix in 3-6 (one column each) and color in 7, advancing once per instance
+	glBindBuffer(GL_ARRAY_BUFFER, DrawDataBufferId);
+	setDrawDataAttributes(0);
+	for (int i = 0; i < 5; i++) {
+		glVertexAttribDivisor(3 + i, 1);
+		glEnableVertexAttribArray(3 + i);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Points the per-draw attributes at the DrawData buffer, starting at entry firstDraw
+void setDrawDataAttributes(size_t firstDraw) {
+	for (int i = 0; i < 5; i++) {
+		glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(DrawData),
+			(GLvoid*)(firstDraw * sizeof(DrawData) + i * sizeof(glm::vec4)));
+	}
+}
+
+// Sets the per-draw attributes as constants, for VAOs that have no array bound to them
+void setDrawAttributes(const glm::mat4& Model, const glm::vec4& Color) {
+	for (int i = 0; i < 4; i++) {
+		glVertexAttrib4fv(3 + i, &Model[i][0]);
+	}
+	glVertexAttrib4fv(7, &Color[0]);
+}
+
+// Ensure your .obj files are in the correct format and properly loaded by looking at the following function
+void loadObject(LoadedMesh& mesh) {
+	const int ObjectId = mesh.id;
+	std::vector<GLuint>& indices = mesh.indices;
+	std::vector<glm::vec3>& indexed_vertices = mesh.vertices;
+	std::vector<glm::vec3>& indexed_normals = mesh.normals;
+	PartBVH[ObjectId] = mesh.bvh;
+	PartBounds[ObjectId] = computeMeshBounds(indexed_vertices);
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		if (linkObjectIndex[link] == ObjectId) {
+			gArmCollider.setLinkShape(link, indexed_vertices);
+		}
+	}
+
+	const size_t vertCount = indexed_vertices.size();
+	const size_t idxCount = indices.size();
+	//std::cout << "objectId: " << ObjectId << " | vertCount: " << vertCount << " | idxCount: " << idxCount << std::endl;
+
+	// populate output arrays
+	std::vector<Vertex> Verts(vertCount);
+	for (int i = 0; i < vertCount; i++) {
+		Verts[i].SetPosition(&indexed_vertices[i].x);
+		Verts[i].SetNormal(&indexed_normals[i].x);
+		Verts[i].SetColor(white);	// the part color comes from the per-draw color
+	}
+	if (vertCount == 0 || idxCount == 0) {
+		return;
+	}
+
+	// Append to the part arena; its VAO has to be rebuilt when the buffers were reallocated
+	const size_t arenaBytes = gPartArena.bytes();
+	bool reallocated;
+	PartRange[ObjectId] = gPartArena.add(&Verts[0], vertCount, &indices[0], idxCount, reallocated);
+	if (reallocated) {
+		setupPartVAO();
+	}
+	PartLodRange[ObjectId][0] = PartRange[ObjectId];
+	PartLodError[ObjectId][0] = 0.0f;
+	PartLodCount[ObjectId] = 1;
+	for (size_t lod = 0; lod < mesh.lods.size() && lod + 1 < MaxMeshLods; lod++) {
+		const int level = PartLodCount[ObjectId]++;
+		PartLodRange[ObjectId][level] = gPartArena.addIndices(PartRange[ObjectId], &mesh.lods[lod].indices[0],
+			(GLsizei)mesh.lods[lod].indices.size(), reallocated);
+		PartLodError[ObjectId][level] = mesh.lods[lod].error;
+		if (reallocated) {
+			setupPartVAO();
+		}
+	}
+	gGPUBufferBytes += gPartArena.bytes() - arenaBytes;
+}
+
+void createObjects(void) {
+	//-- COORDINATE AXES --//
+	float* axisEnds[CoordVertsCount] = { origin, xMax, origin, yMax, origin, zMax };
+	float* axisColors[CoordVertsCount] = { red, red, green, green, blue, blue };
+	float axisNormal[3] = { 0.0, 0.0, 1.0 };
+	for (int i = 0; i < CoordVertsCount; i++) {
+		CoordVerts[i].SetPosition(axisEnds[i]);
+		CoordVerts[i].SetColor(axisColors[i]);
+		CoordVerts[i].SetNormal(axisNormal);
+	}
+	
+	//-- GRID --//
+	
+	// ATTN: Create your grid vertices here!
+	int gridVertCounter = 0;
+	for (int x = -5; x <= 5; x++) {
+		float v1[4] = { x, 0, -5, 1.0f };
+		GridVerts[gridVertCounter].SetPosition(v1);
+		GridVerts[gridVertCounter].SetColor(white);
+		float v2[4] = { x, 0, 5, 1.0f };
+		GridVerts[gridVertCounter + 1].SetPosition(v2);
+		GridVerts[gridVertCounter + 1].SetColor(white);
+		gridVertCounter += 2;
+	}
+	for (int z = -5; z <= 5; z++) {
+		float v1[4] = { -5, 0, z, 1.0f };
+		GridVerts[gridVertCounter].SetPosition(v1);
+		GridVerts[gridVertCounter].SetColor(white);
+		float v2[4] = { 5, 0, z, 1.0f };
+		GridVerts[gridVertCounter + 1].SetPosition(v2);
+		GridVerts[gridVertCounter + 1].SetColor(white);
+		gridVertCounter += 2;
+	}
+	std::vector<glm::vec3> axisPoints, gridPoints;
+	for (size_t i = 0; i < CoordVertsCount; i++) {
+		axisPoints.push_back(glm::vec3(CoordVerts[i].Position[0], CoordVerts[i].Position[1], CoordVerts[i].Position[2]));
+	}
+	for (int i = 0; i < gridVertCounter; i++) {
+		gridPoints.push_back(glm::vec3(GridVerts[i].Position[0], GridVerts[i].Position[1], GridVerts[i].Position[2]));
+	}
+	PartBounds[axisIndex] = computeMeshBounds(axisPoints);
+	PartBounds[gridIndex] = computeMeshBounds(gridPoints);
+	
+	//-- .OBJs --//
+
+	// ATTN: Load your models here through .obj files -- example of how to do so is as shown
+	// Each part is loaded once, its color and highlight are set per draw. The files are parsed
+	// on the asset loader threads and uploaded by uploadLoadedObjects() as they finish.
+	gAssetLoader.request("models/base.obj", baseIndexStandardColor);
+	gAssetLoader.request("models/top.obj", topIndexStandardColor);
+	gAssetLoader.request("models/arm1.obj", arm1IndexStandardColor);
+	gAssetLoader.request("models/joint.obj", jointIndexStandardColor);
+	gAssetLoader.request("models/arm2.obj", arm2IndexStandardColor);
+	gAssetLoader.request("models/pen.obj", penIndexStandardColor);
+	gAssetLoader.request("models/button.obj", buttonIndexStandardColor);
+
+	// Load light cubes with emmision material
+	//gAssetLoader.request("models/lightcube1.obj", lightCube1Index);
+	//gAssetLoader.request("models/lightcube2.obj", lightCube2Index);
+}
+
+// Uploads the meshes the asset loader has finished into the part arena, on the GL thread.
+// Returns right away unless waitForAll is set.
+void uploadLoadedObjects(bool waitForAll) {
+	LoadedMesh mesh;
+	while (waitForAll ? gAssetLoader.waitNext(mesh) : gAssetLoader.poll(mesh)) {
+		if (mesh.ok) {
+			loadObject(mesh);
+		}
+	}
+}
+
+// Moves the work cell arms along their canned motion and computes their links
+void updateCellArms(void) {
+	if (gArmCount <= 1) {
+		return;
+	}
+	for (int arm = 1; arm < gArmCount; arm++) {
+		gCellArms.setArm(arm, cellArmJoints(arm, gArmCount, gCellTime));
+	}
+	computeArmBatch(gCellArms, 0, gArmCount);
+}
+
+// Names the colliding links of the arm the keys move, for the GUI
+void checkArmCollision(void) {
+	CollisionContact contacts[4];
+	const int found = gArmCollider.checkConfiguration(getArmJoints(), contacts, 4);
+	if (found == 0) {
+		gCollisionMessage = "none";
+		return;
+	}
+	std::ostringstream oss;
+	for (int i = 0; i < found; i++) {
+		if (i > 0)
+			oss << ", ";
+		oss << linkNames[contacts[i].linkA] << "-" <<
+			(contacts[i].linkB == CollisionGround ? "grid" : linkNames[contacts[i].linkB]);
+	}
+	gCollisionMessage = oss.str();
+}
+
+int controlTicksDue(double tickSeconds) {
+	if (gHeadless) {
+		return gHeadlessTicksPerFrame >= 0 ? gHeadlessTicksPerFrame : std::max(1, (int)(1.0 / 60.0 / tickSeconds + 0.5));
+	}
+	const double now = glfwGetTime();
+	if (gLastControlTime < 0.0) {
+		gLastControlTime = now;
+	}
+	// After a stall (a breakpoint, a window drag) only a quarter of a second is caught up
+	gControlAccumulator += std::min(now - gLastControlTime, 0.25);
+	gLastControlTime = now;
+	const int ticks = (int)(gControlAccumulator / tickSeconds);
+	gControlAccumulator -= ticks * tickSeconds;
+	return ticks;
+}
+
+// Largest difference between two arm states, over every joint
+float jointDeviation(const ArmJoints& a, const ArmJoints& b) {
+	const glm::vec3 base = glm::abs(a.baseTranslate - b.baseTranslate);
+	float deviation = std::max(std::max(base.x, base.y), base.z);
+	deviation = std::max(deviation, std::fabs(a.topRotate - b.topRotate));
+	deviation = std::max(deviation, std::fabs(a.arm1Rotate - b.arm1Rotate));
+	deviation = std::max(deviation, std::fabs(a.arm2Rotate - b.arm2Rotate));
+	deviation = std::max(deviation, std::fabs(a.penRotateLongitude - b.penRotateLongitude));
+	deviation = std::max(deviation, std::fabs(a.penRotateLatitude - b.penRotateLatitude));
+	return std::max(deviation, std::fabs(a.penRotateAxis - b.penRotateAxis));
+}
+
+// After initOpenGL(). A replay starts from the log's first state, a recording from the current
+// one. The simulation thread only runs when the ticks come from the keys.
+bool startSession(const char* recordPath) {
+	if (gReplay.isOpen()) {
+		if (jointDeviation(gReplay.getInitial().joints, gSimState.joints) > 0.0f) {
+			printf("The log starts from another arm state; the replay starts there\n");
+		}
+		gSimState = gReplay.getInitial();
+		applySimState(gSimState);
+	}
+	const bool threaded = !gHeadless && gSimRate > 0.0 && !gReplay.isOpen();
+	const double tickSeconds = threaded ? 1.0 / gSimRate : gReplay.isOpen() ? gReplay.getTickSeconds() : ControlTickSeconds;
+	if (recordPath != NULL && !gRecorder.open(recordPath, tickSeconds, gSimState)) {
+		fprintf(stderr, "Could not write %s\n", recordPath);
+		return false;
+	}
+	if (threaded) {
+		gSimulation.start(gSimRate, gSimState, gRecorder.isOpen() ? &gRecorder : NULL);
+	}
+	return true;
+}
+
+// Selects the part a replayed tick drives, the way a key or a click would have
+void selectControlTarget(ControlTarget target) {
+	const int targetObject[] = { -1, 0, baseIndexStandardColor, topIndexStandardColor, arm1IndexStandardColor,
+		arm2IndexStandardColor, penIndexStandardColor };
+	const int index = targetObject[target];
+	if (index >= 0 && !IsObjectActive[index]) {
+		setActive(index);
+	}
+	else if (index < 0) {
+		for (int i = 0; i < NumObjects; i++) {
+			IsObjectActive[i] = false;
+		}
+	}
+}
+
+// Runs this frame's ticks from the replayed log and compares them with the recording.
+// Headless, the whole log runs in the first frame unless --sim-ticks sets a pace.
+void replayTicks(void) {
+	const int ticks = gHeadless && gHeadlessTicksPerFrame < 0 ? INT_MAX : controlTicksDue(gReplay.getTickSeconds());
+	for (int tick = 0; tick < ticks && !gReplayDone; tick++) {
+		SimInput input;
+		ArmJoints recorded;
+		if (!gReplay.next(input, recorded)) {
+			gReplayDone = true;
+			printf("replay finished: %llu ticks, %llu diverged from the log (max deviation %g)\n",
+				gReplay.getTicks(), gReplayDiverged, gReplayMaxDeviation);
+			break;
+		}
+		selectControlTarget(input.target);
+		ShiftPressed = input.shift;
+		gControlSpeed = input.speedScale;
+		stepSimulation(input, gSimState, (float)gReplay.getTickSeconds());
+		if (gRecorder.isOpen()) {
+			gRecorder.record(input, gSimState);
+		}
+		const float deviation = jointDeviation(gSimState.joints, recorded);
+		if (deviation > 0.0f) {
+			gReplayDiverged++;
+			gReplayMaxDeviation = std::max(gReplayMaxDeviation, deviation);
+		}
+	}
+	applySimState(gSimState);
+}
+
+// Keys and selection for the simulation, sampled once per frame
+SimInput currentSimInput(void) {
+	SimInput input;
+	input.keys = sampleControlInputs();
+	input.shift = ShiftPressed;
+	input.speedScale = gControlSpeed;
+	if (IsObjectActive[0])
+		input.target = CONTROL_CAMERA;
+	else if (IsObjectActive[baseIndexStandardColor])
+		input.target = CONTROL_BASE;
+	else if (IsObjectActive[topIndexStandardColor])
+		input.target = CONTROL_TOP;
+	else if (IsObjectActive[arm1IndexStandardColor])
+		input.target = CONTROL_ARM1;
+	else if (IsObjectActive[arm2IndexStandardColor])
+		input.target = CONTROL_ARM2;
+	else if (IsObjectActive[penIndexStandardColor])
+		input.target = CONTROL_PEN;
+	return input;
+}
+
+void applySimState(const SimState& state) {
+	J0_BaseTranslate = state.joints.baseTranslate;
+	J1_TopRotate = state.joints.topRotate;
+	J2_Arm1Rotate = state.joints.arm1Rotate;
+	J3_Arm2Rotate = state.joints.arm2Rotate;
+	J4_PenRotateLongitude = state.joints.penRotateLongitude;
+	J5_PenRotateLatitude = state.joints.penRotateLatitude;
+	J6_PenRotateAxis = state.joints.penRotateAxis;
+	gCameraAngles = state.cameraAngles;
+	gCellTime = state.cellTime;
+}
+
+// Hands this frame's input to the simulation and takes the state to draw from it. The thread's
+// state is drawn one tick late, interpolated between the two ticks around that time. A replay
+// takes its input from the log instead.
+void advanceSimulation(void) {
+	if (gReplay.isOpen()) {
+		replayTicks();
+		return;
+	}
+	const SimInput input = currentSimInput();
+	if (gSimulation.isRunning()) {
+		gSimulation.setInput(input);
+		SimSnapshot snapshot;
+		if (gSimulation.latest(snapshot)) {
+			const double tick = gSimulation.getTickSeconds();
+			applySimState(interpolateSimState(snapshot, tick, gSimulation.now() - tick));
+		}
+		return;
+	}
+	const int ticks = controlTicksDue(ControlTickSeconds);
+	for (int tick = 0; tick < ticks; tick++) {
+		stepSimulation(input, gSimState, ControlTickSeconds);
+		if (gRecorder.isOpen()) {
+			gRecorder.record(input, gSimState);
+		}
+	}
+	applySimState(gSimState);
+}
+
+// The camera light, then the work lights on a grid over the cell, 2.5 units up
+void createWorkLights(void) {
+	PointLight cameraLight;
+	cameraLight.position = glm::vec3(0.0f);
+	cameraLight.radius = 0.0f;
+	cameraLight.color = glm::vec3(1.0f);
+	cameraLight.power = 80.0f;
+	gLights.assign(1, cameraLight);
+
+	const glm::vec3 workColors[4] = { glm::vec3(1.0f, 0.85f, 0.6f), glm::vec3(0.6f, 0.8f, 1.0f),
+		glm::vec3(1.0f, 0.6f, 0.3f), glm::vec3(0.8f, 1.0f, 0.8f) };
+	const int cellSide = (int)ceil(sqrt((float)gArmCount));
+	const float cellExtent = std::max(10.0f, (cellSide - 1) * CellSpacing + 5.0f);
+	const int lightCount = std::min(gWorkLightCount, MaxLights - 1);
+	const int side = (int)ceil(sqrt((float)lightCount));
+	for (int i = 0; i < lightCount; i++) {
+		PointLight light;
+		light.position = glm::vec3(-5.0f + cellExtent * ((i % side) + 0.5f) / side, 2.5f,
+			5.0f - cellExtent * ((i / side) + 0.5f) / side);
+		light.radius = 4.0f;
+		light.color = workColors[i % 4];
+		light.power = 2.0f;
+		gLights.push_back(light);
+	}
+	gLightCount = (unsigned int)gLights.size();
+}
+
+// Follows the window's framebuffer, which can differ from the window size on high-DPI screens
+// and changes when the window is resized. The offscreen target of --headless is fixed.
+void updateViewport(void) {
+	int width = window_width, height = window_height;
+	if (!gHeadless) {
+		glfwGetFramebufferSize(window, &width, &height);
+	}
+	if (width == gViewportWidth && height == gViewportHeight) {
+		return;
+	}
+	gViewportWidth = width;
+	gViewportHeight = height;
+	glViewport(0, 0, width, height);
+	gLightClusters.resize(width, height, LightTileSize, LightDepthSlices, NearPlane, FarPlane);
+}
+
+// Moves the camera light, bins the lights into clusters and uploads lights and cluster lists
+void uploadLights(void) {
+	// The shaders used to get two camera lights set one after the other; only the second one
+	// ever reached them, and that is the one kept
+	const glm::vec3 cameraPosition = getCameraPosition();
+	gLights[0].position = glm::vec3(cameraPosition.x - 5, cameraPosition.y, cameraPosition.z);
+	gLightClusters.cull(gLights, gViewMatrix, gProjectionMatrix);
+	gMaxLightsPerCluster = gLightClusters.getMaxLightsPerCluster();
+
+	static LightData lightData;
+	lightData.LightGrid[0] = gLightClusters.getTilesX();
+	lightData.LightGrid[1] = gLightClusters.getTileSize();
+	lightData.LightGrid[2] = gLightClusters.getTilesY();
+	lightData.LightGrid[3] = gLightClusters.getNumSlices();
+	lightData.LightSlices[0] = gLightClusters.getSliceScale();
+	lightData.LightSlices[1] = gLightClusters.getSliceBias();
+	for (size_t i = 0; i < gLights.size() && i < MaxLights; i++) {
+		const PointLight& light = gLights[i];
+		lightData.LightPositionRadius[i] = glm::vec4(glm::vec3(gViewMatrix * glm::vec4(light.position, 1.0f)), light.radius);
+		lightData.LightColorPower[i] = glm::vec4(light.color, light.power);
+	}
+	gUniformRing.upload(LightDataBinding, &lightData, sizeof(lightData));
+
+	// Orphaned every frame, the lists change size with the view
+	const std::vector<unsigned int>& ranges = gLightClusters.getClusterRanges();
+	const std::vector<unsigned char>& indices = gLightClusters.getLightIndices();
+	glBindBuffer(GL_TEXTURE_BUFFER, LightClustersBufferId);
+	glBufferData(GL_TEXTURE_BUFFER, ranges.size() * sizeof(GLuint), &ranges[0], GL_STREAM_DRAW);
+	if (!indices.empty()) {
+		glBindBuffer(GL_TEXTURE_BUFFER, LightIndicesBufferId);
+		glBufferData(GL_TEXTURE_BUFFER, indices.size(), &indices[0], GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_BUFFER, LightClustersTextureId);
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_BUFFER, LightIndicesTextureId);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+// Draws every loaded arm part of every arm that can be in view, at its level of detail: one
+// glMultiDrawElementsIndirect when available, otherwise one instanced draw per part and level
+void drawArmParts(void) {
+	DrawElementsIndirectCommand commands[MaxPartDraws];
+	int numDraws = 0;
+	size_t numInstances = 0;
+	gDrawData.resize((size_t)NUM_ARM_LINKS * gArmCount);
+	gVisibleDraws.resize(gArmCount);
+	gArmVisible.resize((size_t)gArmCount + ArmBatchLanes);
+	gPartLod.resize((size_t)NUM_ARM_LINKS * gArmCount, 0);
+	// Camera position, and how many framebuffer pixels a model unit covers at distance 1
+	const glm::vec3 eye = glm::vec3(glm::inverse(gViewMatrix)[3]);
+	const float pixelsPerUnit = 0.5f * gProjectionMatrix[1][1] * gViewportHeight;
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		const int objectId = linkObjectIndex[link];
+		if (PartRange[objectId].indexCount == 0) {
+			continue;	// not loaded yet
+		}
+		// Instances of this part in view: the interactive arm, then the rest of the cell, culled
+		// straight from the batch's link matrices
+		const MeshBounds& bounds = PartBounds[objectId];
+		GLuint visible = 0;
+		if (boundsInFrustum(gViewFrustum, bounds, gArmChain.getWorldMatrix(link))) {
+			gVisibleDraws[0].Model = gArmChain.getWorldMatrix(link);
+			gVisibleDraws[0].Color = linkColor[link];
+			gVisibleDraws[0].Arm = 0;
+			// Selected parts are drawn in a lighter shade of their color
+			if (IsObjectActive[objectId] && linkHighlightable[link]) {
+				gVisibleDraws[0].Color = glm::mix(linkColor[link], glm::vec4(1.0f), 0.75f);
+			}
+			visible++;
+		}
+		if (gArmCount > 1) {
+			cullArmBatchLink(gViewFrustum, bounds, gCellArms, link, 0, gArmCount, &gArmVisible[0]);
+			for (int arm = 1; arm < gArmCount; arm++) {
+				if (gArmVisible[arm]) {
+					gVisibleDraws[visible].Model = gCellArms.getLinkMatrix(arm, link);
+					gVisibleDraws[visible].Color = linkColor[link];
+					gVisibleDraws[visible].Arm = arm;
+					visible++;
+				}
+			}
+		}
+		gObjectsDrawn += visible;
+		gObjectsCulled += gArmCount - visible;
+
+		// Their levels of detail, from the distance of their bounding sphere. The instances of
+		// each level are packed one after the other, after the previous part's.
+		GLuint lodInstances[MaxMeshLods] = { 0 };
+		for (GLuint i = 0; i < visible; i++) {
+			const VisibleDraw& draw = gVisibleDraws[i];
+			const float distance = glm::length(glm::vec3(draw.Model * glm::vec4(bounds.center, 1.0f)) - eye);
+			unsigned char& lod = gPartLod[(size_t)link * gArmCount + draw.Arm];
+			lod = (unsigned char)selectMeshLod(PartLodError[objectId], PartLodCount[objectId],
+				pixelsPerUnit / std::max(distance, NearPlane), lod, LodErrorPixels, LodHysteresis);
+			lodInstances[lod]++;
+		}
+		GLuint lodFirst[MaxMeshLods];
+		for (int lod = 0; lod < PartLodCount[objectId]; lod++) {
+			lodFirst[lod] = (GLuint)numInstances;
+			numInstances += lodInstances[lod];
+			if (lodInstances[lod] == 0) {
+				continue;
+			}
+			const ArenaRange& range = PartLodRange[objectId][lod];
+			DrawElementsIndirectCommand command = { (GLuint)range.indexCount, lodInstances[lod], range.firstIndex, range.baseVertex, lodFirst[lod] };
+			commands[numDraws] = command;
+			numDraws++;
+			gTrianglesDrawn += lodInstances[lod] * (GLuint)range.indexCount / 3;
+		}
+		for (GLuint i = 0; i < visible; i++) {
+			const VisibleDraw& draw = gVisibleDraws[i];
+			DrawData& data = gDrawData[lodFirst[gPartLod[(size_t)link * gArmCount + draw.Arm]]++];
+			data.Model = draw.Model;
+			data.Color = draw.Color;
+		}
+	}
+	if (numDraws == 0) {
+		return;
+	}
+
+	// Grows (and orphans) the instance buffer when the cell has more arms than it holds
+	glBindBuffer(GL_ARRAY_BUFFER, DrawDataBufferId);
+	if (numInstances > DrawDataCapacity) {
+		gGPUBufferBytes -= DrawDataCapacity * sizeof(DrawData);
+		DrawDataCapacity = (size_t)NUM_ARM_LINKS * gArmCount;
+		gGPUBufferBytes += DrawDataCapacity * sizeof(DrawData);
+		glBufferData(GL_ARRAY_BUFFER, DrawDataCapacity * sizeof(DrawData), NULL, GL_STREAM_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, numInstances * sizeof(DrawData), &gDrawData[0]);
+
+	glBindVertexArray(PartVertexArrayId);
+	if (gMultiDrawIndirect) {
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBufferId);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, numDraws * sizeof(DrawElementsIndirectCommand), commands);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, numDraws, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	else {
+		// No baseInstance here, so the attributes are re-pointed at each part's instances
+		for (int i = 0; i < numDraws; i++) {
+			setDrawDataAttributes(commands[i].baseInstance);
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, commands[i].count, GL_UNSIGNED_INT,
+				(void*)(commands[i].firstIndex * sizeof(GLuint)), commands[i].instanceCount, commands[i].baseVertex);
+		}
+		setDrawDataAttributes(0);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Draws every arm part in its picking color: red channel = RobotArmLink index, white = background
+void drawPickingScene(const glm::mat4& PickVP) {
+	glUseProgram(pickingProgramID);
+	glBindVertexArray(PartVertexArrayId);
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		const ArenaRange& range = PartRange[linkObjectIndex[link]];
+		if (range.indexCount == 0) {
+			continue;	// not loaded yet
+		}
+		PickObjectData object;
+		object.MVP = PickVP * gArmChain.getWorldMatrix(link);
+		object.PickingColor = glm::vec4(link / 255.0f, 0.0f, 0.0f, 1.0f);
+		gUniformRing.upload(ObjectDataBinding, &object, sizeof(object));
+		glDrawElementsBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+			(void*)(range.firstIndex * sizeof(GLuint)), range.baseVertex);
+	}
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+// Hands a picking result to the selection logic, whichever picking mode produced it
+void selectPickedLink(int link, const glm::vec3* point) {
+	if (link < 0 || link >= NUM_ARM_LINKS) { // Full white, must be the background !
+		gPickedIndex = 255;
+		gMessage = "background";
+		return;
+	}
+
+	gPickedIndex = linkObjectIndex[link];
+	std::ostringstream oss;
+	oss << linkNames[link];
+	if (point != NULL) {
+		oss << " at (" << point->x << ", " << point->y << ", " << point->z << ")";
+	}
+	gMessage = oss.str();
+
+	// Highlightable parts are the ones the arrow keys can move
+	if (linkHighlightable[link]) {
+		setActive(gPickedIndex);
+	}
+}
+
+void pickObject(void) {
+	ProfileScope profile(gProfiler, "pickObject");
+	{
+		GpuProfileScope gpuProfile(gProfiler, "pick sync");
+		// Clear the screen in white
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Runs between frames, so it takes a uniform ring region of its own
+		gUniformRing.beginFrame();
+		drawPickingScene(gProjectionMatrix * gViewMatrix);
+		gUniformRing.endFrame();
+	}
+
+	// Wait until all the pending drawing commands are really done.
+	// Ultra-mega-over slow ! 
+	// There are usually a long time between glDrawElements() and
+	// all the fragments completely rasterized.
+	glFlush();
+	glFinish();
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+	// Read the pixel at the center of the screen.
+	// You can also use glfwGetMousePos().
+	// Ultra-mega-over slow too, even for 1 pixel, 
+	// because the framebuffer is on the GPU.
+	double xpos, ypos;
+	glfwGetCursorPos(window, &xpos, &ypos);
+	unsigned char data[4];
+	glReadPixels(xpos, window_height - 1 - ypos, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, data); // OpenGL renders with (0,0) on bottom, mouse reports with (0,0) on top
+
+	// Convert the color back to an integer ID
+	selectPickedLink(int(data[0]), NULL);
+
+	// Uncomment these lines to see the picking shader in effect
+	//glfwSwapBuffers(window);
+	//continue; // skips the normal rendering
+}
+
+// Renders the picking scene for the pixels around the cursor and queues the readback.
+// The result reaches selectPickedLink() from pollAsyncPick() on a later frame.
+void pickObjectAsync(void) {
+	glm::mat4 PickMatrix;
+	if (!gAsyncPicker.begin(gPickCursorX, gPickCursorY, window_width, window_height, PickMatrix)) {
+		return; // every readback slot is still in flight; drop this click
+	}
+	GpuProfileScope gpuProfile(gProfiler, "pick async");
+	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	drawPickingScene(PickMatrix * gProjectionMatrix * gViewMatrix);
+	gAsyncPicker.end();
+}
+
+void pollAsyncPick(void) {
+	int id;
+	while (gAsyncPicker.poll(id)) {
+		selectPickedLink(id, NULL);
+	}
+}
+
+// Casts the mouse ray against the BVH of every arm part, in that part's model space.
+// Nothing waits on the GPU: the link matrices are the ones renderScene() cached.
+void pickObjectCPU(void) {
+	ProfileScope profile(gProfiler, "pickObjectCPU");
+	double xpos, ypos;
+	glfwGetCursorPos(window, &xpos, &ypos);
+	glm::vec3 rayOrigin, rayDirection;
+	screenPointToRay(xpos, ypos, window_width, window_height, gProjectionMatrix, gViewMatrix, rayOrigin, rayDirection);
+
+	// The ray spans the near to the far plane for t in [0, 1]
+	int pickedLink = -1;
+	RayHit nearest;
+	nearest.t = 1.0f;
+	for (int link = 0; link < NUM_ARM_LINKS; link++) {
+		glm::mat4 InverseModel = glm::inverse(gArmChain.getWorldMatrix(link));
+		glm::vec3 origin = glm::vec3(InverseModel * glm::vec4(rayOrigin, 1.0f));
+		glm::vec3 direction = glm::vec3(InverseModel * glm::vec4(rayDirection, 0.0f));
+
+		RayHit hit;
+		if (PartBVH[linkObjectIndex[link]].intersect(origin, direction, nearest.t, hit)) {
+			nearest = hit;
+			pickedLink = link;
+		}
+	}
+
+	glm::vec3 point = rayOrigin + rayDirection * nearest.t;
+	selectPickedLink(pickedLink, &point);
+}
+
+void renderScene(void) {
+	//ATTN: DRAW YOUR SCENE HERE. MODIFY/ADAPT WHERE NECESSARY!
+
+	const unsigned int callsAtStart = gGLCallCount;
+	gUniformRing.beginFrame();
+	updateViewport();
+
+	// Parts show up as soon as their mesh is loaded
+	{
+		ProfileScope profile(gProfiler, "uploadLoadedObjects");
+		uploadLoadedObjects(false);
+	}
+
+	// Deliver last frame's asynchronous pick, then queue this frame's
+	{
+		ProfileScope profile(gProfiler, "async pick");
+		pollAsyncPick();
+		if (gPickRequested) {
+			pickObjectAsync();
+			gPickRequested = false;
+		}
+	}
+
+	gProfiler.beginGpu("scene");
+	// Dark blue background
+	glClearColor(0.0f, 0.0f, 0.2f, 0.0f);
+	// Re-clear the screen for real rendering
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	glUseProgram(programID);
+	{
+		glm::mat4x4 ModelMatrix = glm::mat4(1.0);
+		{
+			ProfileScope profile(gProfiler, "advanceSimulation");
+			advanceSimulation();
+		}
+		//if (CameraSelected) {
+		if (IsObjectActive[0]) {
+			ProfileScope profile(gProfiler, "computeMatricesFromAngles");
+			computeMatricesFromAngles(gCameraAngles);
+			//gProjectionMatrix = getProjectionMatrix();
+			gViewMatrix = getViewMatrix();
+		}
+		FrameData frame;
+		frame.V = gViewMatrix;
+		frame.P = gProjectionMatrix;
+		gUniformRing.upload(FrameDataBinding, &frame, sizeof(frame));
+		{
+			ProfileScope profile(gProfiler, "uploadLights");
+			uploadLights();
+		}
+		setDrawAttributes(ModelMatrix, glm::vec4(1.0f));
+
+		gViewFrustum = extractFrustum(gProjectionMatrix * gViewMatrix);
+		gObjectsDrawn = 0;
+		gObjectsCulled = 0;
+		gTrianglesDrawn = 0;
+		for (int i = axisIndex; i <= gridIndex; i++) {
+			if (!boundsInFrustum(gViewFrustum, PartBounds[i], ModelMatrix)) {
+				gObjectsCulled++;
+				continue;
+			}
+			glBindVertexArray(VertexArrayId[i]);	// Draw CoordAxes, then Grid
+			glDrawArrays(GL_LINES, 0, NumVerts[i]);
+			gObjectsDrawn++;
+		}
+
+		// Only the links below a joint that moved get their world matrix recomputed
+		{
+			ProfileScope profile(gProfiler, "kinematics");
+			setRobotArmJoints(gArmChain, getArmJoints());
+			gArmChain.update();
+			updateCellArms();
+		}
+		{
+			ProfileScope profile(gProfiler, "collision");
+			checkArmCollision();
+		}
+
+		// Draw base, top, arm1, joint, arm2, pen and button of every arm
+		{
+			ProfileScope profile(gProfiler, "drawArmParts");
+			drawArmParts();
+		}
+
+		glBindVertexArray(0);
+	}
+	glUseProgram(0);
+	gProfiler.endGpu();
+	gUniformRing.endFrame();
+	gGLCallsPerFrame = gGLCallCount - callsAtStart;
+	if (gHeadless)
+		return;
+
+	// Draw GUI
+	{
+		ProfileScope profile(gProfiler, "TwDraw");
+		GpuProfileScope gpuProfile(gProfiler, "GUI");
+		TwDraw();
+	}
+
+	// Swap buffers
+	{
+		ProfileScope profile(gProfiler, "swap and events");
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+}
+
+void cleanup(void) {
+	gSimulation.stop();
+	if (gRecorder.isOpen()) {
+		printf("recorded %llu ticks, %llu bytes (%.2f bytes/tick)\n", gRecorder.getTicks(), gRecorder.getBytes(),
+			gRecorder.getTicks() > 0 ? (double)(gRecorder.getBytes() - sizeof(SimLogHeader)) / gRecorder.getTicks() : 0.0);
+		if (!gRecorder.close())
+			fprintf(stderr, "Could not write the whole session log; it ends early\n");
+	}
+	if (gReplay.isOpen() && !gReplayDone) {
+		printf("replay stopped after %llu ticks, %llu diverged from the log (max deviation %g)\n",
+			gReplay.getTicks(), gReplayDiverged, gReplayMaxDeviation);
+	}
+	gReplay.close();
+	gAssetLoader.stop();
+
+	// Cleanup VBO and shader
+	for (int i = 0; i < NumObjects; i++) {
+		glDeleteBuffers(1, &VertexBufferId[i]);
+		glDeleteBuffers(1, &IndexBufferId[i]);
+		glDeleteVertexArrays(1, &VertexArrayId[i]);
+	}
+	gGPUBufferBytes = 0;
+	glDeleteProgram(programID);
+	glDeleteProgram(pickingProgramID);
+	gAsyncPicker.cleanup();
+	gUniformRing.cleanup();
+	glDeleteBuffers(1, &LightClustersBufferId);
+	glDeleteBuffers(1, &LightIndicesBufferId);
+	glDeleteTextures(1, &LightClustersTextureId);
+	glDeleteTextures(1, &LightIndicesTextureId);
+	gPartArena.cleanup();
+	glDeleteVertexArrays(1, &PartVertexArrayId);
+	glDeleteBuffers(1, &DrawDataBufferId);
+	glDeleteBuffers(1, &IndirectBufferId);
+	gProfiler.cleanup();
+
+	if (gHeadless) {
+		deleteOffscreenTarget(gOffscreen);
+		cleanupHeadlessContext();
+		return;
+	}
+
+	// Close OpenGL window and terminate GLFW
+	glfwTerminate();
+}
+
+void setActive(int activeIndex) {
+	if (IsObjectActive[activeIndex]) {
+		IsObjectActive[activeIndex] = false;
+	}
+	else {
+		for (int i = 0; i < NumObjects; i++) {
+			IsObjectActive[i] = (i == activeIndex ? true : false);
+		}
+	}
+}
+
+// Alternative way of triggering functions on keyboard events
+static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+	// ATTN: MODIFY AS APPROPRIATE
+	if (action == GLFW_PRESS) {
+		switch (key) {
+			case GLFW_KEY_A:
+				break;
+			case GLFW_KEY_D:
+				break;
+			case GLFW_KEY_W:
+				break;
+			case GLFW_KEY_S:
+				break;
+			case GLFW_KEY_SPACE:
+				break;
+			// Task 2: Camera rotations
+			case GLFW_KEY_C: {
+				//CameraSelected = !CameraSelected;
+				//std::cout << "CameraSelected bool: " << CameraSelected << std::endl;
+				setActive(0);
+				break;
+			}
+			// Task 4: transformations
+			case GLFW_KEY_B: {
+				//BaseSelected = !BaseSelected;
+				//std::cout << "BaseSelected bool: " << BaseSelected << std::endl;
+				setActive(baseIndexStandardColor);
+				break;
+			}
+			case GLFW_KEY_T: {
+				//TopSelected = !TopSelected;
+				//std::cout << "TopSelected bool: " << TopSelected << std::endl;
+				setActive(topIndexStandardColor);
+				break;
+			}
+			case GLFW_KEY_1: {
+				//Arm1Selected = !Arm1Selected;
+				//std::cout << "Arm1Selected bool: " << Arm1Selected << std::endl;
+				setActive(arm1IndexStandardColor);
+				break;
+			}
+			case GLFW_KEY_2: {
+				//Arm2Selected = !Arm2Selected;
+				//std::cout << "Arm2Selected bool: " << Arm2Selected << std::endl;
+				setActive(arm2IndexStandardColor);
+				break;
+			}
+			case GLFW_KEY_P: {
+				//PenSelected = !PenSelected;
+				//std::cout << "PenSelected bool: " << PenSelected << std::endl;
+				setActive(penIndexStandardColor);
+				break;
+			}
+			case GLFW_KEY_LEFT_SHIFT: {
+				ShiftPressed = !ShiftPressed;
+				//std::cout << "ShiftPressed bool: " << ShiftPressed << std::endl;
+			}
+			default:
+				break;
+		}
+	}
+}
+
+// Alternative way of triggering functions on mouse click events
+static void mouseCallback(GLFWwindow* window, int button, int action, int mods) {
+	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+		MousePressed = true;
+		if (gPickingMode == PICK_CPU) {
+			pickObjectCPU();
+		}
+		else if (gPickingMode == PICK_GPU_ASYNC) {
+			// Rendered at the start of the next frame, with that frame's matrices
+			glfwGetCursorPos(window, &gPickCursorX, &gPickCursorY);
+			gPickRequested = true;
+		}
+		else {
+			pickObject();
+		}
+	}
+	else {
+		MousePressed = false;
+	}
+}
+
+// Renders numFrames frames offscreen and reports the frame times.
+// Every captureEvery-th frame is written to <capturePrefix>_NNNN.ppm when a prefix is given,
+// and the profiled frames to tracePath as a Chrome trace.
+int runHeadless(int numFrames, const char* capturePrefix, int captureEvery, const char* timingsPath, const char* tracePath,
+	const char* recordPath) {
+	gHeadless = true;
+	int errorCode = initHeadlessContext(window_width, window_height);
+	if (errorCode != 0)
+		return errorCode;
+	if (!createOffscreenTarget(gOffscreen, window_width, window_height))
+		return -1;
+
+	double initStart = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	initOpenGL();
+	glFinish();
+	double initEnd = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	printf("initOpenGL: %.3f ms\n", 1000.0 * (initEnd - initStart));
+	if (!startSession(recordPath))
+		return -1;
+	// Frames are only timed and captured once every part is there
+	uploadLoadedObjects(true);
+	glFinish();
+	double loadEnd = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	printf("models loaded: %.3f ms, GPU buffers: %u bytes\n", 1000.0 * (loadEnd - initStart), gGPUBufferBytes);
+
+	FrameTimings timings;
+	unsigned long long glCalls = 0;
+	unsigned long long objectsDrawn = 0, objectsCulled = 0, trianglesDrawn = 0;
+	if (tracePath != NULL)
+		gProfiler.startTrace();
+	for (int frame = 0; frame < numFrames; frame++) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		gProfiler.beginFrame();
+		renderScene();
+		glCalls += gGLCallsPerFrame;
+		objectsDrawn += gObjectsDrawn;
+		objectsCulled += gObjectsCulled;
+		trianglesDrawn += gTrianglesDrawn;
+		// Wait for the frame to finish so the timing covers the GPU (or llvmpipe) work too
+		glFinish();
+		gProfiler.endFrame();
+		timings.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		if (capturePrefix != NULL && frame % captureEvery == 0) {
+			char path[512];
+			snprintf(path, sizeof(path), "%s_%04d.ppm", capturePrefix, frame);
+			writeFramePPM(path, window_width, window_height);
+		}
+		// A replay ends the run with the log
+		if (gReplayDone) {
+			numFrames = frame + 1;
+		}
+	}
+
+	timings.print("headless");
+	printf("GL calls per frame: %.1f\n", (double)glCalls / numFrames);
+	printf("lights: %u, at most %u in one cluster\n", gLightCount, gMaxLightsPerCluster);
+	printf("objects per frame: %.1f drawn, %.1f culled\n", (double)objectsDrawn / numFrames, (double)objectsCulled / numFrames);
+	printf("arm part triangles per frame: %.1f\n", (double)trianglesDrawn / numFrames);
+	gProfiler.printSummary();
+	if (timingsPath != NULL)
+		timings.writeCSV(timingsPath);
+	if (tracePath != NULL)
+		gProfiler.writeTrace(tracePath);
+
+	cleanup();
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	// Command line: [--arms <n>] [--lights <n>] [--sim-rate <hz>] [--trace <file.json>] [--record <file>] [--replay <file>] --headless <frames> [--sim-ticks <n>] [--capture <prefix>] [--capture-every <n>] [--timings <file.csv>]
+	int headlessFrames = 0;
+	const char* capturePrefix = NULL;
+	int captureEvery = 1;
+	const char* timingsPath = NULL;
+	const char* tracePath = NULL;
+	const char* recordPath = NULL;
+	const char* replayPath = NULL;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--headless" && i + 1 < argc)
+			headlessFrames = atoi(argv[++i]);
+		else if (arg == "--capture" && i + 1 < argc)
+			capturePrefix = argv[++i];
+		else if (arg == "--capture-every" && i + 1 < argc)
+			captureEvery = std::max(1, atoi(argv[++i]));
+		else if (arg == "--timings" && i + 1 < argc)
+			timingsPath = argv[++i];
+		else if (arg == "--arms" && i + 1 < argc)
+			gArmCount = std::max(1, atoi(argv[++i]));
+		else if (arg == "--lights" && i + 1 < argc)
+			gWorkLightCount = std::max(0, atoi(argv[++i]));
+		else if (arg == "--trace" && i + 1 < argc)
+			tracePath = argv[++i];
+		else if (arg == "--sim-ticks" && i + 1 < argc)
+			gHeadlessTicksPerFrame = std::max(0, atoi(argv[++i]));
+		else if (arg == "--sim-rate" && i + 1 < argc)
+			gSimRate = std::max(0.0, atof(argv[++i]));
+		else if (arg == "--record" && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (arg == "--replay" && i + 1 < argc)
+			replayPath = argv[++i];
+	}
+	if (replayPath != NULL && !gReplay.open(replayPath)) {
+		fprintf(stderr, "Could not read the log %s\n", replayPath);
+		return -1;
+	}
+	if (headlessFrames > 0)
+		return runHeadless(headlessFrames, capturePrefix, captureEvery, timingsPath, tracePath, recordPath);
+
+	// TL
+	// ATTN: Refer to https://learnopengl.com/Getting-started/Transformations, https://learnopengl.com/Getting-started/Coordinate-Systems,
+	// and https://learnopengl.com/Getting-started/Camera to familiarize yourself with implementing the camera movement
+
+	// ATTN (Project 3 only): Refer to https://learnopengl.com/Getting-started/Textures to familiarize yourself with mapping a texture
+	// to a given mesh
+
+	// Initialize window
+	int errorCode = initWindow();
+	if (errorCode != 0)
+		return errorCode;
+
+	// Initialize OpenGL pipeline
+	initOpenGL();
+	if (!startSession(recordPath))
+		return -1;
+	unsigned long long lastSimTicks = 0;
+	if (tracePath != NULL)
+		gProfiler.startTrace();
+
+	// For speed computation
+	double lastTime = glfwGetTime();
+	int nbFrames = 0;
+	do {
+		// Measure speed
+		double currentTime = glfwGetTime();
+		nbFrames++;
+		if (currentTime - lastTime >= 1.0){ // If last prinf() was more than 1sec ago
+			gFrameMsP50 = (float)gProfiler.percentile("frame", false, 50.0);
+			gFrameMsP95 = (float)gProfiler.percentile("frame", false, 95.0);
+			gFrameMsP99 = (float)gProfiler.percentile("frame", false, 99.0);
+			gSceneGpuMs = (float)gProfiler.percentile("scene", true, 50.0);
+			gSimHz = (float)(gSimulation.getTicks() - lastSimTicks);
+			lastSimTicks = gSimulation.getTicks();
+			printf("%f ms/frame (p50 %.2f, p95 %.2f, p99 %.2f)\n", 1000.0 / double(nbFrames), gFrameMsP50, gFrameMsP95, gFrameMsP99);
+			nbFrames = 0;
+			lastTime += 1.0;
+		}
+
+
+		// DRAWING POINTS
+		gProfiler.beginFrame();
+		renderScene();
+		gProfiler.endFrame();
+
+	} // Check if the ESC key was pressed or the window was closed
+	while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS &&
+	glfwWindowShouldClose(window) == 0);
+
+	gProfiler.printSummary();
+	if (tracePath != NULL)
+		gProfiler.writeTrace(tracePath);
+	cleanup();
+
+	return 0;
 }
\ No newline at end of file